@@ -1,12 +1,19 @@
 #pragma once
+#include <atomic>
+#include <chrono>
 #include <string>
 #include <vector>
 #include <future>
+#include <functional>
+#include <memory>
 #include <nlohmann/json.hpp>
+#include "HttpTransport.h"
+#include "RateLimiter.h"
+#include "ResponseCache.h"
 
 class AIService {
 public:
-    AIService(const std::string& api_key, const std::string& base_url = "");
+    explicit AIService(const std::string& api_key, const std::string& base_url = "");
     virtual ~AIService() = default;
 
     struct AIResponse {
@@ -15,15 +22,121 @@ public:
         std::string error_message;
     };
 
+    // Throttled (429), overloaded (5xx) and timed-out requests are retried up to
+    // max_attempts times in all, after a random delay between half and all of
+    // base_delay * 2^retry, capped at max_delay, or after the provider's Retry-After
+    // if that is longer
+    struct RetryOptions {
+        int max_attempts = 4;
+        std::chrono::milliseconds base_delay{500};
+        std::chrono::milliseconds max_delay{30000};
+        std::chrono::milliseconds connect_timeout{10000};
+        std::chrono::milliseconds request_timeout{120000};
+    };
+
+    struct RequestStats {
+        size_t requests;
+        size_t retries;
+        size_t throttled;
+        size_t server_errors;
+        size_t timeouts;
+        size_t failures;
+    };
+
+    // Whether submitWithRetry would try the request again after this response
+    static bool isRetryable(const HttpTransport::Response& response);
+    // Wait before retry number `retry` (0 for the first), per the rules above
+    static std::chrono::milliseconds backoffDelay(const RetryOptions& options, int retry);
+
+    using ResponseCallback = std::function<void(AIResponse)>;
+    using DeltaCallback = std::function<void(const std::string& delta)>;
+    using CancelFlag = HttpTransport::CancelFlag;
+
     virtual std::future<AIResponse> generateResponse(const std::string& prompt) = 0;
+    // Completes on the transport's I/O thread; the callback must not block. Passing
+    // `cancel` to cancel() abandons the request, which then completes unsuccessfully.
+    virtual void generateResponse(const std::string& prompt, ResponseCallback on_complete,
+                                  CancelFlag cancel = nullptr) = 0;
     virtual std::future<AIResponse> analyzePreferences(const std::string& user_data) = 0;
     virtual std::future<AIResponse> recommendEvents(
         const std::string& preferences, 
         const std::string& available_events) = 0;
 
+    // Delivers generated text to on_delta as it is produced, then the full text to on_complete.
+    // Both callbacks run on the transport's I/O thread.
+    virtual void streamResponse(const std::string& prompt, DeltaCallback on_delta,
+                                ResponseCallback on_complete) = 0;
+    void streamRecommendEvents(const std::string& preferences, const std::string& available_events,
+                               DeltaCallback on_delta, ResponseCallback on_complete);
+    static std::string buildRecommendationPrompt(const std::string& preferences,
+                                                 const std::string& available_events);
+
+    virtual std::string getProviderName() const = 0;
+    virtual std::string getModelName() const = 0;
+
+    // Requests use the transport's connection pool
+    void setTransport(std::shared_ptr<HttpTransport> transport);
+    virtual void cancel(const CancelFlag& flag) { transport_->cancel(flag); }
+    
+    // Adapts a callback-style call to a future completed with its response
+    static std::future<AIResponse> toFuture(const std::function<void(ResponseCallback)>& start);
+    
+    // Requests wait here for budget before every attempt, retries included. Share one
+    // limiter between services that draw on the same provider account.
+    void setRateLimiter(std::shared_ptr<RateLimiter> rate_limiter);
+    std::shared_ptr<RateLimiter> getRateLimiter() const { return rate_limiter_; }
+    void setRetryOptions(const RetryOptions& retry_options) { retry_options_ = retry_options; }
+    const RetryOptions& getRetryOptions() const { return retry_options_; }
+    RequestStats getRequestStats() const;
+    
+    void setResponseCache(std::shared_ptr<ResponseCache> response_cache) { response_cache_ = response_cache; }
+    std::shared_ptr<ResponseCache> getResponseCache() const { return response_cache_; }
+    void setOfflineMode(bool offline_mode) { offline_mode_ = offline_mode; }
+    bool isOfflineMode() const { return offline_mode_; }
+
 protected:
     std::string api_key_;
     std::string base_url_;
+    std::shared_ptr<HttpTransport> transport_;
+    std::shared_ptr<ResponseCache> response_cache_;
+    std::shared_ptr<RateLimiter> rate_limiter_;
+    RetryOptions retry_options_;
+    bool offline_mode_;
     
     AIResponse makeRequest(const std::string& endpoint, const nlohmann::json& payload);
+    void makeRequestAsync(const std::string& endpoint, const nlohmann::json& payload,
+                          ResponseCallback on_complete, CancelFlag cancel = nullptr);
+    
+    using StreamEventCallback = std::function<void(const std::string& event, const std::string& data)>;
+    // on_complete reports only transport/HTTP status; the provider assembles the content
+    void makeStreamingRequestAsync(const std::string& endpoint, const nlohmann::json& payload,
+                                   StreamEventCallback on_event, ResponseCallback on_complete);
+
+    // Answers from the response cache (or fails in offline mode); returns false if a request is needed
+    bool respondFromCache(const std::string& prompt, const ResponseCallback& on_complete);
+    ResponseCallback storeInCache(const std::string& prompt, ResponseCallback on_complete);
+
+private:
+    struct Counters {
+        std::atomic<size_t> requests{0};
+        std::atomic<size_t> retries{0};
+        std::atomic<size_t> throttled{0};
+        std::atomic<size_t> server_errors{0};
+        std::atomic<size_t> timeouts{0};
+        std::atomic<size_t> failures{0};
+    };
+    
+    // Shared with in-flight requests, which may finish after the service is gone
+    std::shared_ptr<Counters> counters_;
+    
+    // Sends request through the rate limiter and retries it per retry_options_.
+    // can_retry, if set, may veto a retry (e.g. once a stream has delivered data).
+    void submitWithRetry(HttpTransport::Request request, size_t tokens,
+                         HttpTransport::CompletionCallback on_complete,
+                         std::function<bool()> can_retry = nullptr);
+    static size_t estimateRequestTokens(const std::string& body, const nlohmann::json& payload);
+    
+    std::vector<std::string> buildHeaders() const;
+    static AIResponse checkResponse(bool transfer_ok, long status_code,
+                                    std::string body, const std::string& transfer_error);
 };
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+#include "EventStore.h"
+#include "Preferences.h"
+#include "TimeZone.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Scores tiles of EventStore rows against a precompiled preference profile.
+// Produces exactly the values RecommendationEngine::calculateEventScore would.
+// The gain over calling it per event is in the setup: the hour scores are
+// tabulated once per profile, start times are converted once per tile, and
+// the time zone offset comes from a cursor rather than a search per event.
+class BatchScorer {
+public:
+    struct Profile {
+        const Preferences* preferences;
+        const TimeZone* time_zone;
+        std::array<double, HourOfWeekMask::HOURS_PER_WEEK> hour_scores;
+        bool has_location;
+        bool has_coordinates;
+        double max_hour_score;
+    };
+
+    // The profile keeps a pointer to preferences, which must outlive it
+    static Profile compile(const Preferences& preferences);
+
+    // User-independent columns for up to TILE_SIZE rows, so one tile can be
+    // scored against many profiles without re-deriving them
+    static constexpr size_t TILE_SIZE = 256;
+    struct Tile {
+        const EventStore* store;
+        size_t count;
+        EventStore::EventId ids[TILE_SIZE];
+        std::int64_t start_seconds[TILE_SIZE];
+        bool located[TILE_SIZE];
+    };
+
+    // Consecutive rows starting at first, or an explicit list of rows
+    static void loadTile(const EventStore& store, EventStore::EventId first, size_t count, Tile& tile);
+    static void loadTile(const EventStore& store, const EventStore::EventId* ids, size_t count, Tile& tile);
+
+    // If in_range is given, it is set to false for events with coordinates beyond the
+    // user's travel distance (their score is still written)
+    static void scoreTile(const Tile& tile, const Profile& profile, double* out, bool* in_range = nullptr);
+
+    // Unblended inputs to the score, for callers that cache them and re-blend after one
+    // component changes; blend() rounds exactly like scoreTile
+    struct Components {
+        double interest;
+        double time;
+        double location;
+        bool in_range;
+    };
+    static void loadComponents(const Tile& tile, const Profile& profile, Components* out);
+    static double scoreInterest(const EventStore& store, EventStore::EventId id, const Profile& profile);
+    static double blend(const Components& components) {
+        return (components.interest * 0.5) + (components.time * 0.3) + (components.location * 0.2);
+    }
+
+    // Writes scores for rows [first, first + count) to out
+    static void scoreBlock(const EventStore& store, EventStore::EventId first, size_t count,
+                           const Profile& profile, double* out);
+
+    // Highest score any event with the given interest score could reach under this
+    // profile; rounds exactly like scoreTile, so it is safe for pruning
+    static double getUpperBound(const Profile& profile, double interest_score) {
+        return (interest_score * 0.5) + (profile.max_hour_score * 0.3) + (1.0 * 0.2);
+    }
+
+private:
+    static void gatherRow(const Tile& tile, size_t i, const Profile& profile, TimeZone::Cursor& time_zone,
+                          double& interest, int& hour, double& location, bool& in_range);
+};
\ No newline at end of file
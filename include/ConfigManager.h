@@ -1,4 +1,7 @@
 #pragma once
+#include <chrono>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <nlohmann/json.hpp>
@@ -43,6 +46,14 @@ struct AIServiceConfig {
     std::string model;
     int max_tokens;
     double temperature;
+    // Client-side limits matching the account's quota; 0 = unlimited
+    int requests_per_minute;
+    int tokens_per_minute;
+};
+
+struct ConnectionPoolSettings {
+    int max_connections;
+    int idle_timeout_seconds;
 };
 
 struct UserConfig {
@@ -58,6 +69,7 @@ struct UserConfig {
     std::string default_ai_provider;
     AIServiceConfig openai_config;
     AIServiceConfig claude_config;
+    ConnectionPoolSettings connection_pool;
     
     // Preferences
     std::map<std::string, int> interests;
@@ -88,6 +100,8 @@ struct UserConfig {
     int sync_interval_minutes;
     bool offline_mode;
     int cache_size_mb;
+    int cache_ttl_hours;
+    std::string cache_directory;  // Relative to the config file's directory
     std::string log_level;
     
     // Advanced Settings
@@ -99,18 +113,65 @@ struct UserConfig {
     double recency_bias;
     int max_recommendations_per_day;
     double min_recommendation_score;
+    int prompt_token_budget;
+    int scoring_threads;  // 0 = one per hardware thread
 };
 
+// nlohmann::json conversions, found by ADL. from_json reads each subtree in place
+// and throws std::runtime_error naming the JSON path of any missing or mistyped
+// key; keys that have defaults may be omitted.
+void to_json(nlohmann::json& j, const UserLocation& location);
+void from_json(const nlohmann::json& j, UserLocation& location);
+void to_json(nlohmann::json& j, const TimeSlot& slot);
+void from_json(const nlohmann::json& j, TimeSlot& slot);
+void to_json(nlohmann::json& j, const BudgetLimits& budget);
+void from_json(const nlohmann::json& j, BudgetLimits& budget);
+void to_json(nlohmann::json& j, const NotificationSettings& settings);
+void from_json(const nlohmann::json& j, NotificationSettings& settings);
+void to_json(nlohmann::json& j, const AIServiceConfig& service);
+void from_json(const nlohmann::json& j, AIServiceConfig& service);
+void to_json(nlohmann::json& j, const ConnectionPoolSettings& pool);
+void from_json(const nlohmann::json& j, ConnectionPoolSettings& pool);
+void to_json(nlohmann::json& j, const UserConfig& config);
+void from_json(const nlohmann::json& j, UserConfig& config);
+
 class ConfigManager {
 public:
+    struct ReloadStats {
+        size_t reloads;
+        size_t failures;
+        std::chrono::microseconds last_latency;
+        std::vector<std::string> last_errors;
+    };
+
     ConfigManager(const std::string& config_file_path = "config/user_config.json");
     
     bool loadConfig();
     bool saveConfig() const;
     bool createDefaultConfig() const;
     
-    UserConfig& getConfig() { return config_; }
-    const UserConfig& getConfig() const { return config_; }
+    // Copy of the working config, taken under the lock a reload from another thread
+    // replaces it under. Edit through the setters; getSnapshot() avoids the copy.
+    UserConfig getConfig() const;
+    
+    // Immutable copy that any thread may read; replaced wholesale by loadConfig,
+    // reloadConfig and publishConfig, so a held snapshot never changes. This uses the
+    // C++17 std::atomic_load/atomic_store overloads for shared_ptr, which libstdc++
+    // implements with a small pool of mutexes keyed by address: readers take a short
+    // lock for the reference count bump but never wait on a reload's parsing.
+    std::shared_ptr<const UserConfig> getSnapshot() const { return std::atomic_load(&snapshot_); }
+    // Makes edits made through the setters visible to snapshot readers
+    void publishConfig();
+    
+    // Re-reads and validates the file; if it is valid, replaces the working copy and
+    // publishes it as the new snapshot under one lock. Safe to call from any thread.
+    bool reloadConfig();
+    ReloadStats getReloadStats() const;
+    
+    const std::string& getConfigFilePath() const { return config_file_path_; }
+    // Paths in the config are relative to the config file's directory, not the working
+    // directory; absolute paths are returned unchanged
+    std::string resolvePath(const std::string& path) const;
     
     // Convenience methods for common operations
     void setUserProfile(const std::string& name, const std::string& email, const std::string& phone);
@@ -123,6 +184,7 @@ public:
     // Validation methods
     bool validateConfig() const;
     std::vector<std::string> getValidationErrors() const;
+    static std::vector<std::string> getValidationErrors(const UserConfig& config);
     
     // JSON conversion helpers
     static UserConfig fromJson(const nlohmann::json& j);
@@ -131,7 +193,12 @@ public:
 private:
     std::string config_file_path_;
     UserConfig config_;
+    std::shared_ptr<const UserConfig> snapshot_;
+    // Held while config_ and snapshot_ change together, and for reload_stats_
+    mutable std::mutex config_mutex_;
+    ReloadStats reload_stats_;
     
     void setDefaults();
+    bool readConfigFile(UserConfig& config, std::vector<std::string>& errors) const;
     bool fileExists(const std::string& path) const;
 };
\ No newline at end of file
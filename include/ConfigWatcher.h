@@ -0,0 +1,40 @@
+#pragma once
+#include "ConfigManager.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+// Watches the config file with inotify and calls ConfigManager::reloadConfig on a
+// background thread after it changes. The directory is watched rather than the
+// file, so editors that save by writing a new file and renaming it over the old
+// one are picked up. Bursts of events are coalesced into one reload.
+class ConfigWatcher {
+public:
+    // Called on the watcher thread after each reload attempt; details are in
+    // ConfigManager::getReloadStats()
+    using ReloadCallback = std::function<void(bool success)>;
+
+    // The manager must outlive the watcher
+    explicit ConfigWatcher(ConfigManager& config_manager, ReloadCallback on_reload = nullptr);
+    ~ConfigWatcher();
+    ConfigWatcher(const ConfigWatcher&) = delete;
+    ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+    // Returns false if the watch could not be set up
+    bool start();
+    void stop();
+    bool isRunning() const { return running_; }
+
+private:
+    static constexpr std::chrono::milliseconds SETTLE_DELAY{50};
+
+    ConfigManager& config_manager_;
+    ReloadCallback on_reload_;
+    int inotify_fd_;
+    int wake_fd_;
+    std::thread thread_;
+    std::atomic<bool> running_;
+
+    void run(std::string file_name);
+};
\ No newline at end of file
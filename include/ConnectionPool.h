@@ -0,0 +1,86 @@
+#pragma once
+#include <curl/curl.h>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Thread-safe cache of CURL easy handles. Handles are reset rather than
+// destroyed between requests, so each keeps its live keep-alive connections,
+// and all of them share one DNS, TLS-session and cookie cache.
+class ConnectionPool {
+public:
+    struct Options {
+        size_t max_size = 8;
+        std::chrono::seconds idle_timeout{60};
+    };
+
+    struct Stats {
+        size_t max_size;
+        long idle_timeout_seconds;
+        size_t idle;
+        size_t in_use;
+        size_t created;
+        size_t reused;
+        size_t evicted;
+    };
+
+    // Returns its handle to the pool when destroyed.
+    class Lease {
+    public:
+        Lease(ConnectionPool* pool, CURL* handle) : pool_(pool), handle_(handle) {}
+        Lease(Lease&& other) noexcept : pool_(other.pool_), handle_(other.handle_) { other.handle_ = nullptr; }
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease() { if (handle_) pool_->release(handle_); }
+
+        CURL* get() const { return handle_; }
+        explicit operator bool() const { return handle_ != nullptr; }
+
+    private:
+        ConnectionPool* pool_;
+        CURL* handle_;
+    };
+
+    ConnectionPool();
+    explicit ConnectionPool(const Options& options);
+    ~ConnectionPool();
+
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+    Lease acquire();
+    CURL* acquireHandle();
+    void release(CURL* handle);
+
+    const Options& getOptions() const { return options_; }
+    Stats getStats() const;
+
+    // Process-wide pool used by transports that were not given one explicitly.
+    static std::shared_ptr<ConnectionPool> getShared();
+    static void setShared(std::shared_ptr<ConnectionPool> pool);
+
+private:
+    struct IdleHandle {
+        CURL* handle;
+        std::chrono::steady_clock::time_point released_at;
+    };
+
+    Options options_;
+    CURLSH* share_;
+    std::mutex share_mutexes_[CURL_LOCK_DATA_LAST];
+
+    mutable std::mutex mutex_;
+    std::vector<IdleHandle> idle_;
+    size_t in_use_;
+    size_t created_;
+    size_t reused_;
+    size_t evicted_;
+
+    CURL* createHandle();
+    void prepareHandle(CURL* handle);
+    void evictExpiredLocked(std::chrono::steady_clock::time_point now, std::vector<CURL*>& expired);
+
+    static void lockShare(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr);
+    static void unlockShare(CURL* handle, curl_lock_data data, void* userptr);
+};
\ No newline at end of file
@@ -0,0 +1,126 @@
+#pragma once
+#include "Event.h"
+#include "GeoPoint.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Read-only event catalog backed by a memory-mapped binary file, so opening
+// even a very large catalog costs one mmap plus a validation pass and no
+// per-event allocation. All integers are little-endian; sections start on
+// 8-byte boundaries:
+//
+//   header   magic "MBEVCAT\0", u32 version, u32 record size, u64 event count,
+//            u64 tag count, u64 tag reference count, then u64 offsets of the
+//            records, tag table, tag references and string pool, u64 pool size
+//   records  fixed width: u64 id, i64 start, i64 end (unix seconds), f64
+//            latitude, f64 longitude, u32 offset/length pairs into the pool for
+//            name, description and location, u32 first tag reference, u16 tag
+//            count, u16 flags (bit 0: has coordinates)
+//   tags     u32 offset/length pairs into the pool, one per distinct tag
+//   tag refs u32 tag table indices, each record owning a contiguous run
+//   strings  UTF-8 bytes, no terminators; equal strings are stored once
+class EventCatalog {
+public:
+    static const std::uint32_t VERSION = 1;
+
+    // Zero-copy view of one record; the string views point into the mapping
+    // and stay valid as long as the catalog does
+    struct EventView {
+        Event::Id id;
+        std::chrono::system_clock::time_point start_time;
+        std::chrono::system_clock::time_point end_time;
+        std::string_view name;
+        std::string_view description;
+        std::string_view location;
+        bool has_coordinates;
+        GeoPoint coordinates;
+        std::uint32_t first_tag;
+        std::uint32_t tag_count;
+    };
+
+    // Accumulates events in memory and writes them out as one catalog file
+    class Writer {
+    public:
+        // Times are unix seconds
+        void add(Event::Id id, std::string_view name, std::string_view description,
+                 std::int64_t start_seconds, std::int64_t end_seconds,
+                 std::string_view location, const std::vector<std::string_view>& tags,
+                 const GeoPoint* coordinates = nullptr);
+        void add(const Event& event);
+
+        size_t size() const { return records_.size(); }
+
+        // Writes via a temporary file and rename, so readers never see a partial catalog
+        bool write(const std::string& path, std::string& error) const;
+
+    private:
+        struct Record {
+            Event::Id id;
+            std::int64_t start_seconds;
+            std::int64_t end_seconds;
+            GeoPoint coordinates;
+            std::uint32_t name[2];
+            std::uint32_t description[2];
+            std::uint32_t location[2];
+            std::uint32_t first_tag;
+            std::uint16_t tag_count;
+            std::uint16_t flags;
+        };
+
+        std::vector<Record> records_;
+        std::vector<std::uint32_t> tag_table_;
+        std::vector<std::uint32_t> tag_refs_;
+        std::string strings_;
+        std::unordered_map<std::string, std::uint32_t> string_offsets_;
+        std::unordered_map<std::string, std::uint32_t> tag_indexes_;
+
+        std::uint32_t addString(std::string_view text);
+    };
+
+    ~EventCatalog();
+    EventCatalog(const EventCatalog&) = delete;
+    EventCatalog& operator=(const EventCatalog&) = delete;
+
+    // Maps and validates the file. Returns nullptr and sets error on failure.
+    static std::shared_ptr<const EventCatalog> open(const std::string& path, std::string& error);
+
+    // Streams a JSON event feed (see EventFeedReader for the format) into a binary catalog
+    static bool convertJson(const std::string& json_path, const std::string& catalog_path, std::string& error);
+
+    size_t size() const { return event_count_; }
+    bool empty() const { return event_count_ == 0; }
+    EventView getEvent(size_t index) const;
+
+    // Distinct tags, indexed by the values returned from getTagIndex
+    size_t getTagCount() const { return tag_count_; }
+    std::string_view getTag(std::uint32_t tag_index) const;
+    std::uint32_t getTagIndex(const EventView& event, size_t i) const;
+    // Total tags over all events
+    size_t getTagReferenceCount() const { return tag_ref_count_; }
+
+    // Copies one record into a standalone Event (keeping its id)
+    Event toEvent(size_t index) const;
+
+private:
+    const unsigned char* data_;
+    size_t size_;
+    size_t event_count_;
+    size_t tag_count_;
+    size_t tag_ref_count_;
+    size_t strings_size_;
+    const unsigned char* records_;
+    const unsigned char* tags_;
+    const unsigned char* tag_refs_;
+    const unsigned char* strings_;
+
+    EventCatalog();
+
+    bool validate(std::string& error);
+    std::string_view getString(const unsigned char* pair) const;
+};
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+#include "Event.h"
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <istream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Streams events out of a JSON feed ({"events": [...]} or a bare array) with
+// nlohmann's SAX parser, so only the event being parsed is ever held in memory.
+// Each event has "name", "start" and "end" (unix seconds or ISO 8601, e.g.
+// "2024-05-01T19:00:00Z" or with a +hh:mm offset) and may have "id" (defaults
+// to its 1-based position in the feed), "description", "location", "tags",
+// "latitude" and "longitude". Unknown fields are skipped.
+//
+// Used directly, read() pushes events into a sink on the calling thread. An
+// instance instead parses on a background thread into a bounded queue and hands
+// events out through next(), which fits RecommendationEngine::EventSource, so
+// parsing overlaps with whatever consumes the events.
+class EventFeedReader {
+public:
+    // Return false to stop reading early (not an error)
+    using Sink = std::function<bool(const Event& event)>;
+
+    static bool read(std::istream& input, const Sink& sink, std::string& error);
+    static bool readFile(const std::string& path, const Sink& sink, std::string& error);
+
+    // Starts parsing path; at most queue_capacity parsed events wait in memory
+    explicit EventFeedReader(const std::string& path, size_t queue_capacity = 4096);
+    ~EventFeedReader();
+    EventFeedReader(const EventFeedReader&) = delete;
+    EventFeedReader& operator=(const EventFeedReader&) = delete;
+
+    // Next event, or nullptr once the feed is exhausted or failed. The pointee stays
+    // valid until the following call.
+    const Event* next();
+
+    // Only meaningful after next() has returned nullptr
+    bool failed() const;
+    std::string getError() const;
+
+private:
+    static const size_t BATCH_SIZE = 64;
+
+    std::thread parser_;
+    mutable std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+    std::deque<std::vector<Event>> batches_;
+    size_t max_batches_;
+    bool done_;
+    bool cancelled_;
+    bool failed_;
+    std::string error_;
+
+    // Consumer side only
+    std::vector<Event> current_;
+    size_t current_index_;
+
+    void parse(const std::string& path);
+    bool push(std::vector<Event>& batch);
+};
\ No newline at end of file
@@ -0,0 +1,112 @@
+#pragma once
+#include "Event.h"
+#include "GeoIndex.h"
+#include "TagInterner.h"
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Column-oriented event catalog. Hot scoring fields (times, location ids and
+// interned tags in CSR form) live in contiguous arrays indexed by EventId;
+// names and descriptions are kept in separate cold columns, as views into
+// either the store's own strings or a catalog mapping it holds open. Removed events
+// keep their row (ids stay stable) but are marked inactive and dropped from
+// the tag and spatial indexes.
+class EventCatalog;
+
+class EventStore {
+public:
+    using EventId = std::uint32_t;
+    using LocationId = std::uint32_t;
+    static const LocationId NO_LOCATION = 0;
+
+    explicit EventStore(TagInterner& tag_interner = TagInterner::global());
+    // Name and description views would point into the source's strings
+    EventStore(const EventStore&) = delete;
+    EventStore& operator=(const EventStore&) = delete;
+
+    EventId addEvent(const Event& event);
+    // Appends every catalog record without building intermediate Event objects. Names
+    // and descriptions are not copied; the store keeps the catalog open instead.
+    void addEvents(std::shared_ptr<const EventCatalog> catalog);
+    // Returns false if the id is unknown or already removed
+    bool removeEvent(EventId id);
+    void reserve(size_t event_count, size_t tag_count);
+
+    size_t size() const { return start_times_.size(); }
+    bool empty() const { return start_times_.empty(); }
+    bool isActive(EventId id) const { return active_[id] != 0; }
+    size_t getActiveCount() const { return active_count_; }
+
+    const std::vector<std::chrono::system_clock::time_point>& getStartTimes() const { return start_times_; }
+    const std::vector<std::chrono::system_clock::time_point>& getEndTimes() const { return end_times_; }
+    const std::vector<LocationId>& getLocationIds() const { return location_ids_; }
+    const std::vector<std::uint32_t>& getTagOffsets() const { return tag_offsets_; }
+    const std::vector<TagInterner::TagId>& getTagIds() const { return tag_ids_; }
+    const std::vector<GeoPoint>& getCoordinates() const { return coordinates_; }
+    const std::vector<std::uint8_t>& getHasCoordinates() const { return has_coordinates_; }
+
+    std::string_view getName(EventId id) const { return names_[id]; }
+    std::string_view getDescription(EventId id) const { return descriptions_[id]; }
+    const std::string& getLocation(EventId id) const { return locations_[location_ids_[id]]; }
+    Event::Id getSourceId(EventId id) const { return source_ids_[id]; }
+
+    const TagInterner::TagId* tagsBegin(EventId id) const { return tag_ids_.data() + tag_offsets_[id]; }
+    const TagInterner::TagId* tagsEnd(EventId id) const { return tag_ids_.data() + tag_offsets_[id + 1]; }
+
+    const TagInterner& getTagInterner() const { return tag_interner_; }
+    
+    // Active events carrying the tag, in ascending id order
+    const std::vector<EventId>& getPostings(TagInterner::TagId tag) const {
+        static const std::vector<EventId> none;
+        return tag < postings_.size() ? postings_[tag] : none;
+    }
+    
+    // Spatial index over the events that have coordinates; the rest are listed separately
+    const GeoIndex& getGeoIndex() const { return geo_index_; }
+    const std::vector<EventId>& getEventsWithoutCoordinates() const { return events_without_coordinates_; }
+
+    // Rebuilds a standalone Event (same Event::Id) from the columns
+    Event materialize(EventId id) const;
+
+private:
+    TagInterner& tag_interner_;
+
+    std::vector<std::chrono::system_clock::time_point> start_times_;
+    std::vector<std::chrono::system_clock::time_point> end_times_;
+    std::vector<LocationId> location_ids_;
+    std::vector<std::uint32_t> tag_offsets_;
+    std::vector<TagInterner::TagId> tag_ids_;
+    std::vector<Event::Id> source_ids_;
+    std::vector<GeoPoint> coordinates_;
+    std::vector<std::uint8_t> has_coordinates_;
+    std::vector<std::uint8_t> active_;
+    size_t active_count_;
+    std::vector<std::vector<EventId>> postings_;
+    GeoIndex geo_index_;
+    std::vector<EventId> events_without_coordinates_;
+
+    std::vector<std::string_view> names_;
+    std::vector<std::string_view> descriptions_;
+    // Backing for the views above; deque elements never move
+    std::deque<std::string> owned_strings_;
+    std::vector<std::shared_ptr<const EventCatalog>> catalogs_;
+
+    std::vector<std::string> locations_;
+    std::unordered_map<std::string, LocationId> location_index_;
+
+    std::vector<TagInterner::TagId> tag_scratch_;
+
+    LocationId internLocation(const std::string& location);
+    std::string_view ownString(const std::string& text);
+    // Tags come from tag_scratch_
+    EventId appendRow(Event::Id source_id, std::string_view name, std::string_view description,
+                      std::chrono::system_clock::time_point start_time,
+                      std::chrono::system_clock::time_point end_time,
+                      LocationId location_id, const GeoPoint* coordinates);
+};
\ No newline at end of file
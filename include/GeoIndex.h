@@ -0,0 +1,40 @@
+#pragma once
+#include "GeoPoint.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Fixed-size latitude/longitude grid over point ids. A radius query visits
+// only the cells overlapping the circle's bounding box, then checks the exact
+// haversine distance of each point in them.
+class GeoIndex {
+public:
+    using Id = std::uint32_t;
+
+    explicit GeoIndex(double cell_degrees = 0.1);
+
+    void insert(Id id, const GeoPoint& point);
+    // point must be the one the id was inserted with
+    bool remove(Id id, const GeoPoint& point);
+    void clear();
+    size_t size() const { return size_; }
+
+    // Appends the ids within radius_km of center to out, in ascending order
+    void queryRadius(const GeoPoint& center, double radius_km, std::vector<Id>& out) const;
+
+private:
+    struct Entry {
+        Id id;
+        GeoPoint point;
+    };
+
+    double cell_degrees_;
+    std::int64_t longitude_cells_;
+    std::unordered_map<std::int64_t, std::vector<Entry>> cells_;
+    size_t size_;
+
+    std::int64_t latitudeCell(double latitude) const;
+    std::int64_t longitudeCell(double longitude) const;
+    std::int64_t cellKey(std::int64_t latitude_cell, std::int64_t longitude_cell) const;
+};
\ No newline at end of file
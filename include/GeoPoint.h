@@ -0,0 +1,9 @@
+#pragma once
+
+struct GeoPoint {
+    double latitude;
+    double longitude;
+
+    // Great-circle distance on a spherical Earth (mean radius), in kilometres
+    static double distanceKm(const GeoPoint& from, const GeoPoint& to);
+};
\ No newline at end of file
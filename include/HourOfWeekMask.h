@@ -0,0 +1,35 @@
+#pragma once
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// One bit per local hour of the week, Monday 00:00-00:59 being bit 0.
+class HourOfWeekMask {
+public:
+    static constexpr size_t HOURS_PER_WEEK = 168;
+    // Day sets are bitmasks with Monday as bit 0
+    static const std::uint8_t ALL_DAYS = 0x7F;
+
+    // Inclusive hour range on each of the given days. A range with start_hour > end_hour
+    // runs past midnight into the following day.
+    void addSlot(int start_hour, int end_hour, std::uint8_t days = ALL_DAYS);
+    void setAll() { bits_.set(); }
+    void clear() { bits_.reset(); }
+
+    bool test(size_t hour_of_week) const { return bits_.test(hour_of_week); }
+    bool none() const { return bits_.none(); }
+    size_t count() const { return bits_.count(); }
+
+    // Hour-of-week index for seconds since the epoch in local wall clock time
+    static size_t hourOfWeek(std::int64_t local_seconds);
+
+    // Accepts full or three-letter English day names in any case. Unknown names are
+    // ignored; an empty list means every day.
+    static std::uint8_t parseDays(const std::vector<std::string>& days);
+    static std::string formatDays(std::uint8_t days);
+
+private:
+    std::bitset<HOURS_PER_WEEK> bits_;
+};
\ No newline at end of file
@@ -0,0 +1,93 @@
+#pragma once
+#include "ConnectionPool.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Asynchronous HTTP client driven by a single I/O thread running curl_multi.
+// Requests to the same host are multiplexed over HTTP/2 when the server supports it.
+// Completion callbacks run on the I/O thread and must not block on other transfers.
+class HttpTransport {
+public:
+    // Receives successful response bytes as they arrive instead of buffering them;
+    // returning false aborts the transfer. Error responses are still buffered.
+    using DataCallback = std::function<bool(const char* data, size_t size)>;
+    // Shared with whoever may abandon the request; see cancel()
+    using CancelFlag = std::shared_ptr<std::atomic<bool>>;
+
+    struct Request {
+        std::string url;
+        std::vector<std::string> headers;
+        std::string body;
+        DataCallback on_data;
+        // Zero means no limit
+        std::chrono::milliseconds connect_timeout{0};
+        std::chrono::milliseconds timeout{0};
+        CancelFlag cancel = nullptr;
+    };
+
+    struct Response {
+        bool success;
+        long status_code;
+        std::string body;
+        std::string error_message;
+        CURLcode result = CURLE_OK;
+        // From a Retry-After header; zero if there was none
+        std::chrono::seconds retry_after{0};
+    };
+
+    using CompletionCallback = std::function<void(Response)>;
+
+    explicit HttpTransport(std::shared_ptr<ConnectionPool> connection_pool = nullptr);
+    ~HttpTransport();
+
+    HttpTransport(const HttpTransport&) = delete;
+    HttpTransport& operator=(const HttpTransport&) = delete;
+
+    void submit(Request request, CompletionCallback on_complete);
+    // Sets the flag and aborts every request carrying it; they complete with
+    // CURLE_ABORTED_BY_CALLBACK
+    void cancel(const CancelFlag& flag);
+
+    size_t getInFlightCount() const { return in_flight_.load(); }
+    const std::shared_ptr<ConnectionPool>& getConnectionPool() const { return connection_pool_; }
+
+    static std::shared_ptr<HttpTransport> getShared();
+    static void setShared(std::shared_ptr<HttpTransport> transport);
+
+private:
+    struct Transfer {
+        Request request;
+        CompletionCallback on_complete;
+        CURL* handle = nullptr;
+        curl_slist* header_list = nullptr;
+        std::string response_body;
+    };
+
+    std::shared_ptr<ConnectionPool> connection_pool_;
+    CURLM* multi_;
+    std::thread io_thread_;
+    std::atomic<bool> stopping_;
+    std::atomic<size_t> in_flight_;
+
+    std::mutex pending_mutex_;
+    std::vector<std::unique_ptr<Transfer>> pending_;
+
+    // Owned by the I/O thread
+    std::unordered_map<CURL*, std::unique_ptr<Transfer>> active_;
+
+    void run();
+    void startPending();
+    void completeFinished();
+    void abortCancelled();
+    void finish(std::unique_ptr<Transfer> transfer, CURLcode result);
+    void abortAll();
+
+    static size_t writeBody(void* contents, size_t size, size_t nmemb, void* userp);
+};
\ No newline at end of file
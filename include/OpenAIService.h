@@ -6,10 +6,17 @@ public:
     explicit OpenAIService(const std::string& api_key);
 
     std::future<AIResponse> generateResponse(const std::string& prompt) override;
+    void generateResponse(const std::string& prompt, ResponseCallback on_complete,
+                          CancelFlag cancel = nullptr) override;
     std::future<AIResponse> analyzePreferences(const std::string& user_data) override;
     std::future<AIResponse> recommendEvents(
         const std::string& preferences, 
         const std::string& available_events) override;
+    void streamResponse(const std::string& prompt, DeltaCallback on_delta,
+                        ResponseCallback on_complete) override;
+
+    std::string getProviderName() const override { return "openai"; }
+    std::string getModelName() const override { return MODEL_NAME; }
 
 private:
     static const std::string OPENAI_BASE_URL;
@@ -1,4 +1,11 @@
 #pragma once
+#include "GeoPoint.h"
+#include "HourOfWeekMask.h"
+#include "TagInterner.h"
+#include "TimeZone.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -14,18 +21,66 @@ public:
     
     const std::unordered_map<std::string, int>& getInterests() const { return interests_; }
     
+    // Compiled form of the interests, indexed by TagInterner::global() id. Ids past the end
+    // of the arrays belong to tags interned after the last interest change and never match.
+    bool findInterest(TagInterner::TagId tag, int& weight) const {
+        if (tag >= interest_mask_.size() || !interest_mask_[tag]) {
+            return false;
+        }
+        weight = interest_weights_[tag];
+        return true;
+    }
+    const std::vector<int>& getInterestWeights() const { return interest_weights_; }
+    const std::vector<std::uint8_t>& getInterestMask() const { return interest_mask_; }
+    
+    // Slots set this way apply to every day of the week
     void setPreferredTimeSlots(const std::vector<std::pair<int, int>>& time_slots);
+    void addPreferredTimeSlot(int start_hour, int end_hour, std::uint8_t days = HourOfWeekMask::ALL_DAYS);
     const std::vector<std::pair<int, int>>& getPreferredTimeSlots() const { return preferred_time_slots_; }
+    const std::vector<std::uint8_t>& getPreferredTimeSlotDays() const { return preferred_time_slot_days_; }
+    
+    // Preferred local hours of the week; every hour when no slots are set
+    const HourOfWeekMask& getHourOfWeekMask() const { return hour_of_week_mask_; }
+    bool isPreferredTime(const std::chrono::system_clock::time_point& time) const {
+        std::int64_t utc_seconds = TimeZone::toUnixSeconds(time);
+        return hour_of_week_mask_.test(HourOfWeekMask::hourOfWeek(utc_seconds + time_zone_->getOffset(utc_seconds)));
+    }
+    
+    // IANA name such as "America/Los_Angeles"; empty means the system zone. Returns false
+    // (and keeps the current zone) if the zone is unknown.
+    bool setTimeZone(const std::string& time_zone);
+    const TimeZone& getTimeZone() const { return *time_zone_; }
     
     void setMaxTravelDistance(double distance) { max_travel_distance_ = distance; }
     double getMaxTravelDistance() const { return max_travel_distance_; }
     
     void setLocation(const std::string& location) { user_location_ = location; }
     const std::string& getLocation() const { return user_location_; }
+    
+    void setCoordinates(const GeoPoint& coordinates) { coordinates_ = coordinates; has_coordinates_ = true; }
+    bool hasCoordinates() const { return has_coordinates_; }
+    const GeoPoint& getCoordinates() const { return coordinates_; }
+    
+    // Only meaningful when hasCoordinates()
+    double getTravelDistanceKm(const GeoPoint& point) const { return GeoPoint::distanceKm(coordinates_, point); }
+    bool isWithinTravelDistance(double distance_km) const { return distance_km <= max_travel_distance_; }
+    // 1.0 on the user's doorstep, falling linearly to 0.5 at the travel limit
+    double getProximityScore(double distance_km) const {
+        return distance_km >= max_travel_distance_ ? 0.5 : 1.0 - 0.5 * (distance_km / max_travel_distance_);
+    }
 
 private:
     std::unordered_map<std::string, int> interests_;
+    std::vector<int> interest_weights_;
+    std::vector<std::uint8_t> interest_mask_;
     std::vector<std::pair<int, int>> preferred_time_slots_;
+    std::vector<std::uint8_t> preferred_time_slot_days_;
+    HourOfWeekMask hour_of_week_mask_;
+    std::shared_ptr<const TimeZone> time_zone_;
     double max_travel_distance_;
     std::string user_location_;
+    GeoPoint coordinates_;
+    bool has_coordinates_;
+    
+    void setCompiledWeight(const std::string& interest, int weight);
 };
\ No newline at end of file
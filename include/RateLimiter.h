@@ -0,0 +1,59 @@
+#pragma once
+#include <chrono>
+#include <functional>
+#include <memory>
+
+// Client-side limit on one provider's request and token rates, kept as two token
+// buckets that refill continuously and hold at most one minute's allowance.
+// Callers that would exceed either limit are queued and released in order as
+// the buckets refill, rather than being turned away; the provider then never
+// sees more than it allows, so bursts do not turn into waves of 429s.
+class RateLimiter {
+public:
+    using Clock = std::chrono::steady_clock;
+    using ReadyCallback = std::function<void()>;
+
+    // Zero means unlimited
+    struct Options {
+        double requests_per_minute = 0;
+        double tokens_per_minute = 0;
+    };
+
+    struct Stats {
+        size_t granted;
+        size_t delayed;
+        size_t pauses;
+        size_t waiting;
+        std::chrono::milliseconds total_delay;
+    };
+
+    RateLimiter();
+    explicit RateLimiter(const Options& options);
+    ~RateLimiter();
+    RateLimiter(const RateLimiter&) = delete;
+    RateLimiter& operator=(const RateLimiter&) = delete;
+
+    // Calls on_ready once one request and `tokens` tokens are available, and not before
+    // not_before. Runs inline when nothing has to wait, otherwise on the limiter's
+    // thread, so on_ready must not block. Requests larger than a minute's token
+    // allowance are charged the full allowance.
+    void acquire(size_t tokens, ReadyCallback on_ready, Clock::time_point not_before = Clock::time_point());
+    // Blocking form
+    void acquire(size_t tokens);
+
+    // Holds every waiter until `until`, e.g. for a Retry-After the provider sent
+    void pauseUntil(Clock::time_point until);
+
+    const Options& getOptions() const { return options_; }
+    Stats getStats() const;
+
+private:
+    // Shared with the limiter's thread, which may outlive the limiter briefly: the
+    // callback it runs can drop the last reference to the limiter itself
+    struct State;
+
+    Options options_;
+    std::shared_ptr<State> state_;
+
+    static void run(std::shared_ptr<State> state);
+};
\ No newline at end of file
@@ -1,8 +1,12 @@
 #pragma once
 #include "User.h"
 #include "Event.h"
+#include "EventStore.h"
 #include "Schedule.h"
+#include "ThreadPool.h"
+#include "TopKSelector.h"
 #include "AIService.h"
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -14,26 +18,148 @@ public:
         std::string reasoning;
     };
 
+    // One user's inputs to a batch pass; both must outlive the call
+    struct BatchUser {
+        const Preferences* preferences;
+        const Schedule* schedule;
+    };
+
+    using StreamCallback = std::function<void(const std::string& delta)>;
+    // Yields the next catalog event, or nullptr when exhausted. The pointee only needs to
+    // stay valid until the next call; events that make the top k are copied.
+    using EventSource = std::function<const Event*()>;
+
     explicit RecommendationEngine(std::shared_ptr<AIService> ai_service);
 
+    // Checks every event's travel distance in turn; only the EventStore overload below
+    // narrows the catalog through a spatial index
+    std::vector<EventRecommendation> recommendEvents(
+        const User& user,
+        const std::vector<Event>& available_events,
+        const Schedule& user_schedule,
+        int max_recommendations = 10
+    );
+
+    // Same ranking, but the AI commentary is streamed to on_ai_delta (from the transport's I/O thread) as it arrives
     std::vector<EventRecommendation> recommendEvents(
         const User& user,
         const std::vector<Event>& available_events,
         const Schedule& user_schedule,
+        int max_recommendations,
+        const StreamCallback& on_ai_delta
+    );
+
+    // Scores the columnar catalog directly; only the winning events are materialized
+    std::vector<EventRecommendation> recommendEvents(
+        const User& user,
+        const EventStore& available_events,
+        const Schedule& user_schedule,
+        int max_recommendations = 10
+    );
+
+    // Local ranking for many users in one pass over the catalog, one list per user in
+    // input order. No AI commentary is requested.
+    std::vector<std::vector<EventRecommendation>> recommendEventsForUsers(
+        const std::vector<BatchUser>& users,
+        const EventStore& available_events,
+        int max_recommendations = 10
+    );
+
+    // Single pass over a catalog that is never held in memory as a whole
+    std::vector<EventRecommendation> recommendEvents(
+        const User& user,
+        const EventSource& next_event,
+        const Schedule& user_schedule,
         int max_recommendations = 10
     );
 
+    template <typename InputIt>
+    std::vector<EventRecommendation> recommendEvents(
+        const User& user,
+        InputIt first,
+        InputIt last,
+        const Schedule& user_schedule,
+        int max_recommendations = 10) {
+        
+        // Advance lazily so input iterators never have to keep a dereferenced value alive
+        bool started = false;
+        EventSource next_event = [&first, &last, started]() mutable -> const Event* {
+            if (started && first != last) {
+                ++first;
+            }
+            started = true;
+            return first != last ? &*first : nullptr;
+        };
+        return recommendEvents(user, next_event, user_schedule, max_recommendations);
+    }
+
     void updateUserInterests(User& user, const std::vector<Event>& attended_events);
     
     double calculateEventScore(const Event& event, const Preferences& preferences);
+    double calculateEventScore(const EventStore& store, EventStore::EventId id, const Preferences& preferences);
+    
+    // Upper bound on the estimated size of each AI prompt; only locally ranked candidates that fit are sent
+    void setPromptTokenBudget(size_t token_budget) { prompt_token_budget_ = token_budget; }
+    size_t getPromptTokenBudget() const { return prompt_token_budget_; }
+    size_t getLastPromptTokenEstimate() const { return last_prompt_tokens_; }
+    // Why the last AI request failed, after retries; empty if it succeeded. Recommendations
+    // keep their locally computed reasoning when it fails.
+    const std::string& getLastAIError() const { return last_ai_error_; }
+    
+    static size_t estimateTokens(const std::string& text);
+    
+    // Catalogs larger than one chunk are scored on this many threads; 0 or 1 scores on the
+    // calling thread. Results do not depend on the thread count.
+    void setThreadCount(size_t thread_count);
+    size_t getThreadCount() const;
 
 private:
     std::shared_ptr<AIService> ai_service_;
+    size_t prompt_token_budget_;
+    size_t last_prompt_tokens_;
+    std::string last_ai_error_;
+    std::unique_ptr<ThreadPool> thread_pool_;
+    
+    static const size_t PARALLEL_GRAIN = 4096;
+    static const size_t USER_GROUP_SIZE = 16;
+    
+    // Offers the candidates in [begin, end) to the given selector
+    using CollectRange = std::function<void(size_t begin, size_t end, TopKSelector& top)>;
+    TopKSelector selectTop(size_t count, int max_recommendations, const CollectRange& collect);
+    
+    std::vector<EventRecommendation> rankEvents(
+        const Preferences& preferences,
+        const std::vector<Event>& available_events,
+        const Schedule& user_schedule,
+        int max_recommendations);
+    std::vector<EventRecommendation> rankEvents(
+        const Preferences& preferences,
+        const EventStore& available_events,
+        const Schedule& user_schedule,
+        int max_recommendations);
+    std::vector<EventRecommendation> rankEvents(
+        const Preferences& preferences,
+        const EventSource& next_event,
+        const Schedule& user_schedule,
+        int max_recommendations);
+    void requestAIReasoning(const Preferences& preferences,
+                            std::vector<EventRecommendation>& recommendations,
+                            const StreamCallback& on_ai_delta);
+    void applyAIReasoning(std::vector<EventRecommendation>& recommendations, const AIService::AIResponse& result);
     
-    double calculateTimePreferenceScore(const Event& event, const Preferences& preferences);
+    double calculateTimePreferenceScore(const std::chrono::system_clock::time_point& start,
+                                        const Preferences& preferences);
     double calculateInterestScore(const Event& event, const Preferences& preferences);
-    double calculateLocationScore(const Event& event, const Preferences& preferences);
+    double calculateInterestScore(const EventStore& store, EventStore::EventId id, const Preferences& preferences);
+    double calculateLocationScore(const std::string& location, const GeoPoint* coordinates,
+                                  const Preferences& preferences);
+    // Events without coordinates, or scored for users without them, always pass
+    bool isWithinTravelDistance(const Event& event, const Preferences& preferences);
     
-    std::string formatEventData(const std::vector<Event>& events);
+    std::string formatEventData(const std::vector<EventRecommendation>& candidates,
+                                const Preferences& preferences, size_t token_budget);
     std::string formatPreferences(const Preferences& preferences);
+    void buildPromptSections(const Preferences& preferences,
+                             const std::vector<EventRecommendation>& candidates,
+                             std::string& preferences_text, std::string& events_text);
 };
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+#include "BatchScorer.h"
+#include "EventStore.h"
+#include "Preferences.h"
+#include "RecommendationEngine.h"
+#include "Schedule.h"
+#include "TopKSelector.h"
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Keeps one user's top k over an EventStore current across small changes. Only the
+// best k + reserve in-range events are held, ordered by score, and every event left
+// out scores below the last one held. An interest-weight change rescores only the
+// events carrying that tag and a catalog change touches only the added or removed
+// rows; an event re-enters only by beating the last one held. When removals and
+// lowered scores drain the reserve below k, the whole store is rescanned. Rankings
+// match RecommendationEngine::recommendEvents on the same store (without AI
+// commentary).
+class RecommenderSession {
+public:
+    struct Stats {
+        size_t rebuilds;
+        size_t rescans;
+        size_t rescored_events;
+    };
+
+    static constexpr size_t DEFAULT_RESERVE = 16;
+
+    // The store, preferences and schedule must outlive the session. Changes to them
+    // have to go through the session (or be followed by rebuild()) to be seen.
+    RecommenderSession(EventStore& store, Preferences& preferences, const Schedule& schedule,
+                       int max_recommendations = 10, size_t reserve = DEFAULT_RESERVE);
+
+    void addInterest(const std::string& interest, int weight = 1);
+    void setInterestWeight(const std::string& interest, int weight);
+    void removeInterest(const std::string& interest);
+    // Same weight bumps as RecommendationEngine::updateUserInterests
+    void recordAttendance(const std::vector<Event>& attended_events);
+
+    EventStore::EventId addEvent(const Event& event);
+    bool removeEvent(EventStore::EventId id);
+
+    // Rescores everything; needed after time slots, time zone, location or travel
+    // settings change, or after the store was modified directly
+    void rebuild();
+
+    // Best events that do not conflict with the schedule, best first. The schedule is
+    // checked here rather than cached, so it may change freely between calls; if
+    // conflicts use up the held events, the ranking falls back to a full pass.
+    std::vector<RecommendationEngine::EventRecommendation> getRecommendations() const;
+
+    Stats getStats() const { return stats_; }
+
+private:
+    struct Order {
+        bool operator()(const TopKSelector::Entry& a, const TopKSelector::Entry& b) const {
+            return TopKSelector::isBetter(a, b);
+        }
+    };
+
+    EventStore& store_;
+    Preferences& preferences_;
+    const Schedule& schedule_;
+    size_t max_recommendations_;
+    size_t capacity_;
+    BatchScorer::Profile profile_;
+    std::set<TopKSelector::Entry, Order> ranked_;
+    std::unordered_map<EventStore::EventId, double> ranked_scores_;
+    // True while ranked_ holds every in-range event
+    bool complete_;
+    Stats stats_;
+
+    void rescan();
+    void refillIfDrained();
+    void offer(EventStore::EventId id, double score);
+    void unrank(EventStore::EventId id);
+    void rescoreRows(const std::vector<EventStore::EventId>& ids);
+    void rescoreInterests(const std::vector<std::string>& interests);
+    std::vector<EventStore::EventId> activeRows() const;
+};
\ No newline at end of file
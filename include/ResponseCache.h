@@ -0,0 +1,87 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Content-addressed cache of AI responses with an in-memory LRU tier backed by
+// one file per entry on disk. Both tiers are capped at max_bytes.
+class ResponseCache {
+public:
+    struct Options {
+        size_t max_bytes = 100 * 1024 * 1024;
+        std::chrono::seconds ttl{24 * 60 * 60};
+        // A relative path is taken from the working directory
+        std::string directory = "cache/ai_responses";
+    };
+
+    struct Stats {
+        size_t memory_hits;
+        size_t disk_hits;
+        size_t misses;
+        size_t stores;
+        size_t evictions;
+        size_t memory_entries;
+        size_t memory_bytes;
+        size_t disk_entries;
+        size_t disk_bytes;
+    };
+
+    ResponseCache();
+    explicit ResponseCache(const Options& options);
+
+    bool lookup(const std::string& provider, const std::string& model,
+                const std::string& prompt, std::string& content);
+    void store(const std::string& provider, const std::string& model,
+               const std::string& prompt, const std::string& content);
+    void clear();
+
+    Stats getStats() const;
+
+    static std::string normalizePrompt(const std::string& prompt);
+    static std::string makeKey(const std::string& provider, const std::string& model,
+                               const std::string& prompt);
+
+private:
+    struct MemoryEntry {
+        std::string key;
+        std::string content;
+        int64_t created_at;
+    };
+
+    struct DiskEntry {
+        std::string key;
+        size_t bytes;
+        // Identifies the store that claimed the key; pending until its file is renamed into place
+        uint64_t generation;
+        bool pending;
+    };
+
+    Options options_;
+
+    mutable std::mutex mutex_;
+    std::list<MemoryEntry> memory_lru_;
+    std::unordered_map<std::string, std::list<MemoryEntry>::iterator> memory_index_;
+    size_t memory_bytes_;
+
+    std::list<DiskEntry> disk_lru_;
+    std::unordered_map<std::string, std::list<DiskEntry>::iterator> disk_index_;
+    size_t disk_bytes_;
+    uint64_t disk_generation_;
+
+    size_t memory_hits_;
+    size_t disk_hits_;
+    size_t misses_;
+    size_t stores_;
+    size_t evictions_;
+
+    void loadDiskIndex();
+    void insertMemoryLocked(const std::string& key, const std::string& content, int64_t created_at);
+    void removeDiskLocked(std::string key);
+    bool isExpired(int64_t created_at) const;
+    std::string pathFor(const std::string& key) const;
+
+    static int64_t now();
+};
\ No newline at end of file
@@ -0,0 +1,88 @@
+#pragma once
+#include "AIService.h"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Spreads requests over several providers. Each provider's latency is tracked as
+// an EWMA plus p95/p99 over its recent successful responses, and each request
+// goes to the healthy provider with the lowest EWMA; providers nobody has timed
+// yet are tried first. A provider that fails failure_threshold times in a row is
+// skipped for unhealthy_cooldown, then given another chance.
+//
+// With hedging on, a request the primary has not answered within its p95 is
+// duplicated to the next fastest provider. The first success wins and the other
+// request is cancelled; a failure moves the request on to a provider that has
+// not been tried. Streaming requests are routed but never hedged, since both
+// streams would reach the caller.
+class RoutingService : public AIService {
+public:
+    struct Options {
+        bool hedge = true;
+        // Hedge delay until a provider has min_samples latencies, and the floor after
+        std::chrono::milliseconds initial_hedge_delay{2000};
+        std::chrono::milliseconds min_hedge_delay{50};
+        size_t min_samples = 20;
+        double ewma_alpha = 0.2;
+        int failure_threshold = 3;
+        std::chrono::seconds unhealthy_cooldown{30};
+    };
+
+    struct ProviderStats {
+        std::string name;
+        bool healthy;
+        size_t samples;
+        double ewma_ms;
+        double p95_ms;
+        double p99_ms;
+        size_t requests;
+        size_t failures;
+        size_t wins;
+        size_t cancelled;
+    };
+
+    struct Stats {
+        size_t requests;
+        size_t hedged;
+        size_t hedge_wins;
+        size_t failovers;
+        size_t failures;
+    };
+
+    explicit RoutingService(std::vector<std::shared_ptr<AIService>> providers);
+    RoutingService(std::vector<std::shared_ptr<AIService>> providers, const Options& options);
+    ~RoutingService() override;
+
+    std::future<AIResponse> generateResponse(const std::string& prompt) override;
+    void generateResponse(const std::string& prompt, ResponseCallback on_complete,
+                          CancelFlag cancel = nullptr) override;
+    std::future<AIResponse> analyzePreferences(const std::string& user_data) override;
+    std::future<AIResponse> recommendEvents(
+        const std::string& preferences,
+        const std::string& available_events) override;
+    void streamResponse(const std::string& prompt, DeltaCallback on_delta,
+                        ResponseCallback on_complete) override;
+    void cancel(const CancelFlag& flag) override;
+
+    std::string getProviderName() const override { return "routing"; }
+    std::string getModelName() const override;
+
+    std::vector<ProviderStats> getProviderStats() const;
+    Stats getStats() const;
+
+private:
+    // Provider latency and health plus the hedge timer, shared with in-flight
+    // requests so they can finish after the router is gone
+    struct Shared;
+    struct Race;
+
+    std::shared_ptr<Shared> shared_;
+
+    // hedge marks the duplicate sent by the hedge timer, as opposed to the first attempt or a failover
+    static void launch(const std::shared_ptr<Shared>& shared, const std::shared_ptr<Race>& race, size_t provider,
+                       bool hedge);
+    static void finishAttempt(const std::shared_ptr<Shared>& shared, const std::shared_ptr<Race>& race,
+                              size_t provider, std::chrono::steady_clock::time_point started, AIResponse response);
+    static void runTimer(std::shared_ptr<Shared> shared);
+};
\ No newline at end of file
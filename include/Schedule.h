@@ -2,26 +2,120 @@
 #include "Event.h"
 #include <vector>
 #include <chrono>
+#include <iterator>
+#include <string>
+#include <unordered_map>
 
 class Schedule {
 public:
+    // Non-owning view over the scheduled events that lie entirely within a time range.
+    // Invalidated by any modification of the schedule.
+    class EventRangeView {
+    public:
+        class iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Event;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Event*;
+            using reference = const Event&;
+
+            iterator(const Event* current, const Event* last, std::chrono::system_clock::time_point end)
+                : current_(current), last_(last), end_(end) { skip(); }
+
+            reference operator*() const { return *current_; }
+            pointer operator->() const { return current_; }
+            iterator& operator++() { ++current_; skip(); return *this; }
+            iterator operator++(int) { iterator copy = *this; ++*this; return copy; }
+            bool operator==(const iterator& other) const { return current_ == other.current_; }
+            bool operator!=(const iterator& other) const { return current_ != other.current_; }
+
+        private:
+            const Event* current_;
+            const Event* last_;
+            std::chrono::system_clock::time_point end_;
+
+            void skip() { while (current_ != last_ && current_->getEndTime() > end_) ++current_; }
+        };
+
+        EventRangeView(const Event* first, const Event* last, std::chrono::system_clock::time_point end)
+            : first_(first), last_(last), end_(end) {}
+
+        iterator begin() const { return iterator(first_, last_, end_); }
+        iterator end() const { return iterator(last_, last_, end_); }
+        bool empty() const { return begin() == end(); }
+        size_t size() const { return static_cast<size_t>(std::distance(begin(), end())); }
+
+    private:
+        const Event* first_;
+        const Event* last_;
+        std::chrono::system_clock::time_point end_;
+    };
+
     Schedule();
 
+    // A single insert shifts every later event, so loading many events out of
+    // order should go through addEvents, which sorts and indexes them once
     void addEvent(const Event& event);
+    void addEvent(Event&& event);
+    void addEvents(std::vector<Event> events);
     void removeEvent(const std::string& event_name);
+    bool removeEventById(Event::Id event_id);
     
     const std::vector<Event>& getEvents() const { return events_; }
     
     std::vector<Event> getEventsInRange(
         const std::chrono::system_clock::time_point& start,
         const std::chrono::system_clock::time_point& end) const;
+    EventRangeView viewEventsInRange(
+        const std::chrono::system_clock::time_point& start,
+        const std::chrono::system_clock::time_point& end) const;
         
     bool hasConflict(const Event& event) const;
+    bool hasConflict(
+        const std::chrono::system_clock::time_point& start,
+        const std::chrono::system_clock::time_point& end) const;
+    // Writes hasConflict() for each event in [first, last) to `out`. Events in order of
+    // end time share one forward pass over the index; any others cost a binary search.
+    template <typename InputIterator, typename OutputIterator>
+    OutputIterator conflictsFor(InputIterator first, InputIterator last, OutputIterator out) const;
+    std::vector<bool> conflictsFor(const std::vector<Event>& events) const;
     std::vector<std::pair<std::chrono::system_clock::time_point, std::chrono::system_clock::time_point>> 
         getFreeTimeSlots(
             const std::chrono::system_clock::time_point& start,
             const std::chrono::system_clock::time_point& end) const;
 
 private:
+    // events_ is kept sorted by start time; max_end_[i] is the latest end time among events_[0..i]
     std::vector<Event> events_;
-};
\ No newline at end of file
+    std::vector<std::chrono::system_clock::time_point> max_end_;
+    std::unordered_multimap<Event::Id, std::chrono::system_clock::time_point> id_index_;
+    std::unordered_multimap<std::string, std::chrono::system_clock::time_point> name_index_;
+    
+    void insertSorted(Event&& event);
+    void indexEvent(const Event& event);
+    void unindexEvent(const Event& event);
+    template <typename Predicate>
+    void findStartingAt(const std::chrono::system_clock::time_point& start, Predicate matches,
+                        std::vector<size_t>& positions) const;
+    void eraseAt(std::vector<size_t> positions);
+    void rebuildIndexFrom(size_t first);
+    size_t countStartingBefore(const std::chrono::system_clock::time_point& time) const;
+    size_t countStartingBefore(const std::chrono::system_clock::time_point& time, size_t from) const;
+};
+
+template <typename InputIterator, typename OutputIterator>
+OutputIterator Schedule::conflictsFor(InputIterator first, InputIterator last, OutputIterator out) const {
+    size_t candidates = 0;
+    auto previous_end = std::chrono::system_clock::time_point::min();
+    for (; first != last; ++first, ++out) {
+        const Event& event = *first;
+        // Everything counted for an earlier end also starts before a later one
+        candidates = event.getEndTime() >= previous_end
+            ? countStartingBefore(event.getEndTime(), candidates)
+            : countStartingBefore(event.getEndTime());
+        previous_end = event.getEndTime();
+        *out = candidates > 0 && max_end_[candidates - 1] > event.getStartTime();
+    }
+    return out;
+}
\ No newline at end of file
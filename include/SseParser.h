@@ -0,0 +1,27 @@
+#pragma once
+#include <functional>
+#include <string>
+
+// Incremental parser for text/event-stream bodies. Bytes can be fed in
+// arbitrary chunks as they arrive; each complete event is dispatched once.
+class SseParser {
+public:
+    using EventCallback = std::function<void(const std::string& event, const std::string& data)>;
+
+    explicit SseParser(EventCallback on_event);
+
+    void feed(const char* data, size_t size);
+    // Ends the stream, dropping any event that was not terminated by a blank line
+    void finish();
+
+private:
+    EventCallback on_event_;
+    std::string line_;
+    std::string event_;
+    std::string data_;
+    bool has_data_;
+    bool skip_line_feed_;
+
+    void processLine();
+    void dispatch();
+};
\ No newline at end of file
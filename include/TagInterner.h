@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+// Maps tag strings to dense integer ids. Ids are never reused or released,
+// so they can index flat arrays for the lifetime of the process.
+class TagInterner {
+public:
+    using TagId = std::uint32_t;
+    static const TagId INVALID_TAG;
+
+    TagId intern(const std::string& tag);
+    TagId find(const std::string& tag) const;
+    const std::string& getName(TagId id) const;
+    size_t size() const;
+
+    static TagInterner& global();
+
+private:
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<std::string, TagId> ids_;
+    std::deque<std::string> names_;
+};
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of workers, each with its own task deque. A worker runs its own
+// tasks newest first and, when idle, steals the oldest task of another worker.
+class ThreadPool {
+public:
+    // Tasks receive the index of the worker running them, in [0, getThreadCount())
+    using Task = std::function<void(size_t worker)>;
+    using RangeTask = std::function<void(size_t worker, size_t begin, size_t end)>;
+
+    explicit ThreadPool(size_t thread_count);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(Task task);
+
+    // Splits [0, count) into chunks of at most `grain` items, runs them on the pool and
+    // blocks until all are done. The first exception thrown by a chunk is rethrown here.
+    // Must not be called from a task running on this pool.
+    void parallelFor(size_t count, size_t grain, const RangeTask& body);
+
+    size_t getThreadCount() const { return threads_.size(); }
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> threads_;
+
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    std::atomic<size_t> pending_;
+    std::atomic<size_t> next_queue_;
+    bool stopping_;
+
+    void run(size_t worker);
+    bool popLocal(size_t worker, Task& task);
+    bool steal(size_t worker, Task& task);
+};
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// IANA time zone loaded from the system zoneinfo database (TZif files), with
+// the trailing POSIX rule expanded through 2100. Instances are immutable and
+// shared, so offset lookups are safe from any thread.
+class TimeZone {
+public:
+    // Caches the transition interval of the last lookup; nearby times (such as a
+    // catalog sorted or tiled by start time) then resolve without a search.
+    // Not thread-safe; use one cursor per thread.
+    class Cursor {
+    public:
+        explicit Cursor(const TimeZone& zone);
+        std::int32_t getOffset(std::int64_t utc_seconds);
+
+    private:
+        const TimeZone* zone_;
+        std::int64_t begin_;
+        std::int64_t end_;
+        std::int32_t offset_;
+    };
+
+    // Zones are loaded once and shared. An empty name is the system zone (/etc/localtime).
+    // Returns nullptr if the zone cannot be found or parsed.
+    static std::shared_ptr<const TimeZone> get(const std::string& name);
+    static std::shared_ptr<const TimeZone> utc();
+
+    // "local" for the system zone
+    const std::string& getName() const { return name_; }
+
+    // Seconds east of UTC in effect at the given instant
+    std::int32_t getOffset(std::int64_t utc_seconds) const;
+    std::int32_t getOffset(const std::chrono::system_clock::time_point& time) const;
+
+    static std::int64_t toUnixSeconds(const std::chrono::system_clock::time_point& time);
+    // Inverse of toUnixSeconds; false if system_clock cannot represent the instant
+    static bool fromUnixSeconds(std::int64_t utc_seconds, std::chrono::system_clock::time_point& time);
+    // "YYYY-MM-DDTHH:MM[:SS]" with an optional "Z" or +hh:mm / -hh:mm suffix (UTC if none)
+    static bool parseIso8601(const std::string& text, std::int64_t& utc_seconds);
+
+private:
+    std::string name_;
+    // offsets_[i] applies before transitions_[i]; offsets_.back() after the last one
+    std::vector<std::int64_t> transitions_;
+    std::vector<std::int32_t> offsets_;
+
+    TimeZone();
+
+    size_t findInterval(std::int64_t utc_seconds) const;
+    bool parseTzif(const std::string& data);
+    bool applyPosixRule(const std::string& rule);
+};
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Keeps the k best (score, index) pairs seen so far in a bounded min-heap.
+// Higher scores win; equal scores go to the lower index, so the selection
+// does not depend on the order candidates are offered in.
+class TopKSelector {
+public:
+    struct Entry {
+        double score;
+        size_t index;
+    };
+
+    explicit TopKSelector(size_t k);
+
+    // Returns true if the candidate was kept; when full, that replaces worst()
+    bool offer(double score, size_t index);
+    bool wouldAccept(double score, size_t index) const;
+    void merge(const TopKSelector& other);
+
+    size_t size() const { return heap_.size(); }
+    size_t capacity() const { return k_; }
+    bool full() const { return heap_.size() >= k_; }
+
+    // Lowest retained entry; only meaningful when !empty()
+    const Entry& worst() const { return heap_.front(); }
+    bool empty() const { return heap_.empty(); }
+
+    // Best first; leaves the selector empty
+    std::vector<Entry> take();
+
+    static bool isBetter(const Entry& a, const Entry& b) {
+        return a.score != b.score ? a.score > b.score : a.index < b.index;
+    }
+
+private:
+    size_t k_;
+    std::vector<Entry> heap_;
+};
\ No newline at end of file
@@ -0,0 +1,131 @@
+#pragma once
+#include "ConfigManager.h"
+#include "Preferences.h"
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Per-user configs for a process that serves many users, stored one file per
+// user (<directory>/<user_id>.json). Nothing is read up front: a user's file is
+// parsed, validated and compiled into Preferences on first access, then kept in
+// an LRU cache under a memory cap. Users hash onto independently locked shards,
+// so a cached lookup only contends with lookups of users on the same shard.
+// Concurrent misses for one user share a single parse of the file.
+//
+// put() updates the cache immediately and marks the user dirty; dirty configs
+// are written back in batches by a background thread every flush_interval, and
+// on flush() or destruction. A dirty entry is never lost to eviction.
+class UserConfigStore {
+public:
+    struct Options {
+        std::string directory = "config/users";
+        size_t max_bytes = 64 * 1024 * 1024;
+        size_t shard_count = 16;
+        // Zero disables the background writer; call flush() instead
+        std::chrono::milliseconds flush_interval{1000};
+    };
+
+    // Immutable once cached; held entries stay valid after eviction or put()
+    struct Entry {
+        UserConfig config;
+        Preferences preferences;
+    };
+
+    struct Stats {
+        size_t hits;
+        size_t loads;
+        size_t load_failures;
+        size_t evictions;
+        size_t writes;
+        size_t write_failures;
+        size_t cached_entries;
+        size_t cached_bytes;
+        size_t dirty_entries;
+    };
+
+    UserConfigStore();
+    explicit UserConfigStore(const Options& options);
+    ~UserConfigStore();
+    UserConfigStore(const UserConfigStore&) = delete;
+    UserConfigStore& operator=(const UserConfigStore&) = delete;
+
+    // nullptr if the user has no config file or it fails to parse or validate
+    std::shared_ptr<const Entry> get(const std::string& user_id);
+    std::shared_ptr<const Entry> get(const std::string& user_id, std::string& error);
+
+    // Replaces the user's config if it validates; it reaches disk on the next flush
+    bool put(const std::string& user_id, const UserConfig& config, std::string& error);
+
+    // Writes every dirty config now; returns the number written
+    size_t flush();
+
+    Stats getStats() const;
+
+    // Returns false (leaving the system zone) if the config names an unknown time zone
+    static bool compilePreferences(const UserConfig& config, Preferences& preferences);
+    // Ids become file names, so only [A-Za-z0-9_.-] is accepted and no leading '.'
+    static bool isValidUserId(const std::string& user_id);
+
+private:
+    struct CachedEntry {
+        std::string user_id;
+        std::shared_ptr<const Entry> entry;
+        size_t bytes;
+    };
+
+    struct LoadResult {
+        std::shared_ptr<const Entry> entry;
+        std::string error;
+    };
+
+    // A parse in progress; misses for the same user wait on its result
+    struct Loading {
+        std::promise<LoadResult> promise;
+        std::shared_future<LoadResult> result{promise.get_future().share()};
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        std::list<CachedEntry> lru;
+        std::unordered_map<std::string, std::list<CachedEntry>::iterator> index;
+        // Written back on the next flush; also consulted on a cache miss
+        std::unordered_map<std::string, std::shared_ptr<const Entry>> dirty;
+        size_t bytes = 0;
+        // Dropped by put() so a load that raced with it is not cached over the newer config
+        std::unordered_map<std::string, std::shared_ptr<Loading>> loading;
+        size_t hits = 0;
+        size_t loads = 0;
+        size_t load_failures = 0;
+        size_t evictions = 0;
+        size_t writes = 0;
+        size_t write_failures = 0;
+    };
+
+    Options options_;
+    size_t shard_bytes_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+
+    // Serializes flushes so a config is never written by two threads at once
+    std::mutex flush_mutex_;
+    std::thread writer_;
+    std::mutex writer_mutex_;
+    std::condition_variable writer_wake_;
+    bool stopping_;
+
+    Shard& shardFor(const std::string& user_id);
+    void insertLocked(Shard& shard, const std::string& user_id, std::shared_ptr<const Entry> entry);
+    std::shared_ptr<const Entry> findLocked(Shard& shard, const std::string& user_id);
+    bool loadEntry(const std::string& user_id, std::shared_ptr<const Entry>& entry, std::string& error) const;
+    bool writeEntry(const std::string& user_id, const Entry& entry) const;
+    std::string pathFor(const std::string& user_id) const;
+    void runWriter();
+
+    static size_t estimateBytes(const Entry& entry);
+};
\ No newline at end of file
@@ -1,52 +1,260 @@
 #include "AIService.h"
+#include "SseParser.h"
 #include <curl/curl.h>
+#include <cmath>
+#include <random>
 #include <sstream>
 
 AIService::AIService(const std::string& api_key, const std::string& base_url)
-    : api_key_(api_key), base_url_(base_url) {
+    : api_key_(api_key), base_url_(base_url), transport_(HttpTransport::getShared()), rate_limiter_(std::make_shared<RateLimiter>()),
+      offline_mode_(false), counters_(std::make_shared<Counters>()) {
 }
 
-static size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* userp) {
-    userp->append((char*)contents, size * nmemb);
-    return size * nmemb;
+void AIService::setTransport(std::shared_ptr<HttpTransport> transport) {
+    transport_ = transport ? transport : HttpTransport::getShared();
+}
+
+void AIService::setRateLimiter(std::shared_ptr<RateLimiter> rate_limiter) {
+    rate_limiter_ = rate_limiter ? rate_limiter : std::make_shared<RateLimiter>();
+}
+
+AIService::RequestStats AIService::getRequestStats() const {
+    return {counters_->requests.load(), counters_->retries.load(), counters_->throttled.load(),
+            counters_->server_errors.load(), counters_->timeouts.load(), counters_->failures.load()};
+}
+
+bool AIService::isRetryable(const HttpTransport::Response& response) {
+    if (response.success) {
+        // 529 is Anthropic's "overloaded"
+        long status = response.status_code;
+        return status == 429 || status == 500 || status == 502 || status == 503 || status == 504 || status == 529;
+    }
+    switch (response.result) {
+        case CURLE_COULDNT_RESOLVE_HOST:
+        case CURLE_COULDNT_CONNECT:
+        case CURLE_OPERATION_TIMEDOUT:
+        case CURLE_SSL_CONNECT_ERROR:
+        case CURLE_SEND_ERROR:
+        case CURLE_RECV_ERROR:
+        case CURLE_GOT_NOTHING:
+        case CURLE_PARTIAL_FILE:
+        case CURLE_HTTP2:
+        case CURLE_HTTP2_STREAM:
+            return true;
+        default:
+            return false;
+    }
+}
+
+std::chrono::milliseconds AIService::backoffDelay(const RetryOptions& options, int retry) {
+    // Jitter spreads out the retries of requests that failed together
+    thread_local std::mt19937 random(std::random_device{}());
+    double cap = static_cast<double>(options.base_delay.count()) * std::ldexp(1.0, std::min(retry, 30));
+    cap = std::min(cap, static_cast<double>(options.max_delay.count()));
+    std::uniform_real_distribution<double> jitter(cap / 2, cap);
+    return std::chrono::milliseconds(static_cast<long long>(jitter(random)));
 }
 
 AIService::AIResponse AIService::makeRequest(const std::string& endpoint, const nlohmann::json& payload) {
-    CURL* curl;
-    CURLcode res;
-    std::string response_string;
+    // Waits on the asynchronous path so blocking callers get the same rate limiting and
+    // retries; must not be called from the transport's I/O thread
+    return toFuture([&](ResponseCallback on_complete) {
+        makeRequestAsync(endpoint, payload, std::move(on_complete));
+    }).get();
+}
+
+void AIService::makeRequestAsync(const std::string& endpoint, const nlohmann::json& payload,
+                                 ResponseCallback on_complete, CancelFlag cancel) {
+    HttpTransport::Request request{base_url_ + endpoint, buildHeaders(), payload.dump(), nullptr};
+    request.cancel = std::move(cancel);
+    size_t tokens = estimateRequestTokens(request.body, payload);
     
-    curl = curl_easy_init();
-    if (!curl) {
-        return {false, "", "Failed to initialize CURL"};
+    submitWithRetry(std::move(request), tokens, [on_complete](HttpTransport::Response response) {
+        on_complete(checkResponse(response.success, response.status_code,
+                                  std::move(response.body), response.error_message));
+    });
+}
+
+bool AIService::respondFromCache(const std::string& prompt, const ResponseCallback& on_complete) {
+    std::string content;
+    if (response_cache_ && response_cache_->lookup(getProviderName(), getModelName(), prompt, content)) {
+        on_complete({true, content, ""});
+        return true;
     }
     
-    std::string url = base_url_ + endpoint;
-    std::string json_data = payload.dump();
+    if (offline_mode_) {
+        on_complete({false, "", "Offline mode: no cached response for this prompt"});
+        return true;
+    }
     
-    struct curl_slist* headers = nullptr;
-    std::string auth_header = "Authorization: Bearer " + api_key_;
-    headers = curl_slist_append(headers, "Content-Type: application/json");
-    headers = curl_slist_append(headers, auth_header.c_str());
+    return false;
+}
+
+AIService::ResponseCallback AIService::storeInCache(const std::string& prompt, ResponseCallback on_complete) {
+    if (!response_cache_) {
+        return on_complete;
+    }
     
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, json_data.c_str());
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response_string);
+    auto response_cache = response_cache_;
+    auto provider = getProviderName();
+    auto model = getModelName();
+    return [response_cache, provider, model, prompt, on_complete](AIResponse response) {
+        if (response.success) {
+            response_cache->store(provider, model, prompt, response.content);
+        }
+        on_complete(std::move(response));
+    };
+}
+
+void AIService::makeStreamingRequestAsync(const std::string& endpoint, const nlohmann::json& payload,
+                                          StreamEventCallback on_event, ResponseCallback on_complete) {
+    auto parser = std::make_shared<SseParser>(std::move(on_event));
+    auto received = std::make_shared<bool>(false);
     
-    res = curl_easy_perform(curl);
+    HttpTransport::Request request{base_url_ + endpoint, buildHeaders(), payload.dump(),
+                                   [parser, received](const char* data, size_t size) {
+                                       *received = true;
+                                       parser->feed(data, size);
+                                       return true;
+                                   }};
+    request.headers.push_back("Accept: text/event-stream");
     
-    curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
+    // Once deltas have reached the caller a retry would repeat them
+    auto can_retry = [received]() { return !*received; };
+    size_t tokens = estimateRequestTokens(request.body, payload);
+    submitWithRetry(std::move(request), tokens, [parser, on_complete](HttpTransport::Response response) {
+        parser->finish();
+        
+        if (!response.success) {
+            on_complete({false, "", response.error_message});
+        } else if (response.status_code >= 400) {
+            on_complete({false, "", "HTTP " + std::to_string(response.status_code) + ": " + response.body});
+        } else {
+            on_complete({true, "", ""});
+        }
+    }, can_retry);
+}
+
+void AIService::submitWithRetry(HttpTransport::Request request, size_t tokens,
+                                HttpTransport::CompletionCallback on_complete,
+                                std::function<bool()> can_retry) {
+    struct Attempt {
+        HttpTransport::Request request;
+        size_t tokens;
+        HttpTransport::CompletionCallback on_complete;
+        std::function<bool()> can_retry;
+        // Weak so the last reference is never dropped on the transport's own I/O thread
+        std::weak_ptr<HttpTransport> transport;
+        std::shared_ptr<RateLimiter> rate_limiter;
+        std::shared_ptr<Counters> counters;
+        RetryOptions options;
+        int number;
+        
+        static void send(const std::shared_ptr<Attempt>& attempt) {
+            auto transport = attempt->transport.lock();
+            if (!transport) {
+                attempt->counters->failures++;
+                attempt->on_complete({false, 0, "", "HTTP transport is not running", CURLE_FAILED_INIT});
+                return;
+            }
+            const CancelFlag& cancel = attempt->request.cancel;
+            if (cancel && *cancel) {
+                attempt->on_complete({false, 0, "", "Request cancelled", CURLE_ABORTED_BY_CALLBACK});
+                return;
+            }
+            HttpTransport::Request request = attempt->request;
+            transport->submit(std::move(request), [attempt](HttpTransport::Response response) {
+                bool retryable = isRetryable(response);
+                bool throttled = response.success && response.status_code == 429;
+                bool server_error = response.success && !throttled && retryable;
+                bool timed_out = !response.success && response.result == CURLE_OPERATION_TIMEDOUT;
+                attempt->counters->throttled += throttled;
+                attempt->counters->server_errors += server_error;
+                attempt->counters->timeouts += timed_out;
+                
+                bool cancelled = attempt->request.cancel && *attempt->request.cancel;
+                if (!retryable || cancelled || attempt->number >= attempt->options.max_attempts ||
+                    (attempt->can_retry && !attempt->can_retry())) {
+                    if (!cancelled && (!response.success || response.status_code >= 400)) {
+                        attempt->counters->failures++;
+                    }
+                    attempt->on_complete(std::move(response));
+                    return;
+                }
+                
+                attempt->counters->retries++;
+                auto delay = std::max<std::chrono::milliseconds>(backoffDelay(attempt->options, attempt->number - 1),
+                                                                 response.retry_after);
+                auto resume_at = RateLimiter::Clock::now() + delay;
+                if (throttled) {
+                    // The whole account is over its limit, so hold every request, not just this one
+                    attempt->rate_limiter->pauseUntil(resume_at);
+                }
+                attempt->number++;
+                attempt->rate_limiter->acquire(attempt->tokens, [attempt]() { send(attempt); }, resume_at);
+            });
+        }
+    };
+    
+    request.connect_timeout = retry_options_.connect_timeout;
+    request.timeout = retry_options_.request_timeout;
+    auto attempt = std::make_shared<Attempt>(Attempt{std::move(request), tokens, std::move(on_complete),
+                                                     std::move(can_retry), transport_, rate_limiter_,
+                                                     counters_, retry_options_, 1});
+    counters_->requests++;
+    rate_limiter_->acquire(tokens, [attempt]() { Attempt::send(attempt); });
+}
+
+size_t AIService::estimateRequestTokens(const std::string& body, const nlohmann::json& payload) {
+    // Providers charge the prompt plus the largest completion the request allows;
+    // four bytes per token is close enough for budgeting
+    size_t tokens = body.size() / 4;
+    auto max_tokens = payload.find("max_tokens");
+    if (max_tokens != payload.end() && max_tokens->is_number_integer() && max_tokens->get<long long>() > 0) {
+        tokens += max_tokens->get<size_t>();
+    }
+    return tokens;
+}
+
+void AIService::streamRecommendEvents(const std::string& preferences, const std::string& available_events,
+                                      DeltaCallback on_delta, ResponseCallback on_complete) {
+    streamResponse(buildRecommendationPrompt(preferences, available_events),
+                   std::move(on_delta), std::move(on_complete));
+}
+
+std::string AIService::buildRecommendationPrompt(const std::string& preferences,
+                                                 const std::string& available_events) {
+    return "Based on these user preferences:\n" + preferences + 
+           "\n\nRecommend events from this list:\n" + available_events +
+           "\n\nProvide a ranked list with explanations.";
+}
+
+std::future<AIService::AIResponse> AIService::toFuture(const std::function<void(ResponseCallback)>& start) {
+    auto promise = std::make_shared<std::promise<AIResponse>>();
+    auto future = promise->get_future();
+    start([promise](AIResponse response) {
+        promise->set_value(std::move(response));
+    });
+    return future;
+}
+
+std::vector<std::string> AIService::buildHeaders() const {
+    return {"Content-Type: application/json", "Authorization: Bearer " + api_key_};
+}
+
+AIService::AIResponse AIService::checkResponse(bool transfer_ok, long status_code,
+                                               std::string body, const std::string& transfer_error) {
+    if (!transfer_ok) {
+        return {false, "", transfer_error};
+    }
     
-    if (res != CURLE_OK) {
-        return {false, "", curl_easy_strerror(res)};
+    if (status_code >= 400) {
+        return {false, "", "HTTP " + std::to_string(status_code) + ": " + body};
     }
     
     try {
-        auto response_json = nlohmann::json::parse(response_string);
-        return {true, response_string, ""};
+        auto response_json = nlohmann::json::parse(body);
+        return {true, std::move(body), ""};
     } catch (const std::exception& e) {
         return {false, "", "Failed to parse JSON response: " + std::string(e.what())};
     }
@@ -0,0 +1,120 @@
+#include "BatchScorer.h"
+#include <algorithm>
+
+BatchScorer::Profile BatchScorer::compile(const Preferences& preferences) {
+    Profile profile;
+    profile.preferences = &preferences;
+    profile.time_zone = &preferences.getTimeZone();
+    profile.has_location = !preferences.getLocation().empty();
+    profile.has_coordinates = preferences.hasCoordinates();
+
+    const auto& mask = preferences.getHourOfWeekMask();
+    profile.max_hour_score = 0.5;
+    for (size_t hour = 0; hour < HourOfWeekMask::HOURS_PER_WEEK; ++hour) {
+        profile.hour_scores[hour] = mask.test(hour) ? 1.0 : 0.5;
+        profile.max_hour_score = std::max(profile.max_hour_score, profile.hour_scores[hour]);
+    }
+    return profile;
+}
+
+void BatchScorer::loadTile(const EventStore& store, EventStore::EventId first, size_t count, Tile& tile) {
+    EventStore::EventId ids[TILE_SIZE];
+    count = std::min(count, TILE_SIZE);
+    for (size_t i = 0; i < count; ++i) {
+        ids[i] = first + static_cast<EventStore::EventId>(i);
+    }
+    loadTile(store, ids, count, tile);
+}
+
+void BatchScorer::loadTile(const EventStore& store, const EventStore::EventId* ids, size_t count, Tile& tile) {
+    const auto& start_times = store.getStartTimes();
+    const auto& location_ids = store.getLocationIds();
+
+    tile.store = &store;
+    tile.count = std::min(count, TILE_SIZE);
+
+    for (size_t i = 0; i < tile.count; ++i) {
+        EventStore::EventId id = ids[i];
+        tile.ids[i] = id;
+        tile.start_seconds[i] = TimeZone::toUnixSeconds(start_times[id]);
+        tile.located[i] = location_ids[id] != EventStore::NO_LOCATION;
+    }
+}
+
+void BatchScorer::scoreTile(const Tile& tile, const Profile& profile, double* out, bool* in_range) {
+    TimeZone::Cursor time_zone(*profile.time_zone);
+    double interest = 0.0;
+    int hour = 0;
+    double location = 0.0;
+    bool row_in_range = true;
+
+    for (size_t i = 0; i < tile.count; ++i) {
+        gatherRow(tile, i, profile, time_zone, interest, hour, location, row_in_range);
+        if (in_range) {
+            in_range[i] = row_in_range;
+        }
+        // Same operation order as calculateEventScore, so the result rounds identically
+        out[i] = (interest * 0.5) + (profile.hour_scores[hour] * 0.3) + (location * 0.2);
+    }
+}
+
+void BatchScorer::loadComponents(const Tile& tile, const Profile& profile, Components* out) {
+    TimeZone::Cursor time_zone(*profile.time_zone);
+    int hour = 0;
+    for (size_t i = 0; i < tile.count; ++i) {
+        gatherRow(tile, i, profile, time_zone, out[i].interest, hour, out[i].location, out[i].in_range);
+        out[i].time = profile.hour_scores[hour];
+    }
+}
+
+double BatchScorer::scoreInterest(const EventStore& store, EventStore::EventId id, const Profile& profile) {
+    double total_score = 0.0;
+    int matching_tags = 0;
+    int weight = 0;
+    bool global_tags = &store.getTagInterner() == &TagInterner::global();
+    
+    for (auto tag = store.tagsBegin(id); tag != store.tagsEnd(id); ++tag) {
+        bool found = false;
+        if (global_tags) {
+            found = profile.preferences->findInterest(*tag, weight);
+        } else {
+            const auto& interests = profile.preferences->getInterests();
+            auto it = interests.find(store.getTagInterner().getName(*tag));
+            if ((found = it != interests.end())) {
+                weight = it->second;
+            }
+        }
+        if (found) {
+            total_score += weight;
+            matching_tags++;
+        }
+    }
+    return matching_tags > 0 ? total_score / matching_tags : 0.0;
+}
+
+void BatchScorer::gatherRow(const Tile& tile, size_t i, const Profile& profile, TimeZone::Cursor& time_zone,
+                             double& interest, int& hour, double& location, bool& in_range) {
+    const EventStore& store = *tile.store;
+    EventStore::EventId id = tile.ids[i];
+
+    interest = scoreInterest(store, id, profile);
+    std::int64_t start = tile.start_seconds[i];
+    hour = static_cast<int>(HourOfWeekMask::hourOfWeek(start + time_zone.getOffset(start)));
+    if (profile.has_coordinates && store.getHasCoordinates()[id]) {
+        double distance = profile.preferences->getTravelDistanceKm(store.getCoordinates()[id]);
+        location = profile.preferences->getProximityScore(distance);
+        in_range = profile.preferences->isWithinTravelDistance(distance);
+    } else {
+        location = tile.located[i] && profile.has_location ? 1.0 : 0.8;
+        in_range = true;
+    }
+}
+
+void BatchScorer::scoreBlock(const EventStore& store, EventStore::EventId first, size_t count,
+                             const Profile& profile, double* out) {
+    Tile tile;
+    for (size_t done = 0; done < count; done += TILE_SIZE) {
+        loadTile(store, first + static_cast<EventStore::EventId>(done), count - done, tile);
+        scoreTile(tile, profile, out + done);
+    }
+}
\ No newline at end of file
@@ -1,36 +1,49 @@
 #include "ClaudeService.h"
-#include <thread>
 
 const std::string ClaudeService::CLAUDE_BASE_URL = "https://api.anthropic.com/v1";
 const std::string ClaudeService::MODEL_NAME = "claude-3-sonnet-20240229";
 
-ClaudeService::ClaudeService(const std::string& api_key) 
+ClaudeService::ClaudeService(const std::string& api_key)
     : AIService(api_key, CLAUDE_BASE_URL) {
 }
 
 std::future<AIService::AIResponse> ClaudeService::generateResponse(const std::string& prompt) {
-    return std::async(std::launch::async, [this, prompt]() {
-        nlohmann::json payload = {
-            {"model", MODEL_NAME},
-            {"max_tokens", 1000},
-            {"messages", nlohmann::json::array({
-                {{"role", "user"}, {"content", prompt}}
-            })}
-        };
-        
-        auto response = makeRequest("/messages", payload);
+    return toFuture([this, prompt](ResponseCallback on_complete) {
+        generateResponse(prompt, std::move(on_complete));
+    });
+}
+
+void ClaudeService::generateResponse(const std::string& prompt, ResponseCallback on_complete,
+                                     CancelFlag cancel) {
+    if (respondFromCache(prompt, on_complete)) {
+        return;
+    }
+    on_complete = storeInCache(prompt, std::move(on_complete));
+    
+    nlohmann::json payload = {
+        {"model", MODEL_NAME},
+        {"max_tokens", 1000},
+        {"messages", nlohmann::json::array({
+            {{"role", "user"}, {"content", prompt}}
+        })}
+    };
+    
+    makeRequestAsync("/messages", payload, [on_complete](AIResponse response) {
         if (!response.success) {
-            return response;
+            on_complete(std::move(response));
+            return;
         }
         
+        AIResponse result;
         try {
             auto json_response = nlohmann::json::parse(response.content);
             std::string content = json_response["content"][0]["text"];
-            return AIResponse{true, content, ""};
+            result = AIResponse{true, content, ""};
         } catch (const std::exception& e) {
-            return AIResponse{false, "", "Failed to parse Claude response: " + std::string(e.what())};
+            result = AIResponse{false, "", "Failed to parse Claude response: " + std::string(e.what())};
         }
-    });
+        on_complete(std::move(result));
+    }, std::move(cancel));
 }
 
 std::future<AIService::AIResponse> ClaudeService::analyzePreferences(const std::string& user_data) {
@@ -41,9 +54,61 @@ std::future<AIService::AIResponse> ClaudeService::analyzePreferences(const std::
 std::future<AIService::AIResponse> ClaudeService::recommendEvents(
     const std::string& preferences, 
     const std::string& available_events) {
+    return generateResponse(buildRecommendationPrompt(preferences, available_events));
+}
+
+void ClaudeService::streamResponse(const std::string& prompt, DeltaCallback on_delta,
+                                   ResponseCallback on_complete) {
+    auto replay_cached = [on_delta, on_complete](AIResponse response) {
+        if (response.success) {
+            on_delta(response.content);
+        }
+        on_complete(std::move(response));
+    };
+    if (respondFromCache(prompt, replay_cached)) {
+        return;
+    }
+    on_complete = storeInCache(prompt, std::move(on_complete));
     
-    std::string prompt = "Based on these user preferences:\n" + preferences + 
-                        "\n\nRecommend events from this list:\n" + available_events +
-                        "\n\nProvide a ranked list with explanations.";
-    return generateResponse(prompt);
+    nlohmann::json payload = {
+        {"model", MODEL_NAME},
+        {"stream", true},
+        {"max_tokens", 1000},
+        {"messages", nlohmann::json::array({
+            {{"role", "user"}, {"content", prompt}}
+        })}
+    };
+    
+    auto text = std::make_shared<std::string>();
+    auto stream_error = std::make_shared<std::string>();
+    
+    makeStreamingRequestAsync("/messages", payload,
+        [on_delta, text, stream_error](const std::string& event, const std::string& data) {
+            if (event == "error") {
+                *stream_error = data;
+                return;
+            }
+            if (event != "content_block_delta") {
+                return;
+            }
+            
+            try {
+                auto json_event = nlohmann::json::parse(data);
+                std::string delta = json_event["delta"].value("text", "");
+                if (!delta.empty()) {
+                    *text += delta;
+                    on_delta(delta);
+                }
+            } catch (const std::exception& e) {
+                *stream_error = "Failed to parse Claude stream event: " + std::string(e.what());
+            }
+        },
+        [on_complete, text, stream_error](AIResponse response) {
+            if (response.success && !stream_error->empty()) {
+                response = AIResponse{false, "", "Claude stream error: " + *stream_error};
+            } else if (response.success) {
+                response.content = *text;
+            }
+            on_complete(std::move(response));
+        });
 }
\ No newline at end of file
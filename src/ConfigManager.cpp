@@ -1,11 +1,14 @@
 #include "ConfigManager.h"
+#include "HourOfWeekMask.h"
 #include <fstream>
 #include <filesystem>
 #include <iostream>
+#include <stdexcept>
 
 ConfigManager::ConfigManager(const std::string& config_file_path)
-    : config_file_path_(config_file_path) {
+    : config_file_path_(config_file_path), reload_stats_{0, 0, std::chrono::microseconds(0), {}} {
     setDefaults();
+    publishConfig();
 }
 
 bool ConfigManager::loadConfig() {
@@ -14,31 +17,86 @@ bool ConfigManager::loadConfig() {
         return createDefaultConfig();
     }
     
+    UserConfig config;
+    std::vector<std::string> errors;
+    if (!readConfigFile(config, errors)) {
+        std::cerr << "Failed to load config: " << config_file_path_ << std::endl;
+        for (const auto& error : errors) {
+            std::cerr << "  - " << error << std::endl;
+        }
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    config_ = config;
+    std::atomic_store(&snapshot_, std::shared_ptr<const UserConfig>(std::make_shared<UserConfig>(config_)));
+    return true;
+}
+
+void ConfigManager::publishConfig() {
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    std::atomic_store(&snapshot_, std::shared_ptr<const UserConfig>(std::make_shared<UserConfig>(config_)));
+}
+
+bool ConfigManager::reloadConfig() {
+    auto started = std::chrono::steady_clock::now();
+    
+    // Parsing and validation happen before the swap, so readers only ever see a complete, valid config
+    auto config = std::make_shared<UserConfig>();
+    std::vector<std::string> errors;
+    bool loaded = readConfigFile(*config, errors);
+    
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    if (loaded) {
+        config_ = *config;
+        std::atomic_store(&snapshot_, std::shared_ptr<const UserConfig>(std::move(config)));
+    }
+    reload_stats_.reloads++;
+    if (!loaded) {
+        reload_stats_.failures++;
+    }
+    reload_stats_.last_latency =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started);
+    reload_stats_.last_errors = std::move(errors);
+    return loaded;
+}
+
+UserConfig ConfigManager::getConfig() const {
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    return config_;
+}
+
+std::string ConfigManager::resolvePath(const std::string& path) const {
+    std::filesystem::path resolved(path);
+    if (resolved.is_absolute()) {
+        return path;
+    }
+    return (std::filesystem::path(config_file_path_).parent_path() / resolved).lexically_normal().string();
+}
+
+ConfigManager::ReloadStats ConfigManager::getReloadStats() const {
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    return reload_stats_;
+}
+
+bool ConfigManager::readConfigFile(UserConfig& config, std::vector<std::string>& errors) const {
     try {
         std::ifstream file(config_file_path_);
         if (!file.is_open()) {
-            std::cerr << "Failed to open config file: " << config_file_path_ << std::endl;
+            errors.push_back("Failed to open config file: " + config_file_path_);
             return false;
         }
         
         nlohmann::json j;
         file >> j;
-        config_ = fromJson(j);
-        
-        if (!validateConfig()) {
-            std::cerr << "Invalid configuration detected" << std::endl;
-            auto errors = getValidationErrors();
-            for (const auto& error : errors) {
-                std::cerr << "  - " << error << std::endl;
-            }
-            return false;
-        }
-        
-        return true;
+        config = fromJson(j);
     } catch (const std::exception& e) {
-        std::cerr << "Failed to load config: " << e.what() << std::endl;
+        errors.push_back(e.what());
         return false;
     }
+    
+    errors = getValidationErrors(config);
+    return errors.empty();
 }
 
 bool ConfigManager::saveConfig() const {
@@ -53,7 +111,11 @@ bool ConfigManager::saveConfig() const {
             return false;
         }
         
-        nlohmann::json j = toJson(config_);
+        nlohmann::json j;
+        {
+            std::lock_guard<std::mutex> lock(config_mutex_);
+            j = toJson(config_);
+        }
         file << j.dump(2);  // Pretty print with 2-space indentation
         
         return true;
@@ -69,8 +131,11 @@ bool ConfigManager::createDefaultConfig() const {
         std::filesystem::create_directories(config_path.parent_path());
         
         // Create default config with placeholder values
-        UserConfig default_config = config_;  // Use current defaults
-        nlohmann::json j = toJson(default_config);
+        nlohmann::json j;
+        {
+            std::lock_guard<std::mutex> lock(config_mutex_);
+            j = toJson(config_);  // Use current defaults
+        }
         
         std::ofstream file(config_file_path_);
         if (!file.is_open()) {
@@ -90,16 +155,19 @@ bool ConfigManager::createDefaultConfig() const {
 }
 
 void ConfigManager::setUserProfile(const std::string& name, const std::string& email, const std::string& phone) {
+    std::lock_guard<std::mutex> lock(config_mutex_);
     config_.name = name;
     config_.email = email;
     config_.phone_number = phone;
 }
 
 void ConfigManager::setLocation(const UserLocation& location) {
+    std::lock_guard<std::mutex> lock(config_mutex_);
     config_.location = location;
 }
 
 void ConfigManager::setAIProvider(const std::string& provider, const std::string& api_key) {
+    std::lock_guard<std::mutex> lock(config_mutex_);
     config_.default_ai_provider = provider;
     if (provider == "openai") {
         config_.openai_config.api_key = api_key;
@@ -109,14 +177,17 @@ void ConfigManager::setAIProvider(const std::string& provider, const std::string
 }
 
 void ConfigManager::addInterest(const std::string& interest, int weight) {
+    std::lock_guard<std::mutex> lock(config_mutex_);
     config_.interests[interest] = weight;
 }
 
 void ConfigManager::removeInterest(const std::string& interest) {
+    std::lock_guard<std::mutex> lock(config_mutex_);
     config_.interests.erase(interest);
 }
 
 void ConfigManager::updateNotificationSettings(const NotificationSettings& settings) {
+    std::lock_guard<std::mutex> lock(config_mutex_);
     config_.notifications = settings;
 }
 
@@ -125,236 +196,76 @@ bool ConfigManager::validateConfig() const {
 }
 
 std::vector<std::string> ConfigManager::getValidationErrors() const {
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    return getValidationErrors(config_);
+}
+
+std::vector<std::string> ConfigManager::getValidationErrors(const UserConfig& config) {
     std::vector<std::string> errors;
     
-    if (config_.name.empty()) {
+    if (config.name.empty()) {
         errors.push_back("Name cannot be empty");
     }
     
-    if (config_.email.empty() || config_.email.find('@') == std::string::npos) {
+    if (config.email.empty() || config.email.find('@') == std::string::npos) {
         errors.push_back("Valid email address required");
     }
     
-    if (config_.default_ai_provider != "openai" && config_.default_ai_provider != "claude") {
+    if (config.default_ai_provider != "openai" && config.default_ai_provider != "claude") {
         errors.push_back("Default AI provider must be 'openai' or 'claude'");
     }
     
-    if (config_.default_ai_provider == "openai" && config_.openai_config.api_key.empty()) {
+    if (config.default_ai_provider == "openai" && config.openai_config.api_key.empty()) {
         errors.push_back("OpenAI API key required when using OpenAI as default provider");
     }
     
-    if (config_.default_ai_provider == "claude" && config_.claude_config.api_key.empty()) {
+    if (config.default_ai_provider == "claude" && config.claude_config.api_key.empty()) {
         errors.push_back("Claude API key required when using Claude as default provider");
     }
     
-    if (config_.max_travel_distance_km <= 0) {
-        errors.push_back("Max travel distance must be positive");
+    for (const auto* service : {&config.openai_config, &config.claude_config}) {
+        if (service->requests_per_minute < 0 || service->tokens_per_minute < 0) {
+            errors.push_back("AI service rate limits cannot be negative");
+            break;
+        }
     }
     
-    return errors;
-}
-
-UserConfig ConfigManager::fromJson(const nlohmann::json& j) {
-    UserConfig config;
-    
-    // User Profile
-    auto user_profile = j["user_profile"];
-    config.name = user_profile["name"];
-    config.email = user_profile["email"];
-    config.phone_number = user_profile["phone_number"];
-    config.date_of_birth = user_profile["date_of_birth"];
-    config.preferred_language = user_profile["preferred_language"];
-    
-    // Location
-    auto location = user_profile["location"];
-    config.location.address = location["address"];
-    config.location.city = location["city"];
-    config.location.state = location["state"];
-    config.location.country = location["country"];
-    config.location.timezone = location["timezone"];
-    config.location.latitude = location["coordinates"]["latitude"];
-    config.location.longitude = location["coordinates"]["longitude"];
-    
-    // AI Services
-    auto ai_services = j["ai_services"];
-    config.default_ai_provider = ai_services["default_provider"];
-    
-    auto openai = ai_services["openai"];
-    config.openai_config.api_key = openai["api_key"];
-    config.openai_config.model = openai["model"];
-    config.openai_config.max_tokens = openai["max_tokens"];
-    config.openai_config.temperature = openai["temperature"];
-    
-    auto claude = ai_services["claude"];
-    config.claude_config.api_key = claude["api_key"];
-    config.claude_config.model = claude["model"];
-    config.claude_config.max_tokens = claude["max_tokens"];
-    config.claude_config.temperature = 0.7; // Default for Claude
-    
-    // Preferences
-    auto preferences = j["preferences"];
-    config.interests = preferences["interests"];
-    config.max_travel_distance_km = preferences["max_travel_distance_km"];
-    config.preferred_transportation = preferences["preferred_transportation"];
-    config.accessibility_needs = preferences["accessibility_needs"];
-    config.dietary_restrictions = preferences["dietary_restrictions"];
-    
-    // Time slots
-    for (const auto& slot : preferences["preferred_time_slots"]) {
-        TimeSlot ts;
-        ts.start_hour = slot["start_hour"];
-        ts.end_hour = slot["end_hour"];
-        ts.days = slot["days"];
-        config.preferred_time_slots.push_back(ts);
+    if (config.connection_pool.max_connections <= 0) {
+        errors.push_back("Connection pool size must be positive");
     }
     
-    // Budget
-    auto budget = preferences["budget_limits"];
-    config.budget_limits.daily = budget["daily"];
-    config.budget_limits.weekly = budget["weekly"];
-    config.budget_limits.monthly = budget["monthly"];
-    config.budget_limits.currency = budget["currency"];
+    if (config.connection_pool.idle_timeout_seconds < 0) {
+        errors.push_back("Connection idle timeout cannot be negative");
+    }
     
-    // Notifications
-    auto notifications = j["notification_settings"];
-    config.notifications.email_notifications = notifications["email_notifications"];
-    config.notifications.sms_notifications = notifications["sms_notifications"];
-    config.notifications.push_notifications = notifications["push_notifications"];
-    config.notifications.daily_recommendations_time = notifications["notification_times"]["daily_recommendations"];
-    config.notifications.event_reminder_minutes = notifications["notification_times"]["event_reminders"];
-    config.notifications.weekly_summary_time = notifications["notification_times"]["weekly_summary"];
-    config.notifications.quiet_hours_enabled = notifications["quiet_hours"]["enabled"];
-    config.notifications.quiet_hours_start = notifications["quiet_hours"]["start_time"];
-    config.notifications.quiet_hours_end = notifications["quiet_hours"]["end_time"];
+    if (config.max_travel_distance_km <= 0) {
+        errors.push_back("Max travel distance must be positive");
+    }
     
-    // Privacy
-    auto privacy = j["privacy_settings"];
-    config.analytics_sharing = privacy["data_sharing"]["analytics"];
-    config.third_party_sharing = privacy["data_sharing"]["third_party"];
-    config.marketing_sharing = privacy["data_sharing"]["marketing"];
-    config.location_tracking = privacy["location_tracking"];
-    config.activity_logging = privacy["activity_logging"];
-    config.data_retention_days = privacy["data_retention_days"];
+    for (size_t i = 0; i < config.preferred_time_slots.size(); ++i) {
+        const auto& days = config.preferred_time_slots[i].days;
+        if (!days.empty() && HourOfWeekMask::parseDays(days) == 0) {
+            errors.push_back("preferences.preferred_time_slots[" + std::to_string(i) + "].days: no recognized day names");
+        }
+    }
     
-    // App Settings
-    auto app = j["app_settings"];
-    config.theme = app["theme"];
-    config.date_format = app["date_format"];
-    config.time_format = app["time_format"];
-    config.first_day_of_week = app["first_day_of_week"];
-    config.auto_sync = app["auto_sync"];
-    config.sync_interval_minutes = app["sync_interval_minutes"];
-    config.offline_mode = app["offline_mode"];
-    config.cache_size_mb = app["cache_size_mb"];
-    config.log_level = app["log_level"];
+    if (config.scoring_threads < 0) {
+        errors.push_back("Scoring thread count cannot be negative");
+    }
     
-    // Advanced Settings
-    auto advanced = j["advanced_settings"];
-    config.recommendation_algorithm = advanced["recommendation_algorithm"];
-    config.learning_rate = advanced["learning_rate"];
-    config.diversity_factor = advanced["diversity_factor"];
-    config.novelty_boost = advanced["novelty_boost"];
-    config.popularity_weight = advanced["popularity_weight"];
-    config.recency_bias = advanced["recency_bias"];
-    config.max_recommendations_per_day = advanced["max_recommendations_per_day"];
-    config.min_recommendation_score = advanced["min_recommendation_score"];
+    if (config.cache_directory.empty()) {
+        errors.push_back("Cache directory cannot be empty");
+    }
     
-    return config;
+    return errors;
+}
+
+UserConfig ConfigManager::fromJson(const nlohmann::json& j) {
+    return j.get<UserConfig>();
 }
 
 nlohmann::json ConfigManager::toJson(const UserConfig& config) {
-    nlohmann::json j;
-    
-    // User Profile
-    j["user_profile"]["name"] = config.name;
-    j["user_profile"]["email"] = config.email;
-    j["user_profile"]["phone_number"] = config.phone_number;
-    j["user_profile"]["date_of_birth"] = config.date_of_birth;
-    j["user_profile"]["preferred_language"] = config.preferred_language;
-    
-    // Location
-    j["user_profile"]["location"]["address"] = config.location.address;
-    j["user_profile"]["location"]["city"] = config.location.city;
-    j["user_profile"]["location"]["state"] = config.location.state;
-    j["user_profile"]["location"]["country"] = config.location.country;
-    j["user_profile"]["location"]["timezone"] = config.location.timezone;
-    j["user_profile"]["location"]["coordinates"]["latitude"] = config.location.latitude;
-    j["user_profile"]["location"]["coordinates"]["longitude"] = config.location.longitude;
-    
-    // AI Services
-    j["ai_services"]["default_provider"] = config.default_ai_provider;
-    j["ai_services"]["openai"]["api_key"] = config.openai_config.api_key;
-    j["ai_services"]["openai"]["model"] = config.openai_config.model;
-    j["ai_services"]["openai"]["max_tokens"] = config.openai_config.max_tokens;
-    j["ai_services"]["openai"]["temperature"] = config.openai_config.temperature;
-    j["ai_services"]["claude"]["api_key"] = config.claude_config.api_key;
-    j["ai_services"]["claude"]["model"] = config.claude_config.model;
-    j["ai_services"]["claude"]["max_tokens"] = config.claude_config.max_tokens;
-    
-    // Preferences
-    j["preferences"]["interests"] = config.interests;
-    j["preferences"]["max_travel_distance_km"] = config.max_travel_distance_km;
-    j["preferences"]["preferred_transportation"] = config.preferred_transportation;
-    j["preferences"]["accessibility_needs"] = config.accessibility_needs;
-    j["preferences"]["dietary_restrictions"] = config.dietary_restrictions;
-    
-    // Time slots
-    j["preferences"]["preferred_time_slots"] = nlohmann::json::array();
-    for (const auto& slot : config.preferred_time_slots) {
-        nlohmann::json slot_json;
-        slot_json["start_hour"] = slot.start_hour;
-        slot_json["end_hour"] = slot.end_hour;
-        slot_json["days"] = slot.days;
-        j["preferences"]["preferred_time_slots"].push_back(slot_json);
-    }
-    
-    // Budget
-    j["preferences"]["budget_limits"]["daily"] = config.budget_limits.daily;
-    j["preferences"]["budget_limits"]["weekly"] = config.budget_limits.weekly;
-    j["preferences"]["budget_limits"]["monthly"] = config.budget_limits.monthly;
-    j["preferences"]["budget_limits"]["currency"] = config.budget_limits.currency;
-    
-    // Notifications
-    j["notification_settings"]["email_notifications"] = config.notifications.email_notifications;
-    j["notification_settings"]["sms_notifications"] = config.notifications.sms_notifications;
-    j["notification_settings"]["push_notifications"] = config.notifications.push_notifications;
-    j["notification_settings"]["notification_times"]["daily_recommendations"] = config.notifications.daily_recommendations_time;
-    j["notification_settings"]["notification_times"]["event_reminders"] = config.notifications.event_reminder_minutes;
-    j["notification_settings"]["notification_times"]["weekly_summary"] = config.notifications.weekly_summary_time;
-    j["notification_settings"]["quiet_hours"]["enabled"] = config.notifications.quiet_hours_enabled;
-    j["notification_settings"]["quiet_hours"]["start_time"] = config.notifications.quiet_hours_start;
-    j["notification_settings"]["quiet_hours"]["end_time"] = config.notifications.quiet_hours_end;
-    
-    // Privacy
-    j["privacy_settings"]["data_sharing"]["analytics"] = config.analytics_sharing;
-    j["privacy_settings"]["data_sharing"]["third_party"] = config.third_party_sharing;
-    j["privacy_settings"]["data_sharing"]["marketing"] = config.marketing_sharing;
-    j["privacy_settings"]["location_tracking"] = config.location_tracking;
-    j["privacy_settings"]["activity_logging"] = config.activity_logging;
-    j["privacy_settings"]["data_retention_days"] = config.data_retention_days;
-    
-    // App Settings
-    j["app_settings"]["theme"] = config.theme;
-    j["app_settings"]["date_format"] = config.date_format;
-    j["app_settings"]["time_format"] = config.time_format;
-    j["app_settings"]["first_day_of_week"] = config.first_day_of_week;
-    j["app_settings"]["auto_sync"] = config.auto_sync;
-    j["app_settings"]["sync_interval_minutes"] = config.sync_interval_minutes;
-    j["app_settings"]["offline_mode"] = config.offline_mode;
-    j["app_settings"]["cache_size_mb"] = config.cache_size_mb;
-    j["app_settings"]["log_level"] = config.log_level;
-    
-    // Advanced Settings
-    j["advanced_settings"]["recommendation_algorithm"] = config.recommendation_algorithm;
-    j["advanced_settings"]["learning_rate"] = config.learning_rate;
-    j["advanced_settings"]["diversity_factor"] = config.diversity_factor;
-    j["advanced_settings"]["novelty_boost"] = config.novelty_boost;
-    j["advanced_settings"]["popularity_weight"] = config.popularity_weight;
-    j["advanced_settings"]["recency_bias"] = config.recency_bias;
-    j["advanced_settings"]["max_recommendations_per_day"] = config.max_recommendations_per_day;
-    j["advanced_settings"]["min_recommendation_score"] = config.min_recommendation_score;
-    
-    return j;
+    return config;
 }
 
 void ConfigManager::setDefaults() {
@@ -375,8 +286,9 @@ void ConfigManager::setDefaults() {
     
     // Default AI settings
     config_.default_ai_provider = "openai";
-    config_.openai_config = {"", "gpt-3.5-turbo", 1000, 0.7};
-    config_.claude_config = {"", "claude-3-sonnet-20240229", 1000, 0.7};
+    config_.openai_config = {"", "gpt-3.5-turbo", 1000, 0.7, 0, 0};
+    config_.claude_config = {"", "claude-3-sonnet-20240229", 1000, 0.7, 0, 0};
+    config_.connection_pool = {8, 60};
     
     // Default preferences
     config_.max_travel_distance_km = 25.0;
@@ -413,6 +325,8 @@ void ConfigManager::setDefaults() {
     config_.sync_interval_minutes = 30;
     config_.offline_mode = false;
     config_.cache_size_mb = 100;
+    config_.cache_ttl_hours = 24;
+    config_.cache_directory = "cache/ai_responses";
     config_.log_level = "info";
     
     // Default advanced settings
@@ -424,8 +338,354 @@ void ConfigManager::setDefaults() {
     config_.recency_bias = 0.8;
     config_.max_recommendations_per_day = 10;
     config_.min_recommendation_score = 0.6;
+    config_.prompt_token_budget = 2000;
+    config_.scoring_threads = 1;
 }
 
 bool ConfigManager::fileExists(const std::string& path) const {
     return std::filesystem::exists(path);
+}
+
+namespace {
+    // Path of the value being read (e.g. "preferences.preferred_time_slots[1].days"),
+    // extended by every nested read so errors can name the offending key
+    thread_local std::vector<std::string> read_path;
+
+    class PathScope {
+    public:
+        explicit PathScope(std::string segment) { read_path.push_back(std::move(segment)); }
+        ~PathScope() { read_path.pop_back(); }
+    };
+
+    std::string currentPath() {
+        std::string path;
+        for (const auto& segment : read_path) {
+            if (!path.empty() && segment[0] != '[') {
+                path += '.';
+            }
+            path += segment;
+        }
+        return path.empty() ? "<root>" : path;
+    }
+
+    void requireObject(const nlohmann::json& value) {
+        if (!value.is_object()) {
+            throw std::runtime_error(currentPath() + ": expected an object, got " + value.type_name());
+        }
+    }
+
+    // Required object member; the caller's PathScope already names it
+    const nlohmann::json& objectAt(const nlohmann::json& parent, const char* key) {
+        auto it = parent.find(key);
+        if (it == parent.end()) {
+            throw std::runtime_error("Missing config key: " + currentPath());
+        }
+        requireObject(*it);
+        return *it;
+    }
+
+    template <typename T>
+    void readField(const nlohmann::json& object, const char* key, T& value) {
+        PathScope scope(key);
+        auto it = object.find(key);
+        if (it == object.end()) {
+            throw std::runtime_error("Missing config key: " + currentPath());
+        }
+        try {
+            it->get_to(value);
+        } catch (const nlohmann::json::type_error& e) {
+            throw std::runtime_error(currentPath() + ": " + e.what());
+        }
+    }
+
+    // Optional member: absent keys take the fallback
+    template <typename T>
+    void readField(const nlohmann::json& object, const char* key, T& value, const T& fallback) {
+        if (object.find(key) == object.end()) {
+            value = fallback;
+            return;
+        }
+        readField(object, key, value);
+    }
+}
+
+void to_json(nlohmann::json& j, const UserLocation& location) {
+    j = {
+        {"address", location.address},
+        {"city", location.city},
+        {"state", location.state},
+        {"country", location.country},
+        {"timezone", location.timezone},
+        {"coordinates", {{"latitude", location.latitude}, {"longitude", location.longitude}}}
+    };
+}
+
+void from_json(const nlohmann::json& j, UserLocation& location) {
+    requireObject(j);
+    readField(j, "address", location.address);
+    readField(j, "city", location.city);
+    readField(j, "state", location.state);
+    readField(j, "country", location.country);
+    readField(j, "timezone", location.timezone);
+    
+    PathScope scope("coordinates");
+    const auto& coordinates = objectAt(j, "coordinates");
+    readField(coordinates, "latitude", location.latitude);
+    readField(coordinates, "longitude", location.longitude);
+}
+
+void to_json(nlohmann::json& j, const TimeSlot& slot) {
+    j = {{"start_hour", slot.start_hour}, {"end_hour", slot.end_hour}, {"days", slot.days}};
+}
+
+void from_json(const nlohmann::json& j, TimeSlot& slot) {
+    requireObject(j);
+    readField(j, "start_hour", slot.start_hour);
+    readField(j, "end_hour", slot.end_hour);
+    readField(j, "days", slot.days);
+    
+    // A slot that names no real day would never match anything
+    if (!slot.days.empty() && HourOfWeekMask::parseDays(slot.days) == 0) {
+        PathScope scope("days");
+        throw std::runtime_error(currentPath() + ": no recognized day names");
+    }
+}
+
+void to_json(nlohmann::json& j, const BudgetLimits& budget) {
+    j = {{"daily", budget.daily}, {"weekly", budget.weekly}, {"monthly", budget.monthly}, {"currency", budget.currency}};
+}
+
+void from_json(const nlohmann::json& j, BudgetLimits& budget) {
+    requireObject(j);
+    readField(j, "daily", budget.daily);
+    readField(j, "weekly", budget.weekly);
+    readField(j, "monthly", budget.monthly);
+    readField(j, "currency", budget.currency);
+}
+
+void to_json(nlohmann::json& j, const NotificationSettings& settings) {
+    j = {
+        {"email_notifications", settings.email_notifications},
+        {"sms_notifications", settings.sms_notifications},
+        {"push_notifications", settings.push_notifications},
+        {"notification_times", {
+            {"daily_recommendations", settings.daily_recommendations_time},
+            {"event_reminders", settings.event_reminder_minutes},
+            {"weekly_summary", settings.weekly_summary_time}
+        }},
+        {"quiet_hours", {
+            {"enabled", settings.quiet_hours_enabled},
+            {"start_time", settings.quiet_hours_start},
+            {"end_time", settings.quiet_hours_end}
+        }}
+    };
+}
+
+void from_json(const nlohmann::json& j, NotificationSettings& settings) {
+    requireObject(j);
+    readField(j, "email_notifications", settings.email_notifications);
+    readField(j, "sms_notifications", settings.sms_notifications);
+    readField(j, "push_notifications", settings.push_notifications);
+    {
+        PathScope scope("notification_times");
+        const auto& times = objectAt(j, "notification_times");
+        readField(times, "daily_recommendations", settings.daily_recommendations_time);
+        readField(times, "event_reminders", settings.event_reminder_minutes);
+        readField(times, "weekly_summary", settings.weekly_summary_time);
+    }
+    {
+        PathScope scope("quiet_hours");
+        const auto& quiet_hours = objectAt(j, "quiet_hours");
+        readField(quiet_hours, "enabled", settings.quiet_hours_enabled);
+        readField(quiet_hours, "start_time", settings.quiet_hours_start);
+        readField(quiet_hours, "end_time", settings.quiet_hours_end);
+    }
+}
+
+void to_json(nlohmann::json& j, const AIServiceConfig& service) {
+    j = {
+        {"api_key", service.api_key},
+        {"model", service.model},
+        {"max_tokens", service.max_tokens},
+        {"temperature", service.temperature},
+        {"requests_per_minute", service.requests_per_minute},
+        {"tokens_per_minute", service.tokens_per_minute}
+    };
+}
+
+void from_json(const nlohmann::json& j, AIServiceConfig& service) {
+    requireObject(j);
+    readField(j, "api_key", service.api_key);
+    readField(j, "model", service.model);
+    readField(j, "max_tokens", service.max_tokens);
+    readField(j, "temperature", service.temperature, 0.7);
+    readField(j, "requests_per_minute", service.requests_per_minute, 0);
+    readField(j, "tokens_per_minute", service.tokens_per_minute, 0);
+}
+
+void to_json(nlohmann::json& j, const ConnectionPoolSettings& pool) {
+    j = {{"max_connections", pool.max_connections}, {"idle_timeout_seconds", pool.idle_timeout_seconds}};
+}
+
+void from_json(const nlohmann::json& j, ConnectionPoolSettings& pool) {
+    requireObject(j);
+    readField(j, "max_connections", pool.max_connections, 8);
+    readField(j, "idle_timeout_seconds", pool.idle_timeout_seconds, 60);
+}
+
+void to_json(nlohmann::json& j, const UserConfig& config) {
+    j = {
+        {"user_profile", {
+            {"name", config.name},
+            {"email", config.email},
+            {"phone_number", config.phone_number},
+            {"location", config.location},
+            {"date_of_birth", config.date_of_birth},
+            {"preferred_language", config.preferred_language}
+        }},
+        {"ai_services", {
+            {"default_provider", config.default_ai_provider},
+            {"openai", config.openai_config},
+            {"claude", config.claude_config},
+            {"connection_pool", config.connection_pool}
+        }},
+        {"preferences", {
+            {"interests", config.interests},
+            {"preferred_time_slots", config.preferred_time_slots},
+            {"max_travel_distance_km", config.max_travel_distance_km},
+            {"preferred_transportation", config.preferred_transportation},
+            {"budget_limits", config.budget_limits},
+            {"accessibility_needs", config.accessibility_needs},
+            {"dietary_restrictions", config.dietary_restrictions}
+        }},
+        {"notification_settings", config.notifications},
+        {"privacy_settings", {
+            {"data_sharing", {
+                {"analytics", config.analytics_sharing},
+                {"third_party", config.third_party_sharing},
+                {"marketing", config.marketing_sharing}
+            }},
+            {"location_tracking", config.location_tracking},
+            {"activity_logging", config.activity_logging},
+            {"data_retention_days", config.data_retention_days}
+        }},
+        {"app_settings", {
+            {"theme", config.theme},
+            {"date_format", config.date_format},
+            {"time_format", config.time_format},
+            {"first_day_of_week", config.first_day_of_week},
+            {"auto_sync", config.auto_sync},
+            {"sync_interval_minutes", config.sync_interval_minutes},
+            {"offline_mode", config.offline_mode},
+            {"cache_size_mb", config.cache_size_mb},
+            {"cache_ttl_hours", config.cache_ttl_hours},
+            {"cache_directory", config.cache_directory},
+            {"log_level", config.log_level}
+        }},
+        {"advanced_settings", {
+            {"recommendation_algorithm", config.recommendation_algorithm},
+            {"learning_rate", config.learning_rate},
+            {"diversity_factor", config.diversity_factor},
+            {"novelty_boost", config.novelty_boost},
+            {"popularity_weight", config.popularity_weight},
+            {"recency_bias", config.recency_bias},
+            {"max_recommendations_per_day", config.max_recommendations_per_day},
+            {"min_recommendation_score", config.min_recommendation_score},
+            {"prompt_token_budget", config.prompt_token_budget},
+            {"scoring_threads", config.scoring_threads}
+        }}
+    };
+}
+
+void from_json(const nlohmann::json& j, UserConfig& config) {
+    requireObject(j);
+    {
+        PathScope scope("user_profile");
+        const auto& profile = objectAt(j, "user_profile");
+        readField(profile, "name", config.name);
+        readField(profile, "email", config.email);
+        readField(profile, "phone_number", config.phone_number);
+        readField(profile, "location", config.location);
+        readField(profile, "date_of_birth", config.date_of_birth);
+        readField(profile, "preferred_language", config.preferred_language);
+    }
+    {
+        PathScope scope("ai_services");
+        const auto& services = objectAt(j, "ai_services");
+        readField(services, "default_provider", config.default_ai_provider);
+        readField(services, "openai", config.openai_config);
+        readField(services, "claude", config.claude_config);
+        // Older configs predate the pool section
+        readField(services, "connection_pool", config.connection_pool, ConnectionPoolSettings{8, 60});
+    }
+    {
+        PathScope scope("preferences");
+        const auto& preferences = objectAt(j, "preferences");
+        readField(preferences, "interests", config.interests);
+        readField(preferences, "max_travel_distance_km", config.max_travel_distance_km);
+        readField(preferences, "preferred_transportation", config.preferred_transportation);
+        readField(preferences, "accessibility_needs", config.accessibility_needs);
+        readField(preferences, "dietary_restrictions", config.dietary_restrictions);
+        readField(preferences, "budget_limits", config.budget_limits);
+        
+        // Read element by element so errors carry the slot index
+        PathScope slots_scope("preferred_time_slots");
+        auto slots = preferences.find("preferred_time_slots");
+        if (slots == preferences.end()) {
+            throw std::runtime_error("Missing config key: " + currentPath());
+        }
+        if (!slots->is_array()) {
+            throw std::runtime_error(currentPath() + ": expected an array, got " + slots->type_name());
+        }
+        config.preferred_time_slots.clear();
+        config.preferred_time_slots.reserve(slots->size());
+        for (size_t i = 0; i < slots->size(); ++i) {
+            PathScope slot_scope("[" + std::to_string(i) + "]");
+            config.preferred_time_slots.push_back((*slots)[i].get<TimeSlot>());
+        }
+    }
+    readField(j, "notification_settings", config.notifications);
+    {
+        PathScope scope("privacy_settings");
+        const auto& privacy = objectAt(j, "privacy_settings");
+        {
+            PathScope sharing_scope("data_sharing");
+            const auto& sharing = objectAt(privacy, "data_sharing");
+            readField(sharing, "analytics", config.analytics_sharing);
+            readField(sharing, "third_party", config.third_party_sharing);
+            readField(sharing, "marketing", config.marketing_sharing);
+        }
+        readField(privacy, "location_tracking", config.location_tracking);
+        readField(privacy, "activity_logging", config.activity_logging);
+        readField(privacy, "data_retention_days", config.data_retention_days);
+    }
+    {
+        PathScope scope("app_settings");
+        const auto& app = objectAt(j, "app_settings");
+        readField(app, "theme", config.theme);
+        readField(app, "date_format", config.date_format);
+        readField(app, "time_format", config.time_format);
+        readField(app, "first_day_of_week", config.first_day_of_week);
+        readField(app, "auto_sync", config.auto_sync);
+        readField(app, "sync_interval_minutes", config.sync_interval_minutes);
+        readField(app, "offline_mode", config.offline_mode);
+        readField(app, "cache_size_mb", config.cache_size_mb);
+        readField(app, "cache_ttl_hours", config.cache_ttl_hours, 24);
+        readField(app, "cache_directory", config.cache_directory, std::string("cache/ai_responses"));
+        readField(app, "log_level", config.log_level);
+    }
+    {
+        PathScope scope("advanced_settings");
+        const auto& advanced = objectAt(j, "advanced_settings");
+        readField(advanced, "recommendation_algorithm", config.recommendation_algorithm);
+        readField(advanced, "learning_rate", config.learning_rate);
+        readField(advanced, "diversity_factor", config.diversity_factor);
+        readField(advanced, "novelty_boost", config.novelty_boost);
+        readField(advanced, "popularity_weight", config.popularity_weight);
+        readField(advanced, "recency_bias", config.recency_bias);
+        readField(advanced, "max_recommendations_per_day", config.max_recommendations_per_day);
+        readField(advanced, "min_recommendation_score", config.min_recommendation_score);
+        readField(advanced, "prompt_token_budget", config.prompt_token_budget, 2000);
+        readField(advanced, "scoring_threads", config.scoring_threads, 1);
+    }
 }
\ No newline at end of file
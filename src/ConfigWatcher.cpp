@@ -0,0 +1,107 @@
+#include "ConfigWatcher.h"
+#include <cerrno>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+ConfigWatcher::ConfigWatcher(ConfigManager& config_manager, ReloadCallback on_reload)
+    : config_manager_(config_manager), on_reload_(std::move(on_reload)), inotify_fd_(-1), wake_fd_(-1),
+      running_(false) {
+}
+
+ConfigWatcher::~ConfigWatcher() {
+    stop();
+}
+
+bool ConfigWatcher::start() {
+    if (running_) {
+        return true;
+    }
+
+    std::filesystem::path config_path(config_manager_.getConfigFilePath());
+    std::string directory = config_path.parent_path().empty() ? "." : config_path.parent_path().string();
+
+    inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    // Only completed writes and renames into place; a bare create would reload a half-written file
+    if (inotify_fd_ < 0 || wake_fd_ < 0 ||
+        inotify_add_watch(inotify_fd_, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        std::cerr << "Failed to watch config directory: " << directory << std::endl;
+        stop();
+        return false;
+    }
+
+    running_ = true;
+    thread_ = std::thread(&ConfigWatcher::run, this, config_path.filename().string());
+    return true;
+}
+
+void ConfigWatcher::stop() {
+    if (thread_.joinable()) {
+        std::uint64_t one = 1;
+        ssize_t written = write(wake_fd_, &one, sizeof(one));
+        (void)written;
+        thread_.join();
+    }
+    running_ = false;
+
+    if (inotify_fd_ >= 0) {
+        close(inotify_fd_);
+        inotify_fd_ = -1;
+    }
+    if (wake_fd_ >= 0) {
+        close(wake_fd_);
+        wake_fd_ = -1;
+    }
+}
+
+void ConfigWatcher::run(std::string file_name) {
+    alignas(struct inotify_event) char buffer[4096];
+    bool pending = false;
+
+    while (true) {
+        pollfd fds[2] = {{wake_fd_, POLLIN, 0}, {inotify_fd_, POLLIN, 0}};
+        int timeout = pending ? static_cast<int>(SETTLE_DELAY.count()) : -1;
+        int ready = poll(fds, 2, timeout);
+        if (ready < 0 && errno != EINTR) {
+            break;
+        }
+        if (fds[0].revents & POLLIN) {
+            break;
+        }
+
+        if (fds[1].revents & POLLIN) {
+            ssize_t length;
+            while ((length = read(inotify_fd_, buffer, sizeof(buffer))) > 0) {
+                for (char* p = buffer; p < buffer + length;) {
+                    auto* event = reinterpret_cast<struct inotify_event*>(p);
+                    if (event->len > 0 && file_name == event->name) {
+                        pending = true;
+                    }
+                    p += sizeof(struct inotify_event) + event->len;
+                }
+            }
+            // Keep waiting until the file has been quiet for SETTLE_DELAY
+            continue;
+        }
+
+        if (ready == 0 && pending) {
+            pending = false;
+            bool reloaded = config_manager_.reloadConfig();
+            if (!reloaded) {
+                std::cerr << "Config reload failed, keeping previous settings:" << std::endl;
+                for (const auto& error : config_manager_.getReloadStats().last_errors) {
+                    std::cerr << "  - " << error << std::endl;
+                }
+            }
+            if (on_reload_) {
+                on_reload_(reloaded);
+            }
+        }
+    }
+    running_ = false;
+}
\ No newline at end of file
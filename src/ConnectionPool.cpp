@@ -0,0 +1,166 @@
+#include "ConnectionPool.h"
+#include <algorithm>
+
+namespace {
+    std::once_flag curl_global_once;
+    std::mutex shared_pool_mutex;
+    std::shared_ptr<ConnectionPool> shared_pool;
+}
+
+ConnectionPool::ConnectionPool() : ConnectionPool(Options()) {
+}
+
+ConnectionPool::ConnectionPool(const Options& options)
+    : options_(options), share_(nullptr), in_use_(0), created_(0), reused_(0), evicted_(0) {
+    std::call_once(curl_global_once, []() { curl_global_init(CURL_GLOBAL_DEFAULT); });
+
+    if (options_.max_size == 0) {
+        options_.max_size = 1;
+    }
+
+    share_ = curl_share_init();
+    if (share_) {
+        curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, &ConnectionPool::lockShare);
+        curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, &ConnectionPool::unlockShare);
+        curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+        curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+        curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_COOKIE);
+        // Not CURL_LOCK_DATA_CONNECT: a shared connection cache is unsupported for handles
+        // in use on several threads at once. Blocking callers keep the connections of the
+        // handle they lease, and the transport's curl_multi owns reuse for its transfers.
+    }
+}
+
+ConnectionPool::~ConnectionPool() {
+    for (auto& idle : idle_) {
+        curl_easy_cleanup(idle.handle);
+    }
+    idle_.clear();
+
+    if (share_) {
+        curl_share_cleanup(share_);
+    }
+}
+
+ConnectionPool::Lease ConnectionPool::acquire() {
+    return Lease(this, acquireHandle());
+}
+
+CURL* ConnectionPool::acquireHandle() {
+    CURL* handle = nullptr;
+    std::vector<CURL*> expired;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        evictExpiredLocked(std::chrono::steady_clock::now(), expired);
+
+        if (!idle_.empty()) {
+            // Most recently released handle first: its connection is the least likely to have gone stale
+            handle = idle_.back().handle;
+            idle_.pop_back();
+            reused_++;
+        }
+        in_use_++;
+    }
+
+    for (CURL* stale : expired) {
+        curl_easy_cleanup(stale);
+    }
+
+    if (handle) {
+        curl_easy_reset(handle);
+        prepareHandle(handle);
+        return handle;
+    }
+
+    handle = createHandle();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (handle) {
+        created_++;
+    } else {
+        in_use_--;
+    }
+    return handle;
+}
+
+void ConnectionPool::release(CURL* handle) {
+    if (!handle) {
+        return;
+    }
+
+    bool keep = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        in_use_--;
+        if (idle_.size() < options_.max_size) {
+            idle_.push_back({handle, std::chrono::steady_clock::now()});
+            keep = true;
+        } else {
+            evicted_++;
+        }
+    }
+
+    if (!keep) {
+        curl_easy_cleanup(handle);
+    }
+}
+
+ConnectionPool::Stats ConnectionPool::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return {options_.max_size, static_cast<long>(options_.idle_timeout.count()),
+            idle_.size(), in_use_, created_, reused_, evicted_};
+}
+
+std::shared_ptr<ConnectionPool> ConnectionPool::getShared() {
+    std::lock_guard<std::mutex> lock(shared_pool_mutex);
+    if (!shared_pool) {
+        shared_pool = std::make_shared<ConnectionPool>();
+    }
+    return shared_pool;
+}
+
+void ConnectionPool::setShared(std::shared_ptr<ConnectionPool> pool) {
+    std::lock_guard<std::mutex> lock(shared_pool_mutex);
+    shared_pool = std::move(pool);
+}
+
+CURL* ConnectionPool::createHandle() {
+    CURL* handle = curl_easy_init();
+    if (handle) {
+        prepareHandle(handle);
+    }
+    return handle;
+}
+
+void ConnectionPool::prepareHandle(CURL* handle) {
+    if (share_) {
+        curl_easy_setopt(handle, CURLOPT_SHARE, share_);
+    }
+    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(handle, CURLOPT_MAXAGE_CONN, static_cast<long>(options_.idle_timeout.count()));
+}
+
+void ConnectionPool::evictExpiredLocked(std::chrono::steady_clock::time_point now, std::vector<CURL*>& expired) {
+    auto is_expired = [&](const IdleHandle& idle) {
+        return now - idle.released_at > options_.idle_timeout;
+    };
+
+    for (const auto& idle : idle_) {
+        if (is_expired(idle)) {
+            expired.push_back(idle.handle);
+        }
+    }
+    idle_.erase(std::remove_if(idle_.begin(), idle_.end(), is_expired), idle_.end());
+    evicted_ += expired.size();
+}
+
+void ConnectionPool::lockShare(CURL*, curl_lock_data data, curl_lock_access, void* userptr) {
+    static_cast<ConnectionPool*>(userptr)->share_mutexes_[data].lock();
+}
+
+void ConnectionPool::unlockShare(CURL*, curl_lock_data data, void* userptr) {
+    static_cast<ConnectionPool*>(userptr)->share_mutexes_[data].unlock();
+}
\ No newline at end of file
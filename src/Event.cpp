@@ -1,10 +1,16 @@
 #include "Event.h"
+#include <atomic>
+
+namespace {
+    std::atomic<Event::Id> next_event_id{1};
+}
 
 Event::Event(const std::string& name, const std::string& description, 
              std::chrono::system_clock::time_point start_time,
              std::chrono::system_clock::time_point end_time,
              const std::string& location,
              const std::vector<std::string>& tags)
-    : name_(name), description_(description), start_time_(start_time), 
-      end_time_(end_time), location_(location), tags_(tags) {
+    : id_(next_event_id++), name_(name), description_(description), start_time_(start_time), 
+      end_time_(end_time), location_(location), tags_(tags),
+      coordinates_{0.0, 0.0}, has_coordinates_(false) {
 }
\ No newline at end of file
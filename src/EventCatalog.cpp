@@ -0,0 +1,351 @@
+#include "EventCatalog.h"
+#include "EventFeedReader.h"
+#include "TimeZone.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    const char MAGIC[8] = {'M', 'B', 'E', 'V', 'C', 'A', 'T', '\0'};
+    const size_t HEADER_SIZE = 80;
+    const size_t RECORD_SIZE = 72;
+    const std::uint16_t HAS_COORDINATES = 1;
+
+    template <typename T>
+    T readLittle(const unsigned char* p) {
+        T value;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        unsigned char bytes[sizeof(T)];
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            bytes[i] = p[sizeof(T) - 1 - i];
+        }
+        std::memcpy(&value, bytes, sizeof(T));
+#else
+        std::memcpy(&value, p, sizeof(T));
+#endif
+        return value;
+    }
+
+    template <typename T>
+    void writeLittle(std::string& out, T value) {
+        unsigned char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        std::reverse(bytes, bytes + sizeof(T));
+#endif
+        out.append(reinterpret_cast<const char*>(bytes), sizeof(T));
+    }
+
+    void padTo8(std::string& out) {
+        out.resize((out.size() + 7) & ~static_cast<size_t>(7), '\0');
+    }
+}
+
+void EventCatalog::Writer::add(Event::Id id, std::string_view name, std::string_view description,
+                               std::int64_t start_seconds, std::int64_t end_seconds,
+                               std::string_view location, const std::vector<std::string_view>& tags,
+                               const GeoPoint* coordinates) {
+    Record record{};
+    record.id = id;
+    record.start_seconds = start_seconds;
+    record.end_seconds = end_seconds;
+    if (coordinates) {
+        record.coordinates = *coordinates;
+        record.flags |= HAS_COORDINATES;
+    }
+    record.name[0] = addString(name);
+    record.name[1] = static_cast<std::uint32_t>(name.size());
+    record.description[0] = addString(description);
+    record.description[1] = static_cast<std::uint32_t>(description.size());
+    record.location[0] = addString(location);
+    record.location[1] = static_cast<std::uint32_t>(location.size());
+
+    record.first_tag = static_cast<std::uint32_t>(tag_refs_.size());
+    record.tag_count = static_cast<std::uint16_t>(
+        std::min<size_t>(tags.size(), std::numeric_limits<std::uint16_t>::max()));
+    for (size_t i = 0; i < record.tag_count; ++i) {
+        std::string tag(tags[i]);
+        auto it = tag_indexes_.find(tag);
+        if (it == tag_indexes_.end()) {
+            auto index = static_cast<std::uint32_t>(tag_table_.size() / 2);
+            tag_table_.push_back(addString(tag));
+            tag_table_.push_back(static_cast<std::uint32_t>(tag.size()));
+            it = tag_indexes_.emplace(std::move(tag), index).first;
+        }
+        tag_refs_.push_back(it->second);
+    }
+    records_.push_back(record);
+}
+
+void EventCatalog::Writer::add(const Event& event) {
+    std::vector<std::string_view> tags(event.getTags().begin(), event.getTags().end());
+    add(event.getId(), event.getName(), event.getDescription(),
+        TimeZone::toUnixSeconds(event.getStartTime()), TimeZone::toUnixSeconds(event.getEndTime()),
+        event.getLocation(), tags, event.hasCoordinates() ? &event.getCoordinates() : nullptr);
+}
+
+bool EventCatalog::Writer::write(const std::string& path, std::string& error) const {
+    if (strings_.size() > std::numeric_limits<std::uint32_t>::max()) {
+        error = "String pool exceeds 4 GiB";
+        return false;
+    }
+
+    std::string out;
+    out.reserve(HEADER_SIZE + records_.size() * RECORD_SIZE + tag_table_.size() * 4 + tag_refs_.size() * 4 +
+                strings_.size() + 32);
+
+    std::uint64_t records_offset = HEADER_SIZE;
+    std::uint64_t tags_offset = records_offset + records_.size() * RECORD_SIZE;
+    std::uint64_t tag_refs_offset = (tags_offset + tag_table_.size() * 4 + 7) & ~static_cast<std::uint64_t>(7);
+    std::uint64_t strings_offset = (tag_refs_offset + tag_refs_.size() * 4 + 7) & ~static_cast<std::uint64_t>(7);
+
+    out.append(MAGIC, sizeof(MAGIC));
+    writeLittle<std::uint32_t>(out, VERSION);
+    writeLittle<std::uint32_t>(out, RECORD_SIZE);
+    writeLittle<std::uint64_t>(out, records_.size());
+    writeLittle<std::uint64_t>(out, tag_table_.size() / 2);
+    writeLittle<std::uint64_t>(out, tag_refs_.size());
+    writeLittle<std::uint64_t>(out, records_offset);
+    writeLittle<std::uint64_t>(out, tags_offset);
+    writeLittle<std::uint64_t>(out, tag_refs_offset);
+    writeLittle<std::uint64_t>(out, strings_offset);
+    writeLittle<std::uint64_t>(out, strings_.size());
+
+    for (const auto& record : records_) {
+        writeLittle<std::uint64_t>(out, record.id);
+        writeLittle<std::int64_t>(out, record.start_seconds);
+        writeLittle<std::int64_t>(out, record.end_seconds);
+        writeLittle<double>(out, record.coordinates.latitude);
+        writeLittle<double>(out, record.coordinates.longitude);
+        for (const auto* pair : {record.name, record.description, record.location}) {
+            writeLittle<std::uint32_t>(out, pair[0]);
+            writeLittle<std::uint32_t>(out, pair[1]);
+        }
+        writeLittle<std::uint32_t>(out, record.first_tag);
+        writeLittle<std::uint16_t>(out, record.tag_count);
+        writeLittle<std::uint16_t>(out, record.flags);
+    }
+    for (auto value : tag_table_) {
+        writeLittle<std::uint32_t>(out, value);
+    }
+    padTo8(out);
+    for (auto value : tag_refs_) {
+        writeLittle<std::uint32_t>(out, value);
+    }
+    padTo8(out);
+    out += strings_;
+
+    std::string temp_path = path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            error = "Failed to open " + temp_path + " for writing";
+            return false;
+        }
+        file.write(out.data(), static_cast<std::streamsize>(out.size()));
+        if (!file) {
+            error = "Failed to write " + temp_path;
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp_path, path, ec);
+    if (ec) {
+        std::filesystem::remove(temp_path, ec);
+        error = "Failed to replace " + path;
+        return false;
+    }
+    return true;
+}
+
+std::uint32_t EventCatalog::Writer::addString(std::string_view text) {
+    std::string key(text);
+    auto it = string_offsets_.find(key);
+    if (it != string_offsets_.end()) {
+        return it->second;
+    }
+    auto offset = static_cast<std::uint32_t>(strings_.size());
+    strings_.append(text.data(), text.size());
+    string_offsets_.emplace(std::move(key), offset);
+    return offset;
+}
+
+EventCatalog::EventCatalog()
+    : data_(nullptr), size_(0), event_count_(0), tag_count_(0), tag_ref_count_(0), strings_size_(0),
+      records_(nullptr), tags_(nullptr), tag_refs_(nullptr), strings_(nullptr) {
+}
+
+EventCatalog::~EventCatalog() {
+    if (data_) {
+        munmap(const_cast<unsigned char*>(data_), size_);
+    }
+}
+
+std::shared_ptr<const EventCatalog> EventCatalog::open(const std::string& path, std::string& error) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = "Failed to open " + path + ": " + std::strerror(errno);
+        return nullptr;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(HEADER_SIZE)) {
+        ::close(fd);
+        error = path + " is too small to be an event catalog";
+        return nullptr;
+    }
+
+    void* mapping = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        error = "Failed to map " + path + ": " + std::strerror(errno);
+        return nullptr;
+    }
+
+    std::shared_ptr<EventCatalog> catalog(new EventCatalog());
+    catalog->data_ = static_cast<const unsigned char*>(mapping);
+    catalog->size_ = static_cast<size_t>(info.st_size);
+    if (!catalog->validate(error)) {
+        error = path + ": " + error;
+        return nullptr;
+    }
+    return catalog;
+}
+
+bool EventCatalog::convertJson(const std::string& json_path, const std::string& catalog_path, std::string& error) {
+    Writer writer;
+    bool read = EventFeedReader::readFile(json_path, [&writer](const Event& event) {
+        writer.add(event);
+        return true;
+    }, error);
+    return read && writer.write(catalog_path, error);
+}
+
+EventCatalog::EventView EventCatalog::getEvent(size_t index) const {
+    const unsigned char* record = records_ + index * RECORD_SIZE;
+    EventView view;
+    view.id = readLittle<std::uint64_t>(record);
+    // Both were range-checked in validate()
+    TimeZone::fromUnixSeconds(readLittle<std::int64_t>(record + 8), view.start_time);
+    TimeZone::fromUnixSeconds(readLittle<std::int64_t>(record + 16), view.end_time);
+    view.coordinates = {readLittle<double>(record + 24), readLittle<double>(record + 32)};
+    view.name = getString(record + 40);
+    view.description = getString(record + 48);
+    view.location = getString(record + 56);
+    view.first_tag = readLittle<std::uint32_t>(record + 64);
+    view.tag_count = readLittle<std::uint16_t>(record + 68);
+    view.has_coordinates = (readLittle<std::uint16_t>(record + 70) & HAS_COORDINATES) != 0;
+    return view;
+}
+
+std::string_view EventCatalog::getTag(std::uint32_t tag_index) const {
+    return getString(tags_ + static_cast<size_t>(tag_index) * 8);
+}
+
+std::uint32_t EventCatalog::getTagIndex(const EventView& event, size_t i) const {
+    return readLittle<std::uint32_t>(tag_refs_ + (static_cast<size_t>(event.first_tag) + i) * 4);
+}
+
+Event EventCatalog::toEvent(size_t index) const {
+    EventView view = getEvent(index);
+    std::vector<std::string> tags;
+    tags.reserve(view.tag_count);
+    for (size_t i = 0; i < view.tag_count; ++i) {
+        tags.emplace_back(getTag(getTagIndex(view, i)));
+    }
+
+    Event event(std::string(view.name), std::string(view.description), view.start_time, view.end_time,
+                std::string(view.location), tags);
+    event.setId(view.id);
+    if (view.has_coordinates) {
+        event.setCoordinates(view.coordinates);
+    }
+    return event;
+}
+
+bool EventCatalog::validate(std::string& error) {
+    if (std::memcmp(data_, MAGIC, sizeof(MAGIC)) != 0) {
+        error = "not an event catalog";
+        return false;
+    }
+    std::uint32_t version = readLittle<std::uint32_t>(data_ + 8);
+    if (version != VERSION) {
+        error = "unsupported catalog version " + std::to_string(version);
+        return false;
+    }
+    if (readLittle<std::uint32_t>(data_ + 12) != RECORD_SIZE) {
+        error = "unexpected record size";
+        return false;
+    }
+
+    std::uint64_t event_count = readLittle<std::uint64_t>(data_ + 16);
+    std::uint64_t tag_count = readLittle<std::uint64_t>(data_ + 24);
+    std::uint64_t tag_ref_count = readLittle<std::uint64_t>(data_ + 32);
+    std::uint64_t strings_size = readLittle<std::uint64_t>(data_ + 72);
+
+    // Every section must lie inside the file; dividing first keeps the products from overflowing
+    auto fits = [this](std::uint64_t offset, std::uint64_t count, std::uint64_t width) {
+        return offset <= size_ && count <= (size_ - offset) / width;
+    };
+    if (!fits(readLittle<std::uint64_t>(data_ + 40), event_count, RECORD_SIZE) ||
+        !fits(readLittle<std::uint64_t>(data_ + 48), tag_count, 8) ||
+        !fits(readLittle<std::uint64_t>(data_ + 56), tag_ref_count, 4) ||
+        !fits(readLittle<std::uint64_t>(data_ + 64), strings_size, 1) ||
+        tag_count > std::numeric_limits<std::uint32_t>::max()) {
+        error = "section extends past the end of the file";
+        return false;
+    }
+
+    event_count_ = static_cast<size_t>(event_count);
+    tag_count_ = static_cast<size_t>(tag_count);
+    tag_ref_count_ = static_cast<size_t>(tag_ref_count);
+    strings_size_ = static_cast<size_t>(strings_size);
+    records_ = data_ + readLittle<std::uint64_t>(data_ + 40);
+    tags_ = data_ + readLittle<std::uint64_t>(data_ + 48);
+    tag_refs_ = data_ + readLittle<std::uint64_t>(data_ + 56);
+    strings_ = data_ + readLittle<std::uint64_t>(data_ + 64);
+
+    // One sequential pass, so accessors never need bounds checks
+    auto string_fits = [this](const unsigned char* pair) {
+        std::uint64_t offset = readLittle<std::uint32_t>(pair);
+        std::uint64_t length = readLittle<std::uint32_t>(pair + 4);
+        return offset + length <= strings_size_;
+    };
+    for (size_t i = 0; i < tag_count_; ++i) {
+        if (!string_fits(tags_ + i * 8)) {
+            error = "tag " + std::to_string(i) + " is out of bounds";
+            return false;
+        }
+    }
+    for (size_t i = 0; i < tag_ref_count_; ++i) {
+        if (readLittle<std::uint32_t>(tag_refs_ + i * 4) >= tag_count_) {
+            error = "tag reference " + std::to_string(i) + " is out of bounds";
+            return false;
+        }
+    }
+    std::chrono::system_clock::time_point time;
+    for (size_t i = 0; i < event_count_; ++i) {
+        const unsigned char* record = records_ + i * RECORD_SIZE;
+        std::uint64_t first_tag = readLittle<std::uint32_t>(record + 64);
+        std::uint64_t count = readLittle<std::uint16_t>(record + 68);
+        if (!string_fits(record + 40) || !string_fits(record + 48) || !string_fits(record + 56) ||
+            first_tag + count > tag_ref_count_ || !TimeZone::fromUnixSeconds(readLittle<std::int64_t>(record + 8), time) ||
+            !TimeZone::fromUnixSeconds(readLittle<std::int64_t>(record + 16), time)) {
+            error = "event " + std::to_string(i) + " is out of bounds";
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string_view EventCatalog::getString(const unsigned char* pair) const {
+    return std::string_view(reinterpret_cast<const char*>(strings_) + readLittle<std::uint32_t>(pair),
+                            readLittle<std::uint32_t>(pair + 4));
+}
\ No newline at end of file
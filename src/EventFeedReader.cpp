@@ -0,0 +1,324 @@
+#include "EventFeedReader.h"
+#include "TimeZone.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <type_traits>
+
+namespace {
+    // Tracks container depth to find the events array and assemble one event at a
+    // time; nested values the feed format does not know about are skipped whole.
+    class FeedHandler : public nlohmann::json_sax<nlohmann::json> {
+    public:
+        FeedHandler(const EventFeedReader::Sink& sink, std::string& error)
+            : sink_(sink), error_(error), depth_(0), root_is_object_(false), events_depth_(0),
+              event_depth_(0), tags_depth_(0), skip_depth_(0), count_(0), stopped_(false) {}
+
+        bool foundEvents() const { return events_depth_ != 0 || count_ > 0; }
+        bool stopped() const { return stopped_; }
+
+        bool null() override { return scalar(nullptr); }
+        bool boolean(bool value) override { return scalar(value); }
+        bool number_integer(number_integer_t value) override { return scalar(value); }
+        bool number_unsigned(number_unsigned_t value) override { return scalar(value); }
+        bool number_float(number_float_t value, const string_t&) override { return scalar(value); }
+        bool string(string_t& value) override { return scalar(value); }
+        bool binary(binary_t&) override { return scalar(nullptr); }
+
+        bool key(string_t& value) override {
+            if (!skip_depth_ && (depth_ == 1 || depth_ == event_depth_)) {
+                key_ = value;
+            }
+            return true;
+        }
+
+        bool start_object(std::size_t) override {
+            if (!skip_depth_) {
+                if (depth_ == 0) {
+                    root_is_object_ = true;
+                } else if (events_depth_ && depth_ == events_depth_) {
+                    beginEvent();
+                    event_depth_ = depth_ + 1;
+                } else {
+                    skip_depth_ = depth_ + 1;
+                }
+            }
+            depth_++;
+            return true;
+        }
+
+        bool end_object() override {
+            depth_--;
+            if (skip_depth_ && depth_ + 1 == skip_depth_) {
+                skip_depth_ = 0;
+            } else if (event_depth_ && depth_ + 1 == event_depth_) {
+                event_depth_ = 0;
+                return endEvent();
+            }
+            return true;
+        }
+
+        bool start_array(std::size_t) override {
+            if (!skip_depth_) {
+                if (depth_ == 0) {
+                    events_depth_ = 1;
+                } else if (depth_ == 1 && root_is_object_ && key_ == "events" && !events_depth_) {
+                    events_depth_ = 2;
+                } else if (event_depth_ && depth_ == event_depth_ && key_ == "tags") {
+                    tags_depth_ = depth_ + 1;
+                } else {
+                    skip_depth_ = depth_ + 1;
+                }
+            }
+            depth_++;
+            return true;
+        }
+
+        bool end_array() override {
+            depth_--;
+            if (skip_depth_ && depth_ + 1 == skip_depth_) {
+                skip_depth_ = 0;
+            } else if (tags_depth_ && depth_ + 1 == tags_depth_) {
+                tags_depth_ = 0;
+            }
+            return true;
+        }
+
+        bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& e) override {
+            error_ = e.what();
+            return false;
+        }
+
+    private:
+        const EventFeedReader::Sink& sink_;
+        std::string& error_;
+        size_t depth_;
+        bool root_is_object_;
+        size_t events_depth_;
+        size_t event_depth_;
+        size_t tags_depth_;
+        size_t skip_depth_;
+        std::string key_;
+        size_t count_;
+        bool stopped_;
+
+        // Fields of the event being assembled
+        std::string name_;
+        std::string description_;
+        std::string location_;
+        std::vector<std::string> tags_;
+        std::int64_t start_;
+        std::int64_t end_;
+        bool has_start_;
+        bool has_end_;
+        bool has_name_;
+        Event::Id id_;
+        bool has_id_;
+        double latitude_;
+        double longitude_;
+        bool has_latitude_;
+        bool has_longitude_;
+
+        void beginEvent() {
+            name_.clear();
+            description_.clear();
+            location_.clear();
+            tags_.clear();
+            has_start_ = has_end_ = has_name_ = has_id_ = has_latitude_ = has_longitude_ = false;
+            key_.clear();
+        }
+
+        bool endEvent() {
+            std::chrono::system_clock::time_point start_time;
+            std::chrono::system_clock::time_point end_time;
+            if (!has_name_ || !has_start_ || !has_end_ || !TimeZone::fromUnixSeconds(start_, start_time) ||
+                !TimeZone::fromUnixSeconds(end_, end_time)) {
+                error_ = "event " + std::to_string(count_) + " needs a name and valid start and end times";
+                return false;
+            }
+
+            Event event(name_, description_, start_time, end_time, location_, tags_);
+            event.setId(has_id_ ? id_ : static_cast<Event::Id>(count_ + 1));
+            if (has_latitude_ && has_longitude_) {
+                event.setCoordinates({latitude_, longitude_});
+            }
+            count_++;
+
+            if (!sink_(event)) {
+                stopped_ = true;
+                return false;
+            }
+            return true;
+        }
+
+        template <typename T>
+        bool scalar(const T& value) {
+            if (skip_depth_) {
+                return true;
+            }
+            if (tags_depth_ && depth_ == tags_depth_) {
+                if constexpr (std::is_same<T, string_t>::value) {
+                    tags_.push_back(value);
+                    return true;
+                }
+                error_ = "event " + std::to_string(count_) + " has a tag that is not a string";
+                return false;
+            }
+            if (events_depth_ && depth_ == events_depth_) {
+                error_ = "event " + std::to_string(count_) + " is not an object";
+                return false;
+            }
+            if (event_depth_ && depth_ == event_depth_) {
+                field(value);
+            }
+            return true;
+        }
+
+        template <typename T>
+        void field(const T& value) {
+            if constexpr (std::is_same<T, string_t>::value) {
+                if (key_ == "name") {
+                    name_ = value;
+                    has_name_ = true;
+                } else if (key_ == "description") {
+                    description_ = value;
+                } else if (key_ == "location") {
+                    location_ = value;
+                } else if (key_ == "start") {
+                    has_start_ = TimeZone::parseIso8601(value, start_);
+                } else if (key_ == "end") {
+                    has_end_ = TimeZone::parseIso8601(value, end_);
+                }
+            } else if constexpr (std::is_arithmetic<T>::value && !std::is_same<T, bool>::value) {
+                if (key_ == "latitude") {
+                    latitude_ = static_cast<double>(value);
+                    has_latitude_ = true;
+                } else if (key_ == "longitude") {
+                    longitude_ = static_cast<double>(value);
+                    has_longitude_ = true;
+                } else if constexpr (std::is_integral<T>::value) {
+                    bool fits = std::is_signed<T>::value ||
+                                static_cast<std::uint64_t>(value) <=
+                                    static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max());
+                    if (key_ == "start") {
+                        start_ = static_cast<std::int64_t>(value);
+                        has_start_ = fits;
+                    } else if (key_ == "end") {
+                        end_ = static_cast<std::int64_t>(value);
+                        has_end_ = fits;
+                    } else if (key_ == "id") {
+                        id_ = static_cast<Event::Id>(value);
+                        has_id_ = true;
+                    }
+                }
+            }
+        }
+    };
+}
+
+bool EventFeedReader::read(std::istream& input, const Sink& sink, std::string& error) {
+    FeedHandler handler(sink, error);
+    bool completed = nlohmann::json::sax_parse(input, &handler);
+    if (handler.stopped()) {
+        return true;
+    }
+    if (completed && !handler.foundEvents()) {
+        error = "expected an array of events or an object with an \"events\" array";
+        return false;
+    }
+    return completed;
+}
+
+bool EventFeedReader::readFile(const std::string& path, const Sink& sink, std::string& error) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        error = "Failed to open " + path;
+        return false;
+    }
+    if (!read(file, sink, error)) {
+        error = path + ": " + error;
+        return false;
+    }
+    return true;
+}
+
+EventFeedReader::EventFeedReader(const std::string& path, size_t queue_capacity)
+    : max_batches_(std::max<size_t>(1, queue_capacity / BATCH_SIZE)), done_(false), cancelled_(false),
+      failed_(false), current_index_(0) {
+    parser_ = std::thread(&EventFeedReader::parse, this, path);
+}
+
+EventFeedReader::~EventFeedReader() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancelled_ = true;
+    }
+    not_full_.notify_all();
+    parser_.join();
+}
+
+const Event* EventFeedReader::next() {
+    if (current_index_ < current_.size()) {
+        return &current_[current_index_++];
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock, [this] { return !batches_.empty() || done_; });
+    if (batches_.empty()) {
+        return nullptr;
+    }
+    current_ = std::move(batches_.front());
+    batches_.pop_front();
+    lock.unlock();
+    not_full_.notify_one();
+
+    current_index_ = 1;
+    return &current_[0];
+}
+
+bool EventFeedReader::failed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return failed_;
+}
+
+std::string EventFeedReader::getError() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return error_;
+}
+
+void EventFeedReader::parse(const std::string& path) {
+    std::vector<Event> batch;
+    batch.reserve(BATCH_SIZE);
+    std::string error;
+    bool ok = readFile(path, [this, &batch](const Event& event) {
+        batch.push_back(event);
+        return batch.size() < BATCH_SIZE || push(batch);
+    }, error);
+    if (ok && !batch.empty()) {
+        push(batch);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_ = true;
+        failed_ = !ok && !cancelled_;
+        error_ = failed_ ? error : std::string();
+    }
+    not_empty_.notify_all();
+}
+
+bool EventFeedReader::push(std::vector<Event>& batch) {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this] { return batches_.size() < max_batches_ || cancelled_; });
+        if (cancelled_) {
+            return false;
+        }
+        batches_.push_back(std::move(batch));
+    }
+    not_empty_.notify_one();
+    batch.clear();
+    batch.reserve(BATCH_SIZE);
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,165 @@
+#include "EventStore.h"
+#include "EventCatalog.h"
+#include <algorithm>
+
+EventStore::EventStore(TagInterner& tag_interner)
+    : tag_interner_(tag_interner), tag_offsets_{0}, active_count_(0), locations_{""} {
+}
+
+EventStore::EventId EventStore::addEvent(const Event& event) {
+    tag_scratch_.clear();
+    for (const auto& tag : event.getTags()) {
+        tag_scratch_.push_back(tag_interner_.intern(tag));
+    }
+    return appendRow(event.getId(), ownString(event.getName()), ownString(event.getDescription()),
+                     event.getStartTime(), event.getEndTime(), internLocation(event.getLocation()),
+                     event.hasCoordinates() ? &event.getCoordinates() : nullptr);
+}
+
+void EventStore::addEvents(std::shared_ptr<const EventCatalog> catalog) {
+    // Catalog strings are pooled, so each distinct tag and location is interned once
+    std::vector<TagInterner::TagId> tag_ids(catalog->getTagCount());
+    for (std::uint32_t i = 0; i < tag_ids.size(); ++i) {
+        tag_ids[i] = tag_interner_.intern(std::string(catalog->getTag(i)));
+    }
+    std::unordered_map<const char*, LocationId> location_ids;
+
+    reserve(size() + catalog->size(), tag_ids_.size() + catalog->getTagReferenceCount());
+    for (size_t i = 0; i < catalog->size(); ++i) {
+        auto event = catalog->getEvent(i);
+        tag_scratch_.clear();
+        for (size_t t = 0; t < event.tag_count; ++t) {
+            tag_scratch_.push_back(tag_ids[catalog->getTagIndex(event, t)]);
+        }
+
+        auto location = location_ids.find(event.location.data());
+        if (location == location_ids.end()) {
+            location = location_ids.emplace(event.location.data(),
+                                            internLocation(std::string(event.location))).first;
+        }
+        appendRow(event.id, event.name, event.description, event.start_time, event.end_time, location->second,
+                  event.has_coordinates ? &event.coordinates : nullptr);
+    }
+    // Keeps the mapping the name and description views point into
+    catalogs_.push_back(std::move(catalog));
+}
+
+EventStore::EventId EventStore::appendRow(Event::Id source_id, std::string_view name, std::string_view description,
+                                          std::chrono::system_clock::time_point start_time,
+                                          std::chrono::system_clock::time_point end_time,
+                                          LocationId location_id, const GeoPoint* coordinates) {
+    EventId id = static_cast<EventId>(start_times_.size());
+
+    start_times_.push_back(start_time);
+    end_times_.push_back(end_time);
+    location_ids_.push_back(location_id);
+    source_ids_.push_back(source_id);
+    
+    coordinates_.push_back(coordinates ? *coordinates : GeoPoint{0.0, 0.0});
+    has_coordinates_.push_back(coordinates ? 1 : 0);
+    if (coordinates) {
+        geo_index_.insert(id, *coordinates);
+    } else {
+        events_without_coordinates_.push_back(id);
+    }
+
+    for (auto tag_id : tag_scratch_) {
+        tag_ids_.push_back(tag_id);
+        
+        if (tag_id >= postings_.size()) {
+            postings_.resize(tag_id + 1);
+        }
+        // Ids only grow, so appending keeps each list sorted; skip repeated tags
+        if (postings_[tag_id].empty() || postings_[tag_id].back() != id) {
+            postings_[tag_id].push_back(id);
+        }
+    }
+    tag_offsets_.push_back(static_cast<std::uint32_t>(tag_ids_.size()));
+    active_.push_back(1);
+    active_count_++;
+
+    names_.emplace_back(name);
+    descriptions_.emplace_back(description);
+
+    return id;
+}
+
+void EventStore::reserve(size_t event_count, size_t tag_count) {
+    start_times_.reserve(event_count);
+    end_times_.reserve(event_count);
+    location_ids_.reserve(event_count);
+    source_ids_.reserve(event_count);
+    coordinates_.reserve(event_count);
+    has_coordinates_.reserve(event_count);
+    active_.reserve(event_count);
+    tag_offsets_.reserve(event_count + 1);
+    tag_ids_.reserve(tag_count);
+    names_.reserve(event_count);
+    descriptions_.reserve(event_count);
+}
+
+Event EventStore::materialize(EventId id) const {
+    std::vector<std::string> tags;
+    tags.reserve(tag_offsets_[id + 1] - tag_offsets_[id]);
+    for (auto tag = tagsBegin(id); tag != tagsEnd(id); ++tag) {
+        tags.push_back(tag_interner_.getName(*tag));
+    }
+
+    Event event(std::string(names_[id]), std::string(descriptions_[id]), start_times_[id], end_times_[id],
+                locations_[location_ids_[id]], tags);
+    event.setId(source_ids_[id]);
+    if (has_coordinates_[id]) {
+        event.setCoordinates(coordinates_[id]);
+    }
+    return event;
+}
+
+bool EventStore::removeEvent(EventId id) {
+    if (id >= active_.size() || !active_[id]) {
+        return false;
+    }
+    active_[id] = 0;
+    active_count_--;
+    
+    for (auto tag = tagsBegin(id); tag != tagsEnd(id); ++tag) {
+        auto& postings = postings_[*tag];
+        auto it = std::lower_bound(postings.begin(), postings.end(), id);
+        if (it != postings.end() && *it == id) {
+            postings.erase(it);
+        }
+    }
+    
+    if (has_coordinates_[id]) {
+        geo_index_.remove(id, coordinates_[id]);
+    } else {
+        auto it = std::lower_bound(events_without_coordinates_.begin(), events_without_coordinates_.end(), id);
+        if (it != events_without_coordinates_.end() && *it == id) {
+            events_without_coordinates_.erase(it);
+        }
+    }
+    return true;
+}
+
+EventStore::LocationId EventStore::internLocation(const std::string& location) {
+    if (location.empty()) {
+        return NO_LOCATION;
+    }
+
+    auto it = location_index_.find(location);
+    if (it != location_index_.end()) {
+        return it->second;
+    }
+
+    LocationId id = static_cast<LocationId>(locations_.size());
+    locations_.push_back(location);
+    location_index_.emplace(location, id);
+    return id;
+}
+
+std::string_view EventStore::ownString(const std::string& text) {
+    if (text.empty()) {
+        return {};
+    }
+    owned_strings_.push_back(text);
+    return owned_strings_.back();
+}
\ No newline at end of file
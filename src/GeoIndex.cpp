@@ -0,0 +1,108 @@
+#include "GeoIndex.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Length of one degree of latitude on the sphere used by GeoPoint::distanceKm
+    const double KM_PER_DEGREE = 6371.0088 * 3.14159265358979323846 / 180.0;
+}
+
+GeoIndex::GeoIndex(double cell_degrees)
+    : cell_degrees_(cell_degrees > 0 ? cell_degrees : 0.1), size_(0) {
+    longitude_cells_ = static_cast<std::int64_t>(std::ceil(360.0 / cell_degrees_));
+}
+
+void GeoIndex::insert(Id id, const GeoPoint& point) {
+    cells_[cellKey(latitudeCell(point.latitude), longitudeCell(point.longitude))].push_back({id, point});
+    ++size_;
+}
+
+bool GeoIndex::remove(Id id, const GeoPoint& point) {
+    auto cell = cells_.find(cellKey(latitudeCell(point.latitude), longitudeCell(point.longitude)));
+    if (cell == cells_.end()) {
+        return false;
+    }
+    
+    auto& entries = cell->second;
+    auto it = std::find_if(entries.begin(), entries.end(), [id](const Entry& entry) { return entry.id == id; });
+    if (it == entries.end()) {
+        return false;
+    }
+    entries.erase(it);
+    if (entries.empty()) {
+        cells_.erase(cell);
+    }
+    --size_;
+    return true;
+}
+
+void GeoIndex::clear() {
+    cells_.clear();
+    size_ = 0;
+}
+
+void GeoIndex::queryRadius(const GeoPoint& center, double radius_km, std::vector<Id>& out) const {
+    size_t first_result = out.size();
+    auto collect = [&](const std::vector<Entry>& entries) {
+        for (const auto& entry : entries) {
+            if (GeoPoint::distanceKm(center, entry.point) <= radius_km) {
+                out.push_back(entry.id);
+            }
+        }
+    };
+
+    // Pad by a cell so rounding at the box edges can never drop a point
+    double latitude_span = radius_km / KM_PER_DEGREE + cell_degrees_;
+    double south = center.latitude - latitude_span;
+    double north = center.latitude + latitude_span;
+
+    double widest = std::max(std::fabs(south), std::fabs(north));
+    double longitude_span = widest < 90.0
+        ? latitude_span / std::cos(widest * 3.14159265358979323846 / 180.0) + cell_degrees_
+        : 360.0;
+
+    std::int64_t first_lat = latitudeCell(std::max(south, -90.0));
+    std::int64_t last_lat = latitudeCell(std::min(north, 90.0));
+    std::int64_t first_lon = longitudeCell(center.longitude - std::min(longitude_span, 180.0));
+    std::int64_t lon_count = longitude_span >= 180.0
+        ? longitude_cells_
+        : longitudeCell(center.longitude + longitude_span) - first_lon + 1;
+    if (lon_count <= 0) {
+        lon_count += longitude_cells_;
+    }
+    lon_count = std::min(lon_count, longitude_cells_);
+
+    if (static_cast<size_t>((last_lat - first_lat + 1) * lon_count) >= cells_.size()) {
+        // Box covers more cells than are occupied: cheaper to scan them all
+        for (const auto& cell : cells_) {
+            collect(cell.second);
+        }
+    } else {
+        for (std::int64_t lat = first_lat; lat <= last_lat; ++lat) {
+            for (std::int64_t i = 0; i < lon_count; ++i) {
+                auto it = cells_.find(cellKey(lat, (first_lon + i) % longitude_cells_));
+                if (it != cells_.end()) {
+                    collect(it->second);
+                }
+            }
+        }
+    }
+
+    std::sort(out.begin() + static_cast<std::ptrdiff_t>(first_result), out.end());
+}
+
+std::int64_t GeoIndex::latitudeCell(double latitude) const {
+    return static_cast<std::int64_t>(std::floor((latitude + 90.0) / cell_degrees_));
+}
+
+std::int64_t GeoIndex::longitudeCell(double longitude) const {
+    double wrapped = std::fmod(longitude + 180.0, 360.0);
+    if (wrapped < 0) {
+        wrapped += 360.0;
+    }
+    return static_cast<std::int64_t>(std::floor(wrapped / cell_degrees_)) % longitude_cells_;
+}
+
+std::int64_t GeoIndex::cellKey(std::int64_t latitude_cell, std::int64_t longitude_cell) const {
+    return latitude_cell * longitude_cells_ + longitude_cell;
+}
\ No newline at end of file
@@ -0,0 +1,20 @@
+#include "GeoPoint.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    const double EARTH_RADIUS_KM = 6371.0088;
+    const double DEGREES_TO_RADIANS = 3.14159265358979323846 / 180.0;
+}
+
+double GeoPoint::distanceKm(const GeoPoint& from, const GeoPoint& to) {
+    double lat1 = from.latitude * DEGREES_TO_RADIANS;
+    double lat2 = to.latitude * DEGREES_TO_RADIANS;
+    double half_dlat = (to.latitude - from.latitude) * DEGREES_TO_RADIANS / 2.0;
+    double half_dlon = (to.longitude - from.longitude) * DEGREES_TO_RADIANS / 2.0;
+
+    double sin_dlat = std::sin(half_dlat);
+    double sin_dlon = std::sin(half_dlon);
+    double h = sin_dlat * sin_dlat + std::cos(lat1) * std::cos(lat2) * sin_dlon * sin_dlon;
+    return 2.0 * EARTH_RADIUS_KM * std::asin(std::min(1.0, std::sqrt(h)));
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#include "HourOfWeekMask.h"
+#include <algorithm>
+#include <cctype>
+
+namespace {
+    const char* const DAY_NAMES[] = {"monday", "tuesday", "wednesday", "thursday", "friday", "saturday", "sunday"};
+}
+
+void HourOfWeekMask::addSlot(int start_hour, int end_hour, std::uint8_t days) {
+    start_hour = std::max(0, std::min(23, start_hour));
+    end_hour = std::max(0, std::min(23, end_hour));
+
+    for (size_t day = 0; day < 7; ++day) {
+        if (!(days & (1u << day))) {
+            continue;
+        }
+        size_t first = day * 24 + static_cast<size_t>(start_hour);
+        size_t length = static_cast<size_t>(end_hour >= start_hour ? end_hour - start_hour : end_hour + 24 - start_hour) + 1;
+        for (size_t i = 0; i < length; ++i) {
+            bits_.set((first + i) % HOURS_PER_WEEK);
+        }
+    }
+}
+
+size_t HourOfWeekMask::hourOfWeek(std::int64_t local_seconds) {
+    std::int64_t days = local_seconds >= 0 ? local_seconds / 86400 : (local_seconds - 86399) / 86400;
+    std::int64_t hour = (local_seconds - days * 86400) / 3600;
+    // 1970-01-01 was a Thursday
+    std::int64_t weekday = ((days + 3) % 7 + 7) % 7;
+    return static_cast<size_t>(weekday * 24 + hour);
+}
+
+std::uint8_t HourOfWeekMask::parseDays(const std::vector<std::string>& days) {
+    if (days.empty()) {
+        return ALL_DAYS;
+    }
+
+    std::uint8_t mask = 0;
+    for (const auto& day : days) {
+        std::string name;
+        for (char c : day) {
+            name.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+        }
+        for (size_t i = 0; i < 7; ++i) {
+            if (name == DAY_NAMES[i] || (name.size() == 3 && std::string(DAY_NAMES[i]).compare(0, 3, name) == 0)) {
+                mask |= static_cast<std::uint8_t>(1u << i);
+            }
+        }
+    }
+    return mask;
+}
+
+std::string HourOfWeekMask::formatDays(std::uint8_t days) {
+    if ((days & ALL_DAYS) == ALL_DAYS) {
+        return "every day";
+    }
+
+    std::string text;
+    for (size_t i = 0; i < 7; ++i) {
+        if (days & (1u << i)) {
+            std::string name(DAY_NAMES[i], 3);
+            name[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(name[0])));
+            text += (text.empty() ? "" : ",") + name;
+        }
+    }
+    return text;
+}
\ No newline at end of file
@@ -0,0 +1,234 @@
+#include "HttpTransport.h"
+
+namespace {
+    std::mutex shared_transport_mutex;
+    std::shared_ptr<HttpTransport> shared_transport;
+}
+
+HttpTransport::HttpTransport(std::shared_ptr<ConnectionPool> connection_pool)
+    : connection_pool_(connection_pool ? connection_pool : ConnectionPool::getShared()),
+      multi_(curl_multi_init()), stopping_(false), in_flight_(0) {
+    if (multi_) {
+        curl_multi_setopt(multi_, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+        curl_multi_setopt(multi_, CURLMOPT_MAX_HOST_CONNECTIONS,
+                          static_cast<long>(connection_pool_->getOptions().max_size));
+        io_thread_ = std::thread(&HttpTransport::run, this);
+    }
+}
+
+HttpTransport::~HttpTransport() {
+    stopping_ = true;
+    if (multi_) {
+        curl_multi_wakeup(multi_);
+    }
+    if (io_thread_.joinable()) {
+        io_thread_.join();
+    }
+
+    abortAll();
+
+    if (multi_) {
+        curl_multi_cleanup(multi_);
+    }
+}
+
+void HttpTransport::submit(Request request, CompletionCallback on_complete) {
+    auto transfer = std::make_unique<Transfer>();
+    transfer->request = std::move(request);
+    transfer->on_complete = std::move(on_complete);
+
+    if (!multi_ || stopping_) {
+        transfer->on_complete({false, 0, "", "HTTP transport is not running", CURLE_FAILED_INIT});
+        return;
+    }
+
+    in_flight_++;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        pending_.push_back(std::move(transfer));
+    }
+    curl_multi_wakeup(multi_);
+}
+
+void HttpTransport::cancel(const CancelFlag& flag) {
+    if (!flag) {
+        return;
+    }
+    *flag = true;
+    if (multi_) {
+        curl_multi_wakeup(multi_);
+    }
+}
+
+std::shared_ptr<HttpTransport> HttpTransport::getShared() {
+    std::lock_guard<std::mutex> lock(shared_transport_mutex);
+    if (!shared_transport) {
+        shared_transport = std::make_shared<HttpTransport>();
+    }
+    return shared_transport;
+}
+
+void HttpTransport::setShared(std::shared_ptr<HttpTransport> transport) {
+    std::lock_guard<std::mutex> lock(shared_transport_mutex);
+    shared_transport = std::move(transport);
+}
+
+void HttpTransport::run() {
+    while (!stopping_) {
+        startPending();
+        abortCancelled();
+
+        int running = 0;
+        curl_multi_perform(multi_, &running);
+        completeFinished();
+
+        curl_multi_poll(multi_, nullptr, 0, 1000, nullptr);
+    }
+}
+
+void HttpTransport::startPending() {
+    std::vector<std::unique_ptr<Transfer>> batch;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        batch.swap(pending_);
+    }
+
+    for (auto& transfer : batch) {
+        if (transfer->request.cancel && *transfer->request.cancel) {
+            finish(std::move(transfer), CURLE_ABORTED_BY_CALLBACK);
+            continue;
+        }
+        CURL* handle = connection_pool_->acquireHandle();
+        if (!handle) {
+            finish(std::move(transfer), CURLE_FAILED_INIT);
+            continue;
+        }
+        transfer->handle = handle;
+
+        for (const auto& header : transfer->request.headers) {
+            transfer->header_list = curl_slist_append(transfer->header_list, header.c_str());
+        }
+
+        curl_easy_setopt(handle, CURLOPT_URL, transfer->request.url.c_str());
+        curl_easy_setopt(handle, CURLOPT_POSTFIELDS, transfer->request.body.c_str());
+        curl_easy_setopt(handle, CURLOPT_POSTFIELDSIZE, static_cast<long>(transfer->request.body.size()));
+        curl_easy_setopt(handle, CURLOPT_HTTPHEADER, transfer->header_list);
+        curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, &HttpTransport::writeBody);
+        curl_easy_setopt(handle, CURLOPT_WRITEDATA, transfer.get());
+        curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+        // Waiting to multiplex only pays where HTTP/2 can be negotiated, which is over TLS;
+        // on a cleartext HTTP/1.1 host it would hold every other transfer until one finishes
+        if (transfer->request.url.compare(0, 8, "https://") == 0) {
+            curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+        }
+        if (transfer->request.connect_timeout.count() > 0) {
+            curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT_MS, static_cast<long>(transfer->request.connect_timeout.count()));
+        }
+        if (transfer->request.timeout.count() > 0) {
+            curl_easy_setopt(handle, CURLOPT_TIMEOUT_MS, static_cast<long>(transfer->request.timeout.count()));
+        }
+
+        if (curl_multi_add_handle(multi_, handle) != CURLM_OK) {
+            finish(std::move(transfer), CURLE_FAILED_INIT);
+            continue;
+        }
+        active_[handle] = std::move(transfer);
+    }
+}
+
+void HttpTransport::completeFinished() {
+    int remaining = 0;
+    while (CURLMsg* message = curl_multi_info_read(multi_, &remaining)) {
+        if (message->msg != CURLMSG_DONE) {
+            continue;
+        }
+
+        CURL* handle = message->easy_handle;
+        CURLcode result = message->data.result;
+        curl_multi_remove_handle(multi_, handle);
+
+        auto it = active_.find(handle);
+        if (it == active_.end()) {
+            continue;
+        }
+        auto transfer = std::move(it->second);
+        active_.erase(it);
+        finish(std::move(transfer), result);
+    }
+}
+
+void HttpTransport::abortCancelled() {
+    for (auto it = active_.begin(); it != active_.end();) {
+        const CancelFlag& cancel = it->second->request.cancel;
+        if (!cancel || !*cancel) {
+            ++it;
+            continue;
+        }
+        curl_multi_remove_handle(multi_, it->first);
+        auto transfer = std::move(it->second);
+        it = active_.erase(it);
+        finish(std::move(transfer), CURLE_ABORTED_BY_CALLBACK);
+    }
+}
+
+void HttpTransport::finish(std::unique_ptr<Transfer> transfer, CURLcode result) {
+    Response response{result == CURLE_OK, 0, std::move(transfer->response_body), "", result};
+
+    if (transfer->handle) {
+        curl_easy_getinfo(transfer->handle, CURLINFO_RESPONSE_CODE, &response.status_code);
+        // libcurl parses both the delay-seconds and HTTP-date forms
+        curl_off_t retry_after = 0;
+        if (curl_easy_getinfo(transfer->handle, CURLINFO_RETRY_AFTER, &retry_after) == CURLE_OK && retry_after > 0) {
+            response.retry_after = std::chrono::seconds(retry_after);
+        }
+        curl_easy_setopt(transfer->handle, CURLOPT_HTTPHEADER, nullptr);
+        connection_pool_->release(transfer->handle);
+        transfer->handle = nullptr;
+    }
+    if (transfer->header_list) {
+        curl_slist_free_all(transfer->header_list);
+        transfer->header_list = nullptr;
+    }
+
+    if (result != CURLE_OK) {
+        response.error_message = curl_easy_strerror(result);
+    }
+
+    in_flight_--;
+    if (transfer->on_complete) {
+        transfer->on_complete(std::move(response));
+    }
+}
+
+void HttpTransport::abortAll() {
+    for (auto& entry : active_) {
+        curl_multi_remove_handle(multi_, entry.first);
+        finish(std::move(entry.second), CURLE_ABORTED_BY_CALLBACK);
+    }
+    active_.clear();
+
+    std::vector<std::unique_ptr<Transfer>> batch;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        batch.swap(pending_);
+    }
+    for (auto& transfer : batch) {
+        finish(std::move(transfer), CURLE_ABORTED_BY_CALLBACK);
+    }
+}
+
+size_t HttpTransport::writeBody(void* contents, size_t size, size_t nmemb, void* userp) {
+    auto* transfer = static_cast<Transfer*>(userp);
+    size_t bytes = size * nmemb;
+
+    if (transfer->request.on_data) {
+        long status_code = 0;
+        curl_easy_getinfo(transfer->handle, CURLINFO_RESPONSE_CODE, &status_code);
+        if (status_code < 400) {
+            return transfer->request.on_data(static_cast<char*>(contents), bytes) ? bytes : 0;
+        }
+    }
+
+    transfer->response_body.append(static_cast<char*>(contents), bytes);
+    return bytes;
+}
\ No newline at end of file
@@ -1,36 +1,49 @@
 #include "OpenAIService.h"
-#include <thread>
 
 const std::string OpenAIService::OPENAI_BASE_URL = "https://api.openai.com/v1";
 const std::string OpenAIService::MODEL_NAME = "gpt-3.5-turbo";
 
-OpenAIService::OpenAIService(const std::string& api_key) 
+OpenAIService::OpenAIService(const std::string& api_key)
     : AIService(api_key, OPENAI_BASE_URL) {
 }
 
 std::future<AIService::AIResponse> OpenAIService::generateResponse(const std::string& prompt) {
-    return std::async(std::launch::async, [this, prompt]() {
-        nlohmann::json payload = {
-            {"model", MODEL_NAME},
-            {"messages", nlohmann::json::array({
-                {{"role", "user"}, {"content", prompt}}
-            })},
-            {"max_tokens", 1000}
-        };
-        
-        auto response = makeRequest("/chat/completions", payload);
+    return toFuture([this, prompt](ResponseCallback on_complete) {
+        generateResponse(prompt, std::move(on_complete));
+    });
+}
+
+void OpenAIService::generateResponse(const std::string& prompt, ResponseCallback on_complete,
+                                     CancelFlag cancel) {
+    if (respondFromCache(prompt, on_complete)) {
+        return;
+    }
+    on_complete = storeInCache(prompt, std::move(on_complete));
+    
+    nlohmann::json payload = {
+        {"model", MODEL_NAME},
+        {"messages", nlohmann::json::array({
+            {{"role", "user"}, {"content", prompt}}
+        })},
+        {"max_tokens", 1000}
+    };
+    
+    makeRequestAsync("/chat/completions", payload, [on_complete](AIResponse response) {
         if (!response.success) {
-            return response;
+            on_complete(std::move(response));
+            return;
         }
         
+        AIResponse result;
         try {
             auto json_response = nlohmann::json::parse(response.content);
             std::string content = json_response["choices"][0]["message"]["content"];
-            return AIResponse{true, content, ""};
+            result = AIResponse{true, content, ""};
         } catch (const std::exception& e) {
-            return AIResponse{false, "", "Failed to parse OpenAI response: " + std::string(e.what())};
+            result = AIResponse{false, "", "Failed to parse OpenAI response: " + std::string(e.what())};
         }
-    });
+        on_complete(std::move(result));
+    }, std::move(cancel));
 }
 
 std::future<AIService::AIResponse> OpenAIService::analyzePreferences(const std::string& user_data) {
@@ -41,9 +54,62 @@ std::future<AIService::AIResponse> OpenAIService::analyzePreferences(const std::
 std::future<AIService::AIResponse> OpenAIService::recommendEvents(
     const std::string& preferences, 
     const std::string& available_events) {
+    return generateResponse(buildRecommendationPrompt(preferences, available_events));
+}
+
+void OpenAIService::streamResponse(const std::string& prompt, DeltaCallback on_delta,
+                                   ResponseCallback on_complete) {
+    auto replay_cached = [on_delta, on_complete](AIResponse response) {
+        if (response.success) {
+            on_delta(response.content);
+        }
+        on_complete(std::move(response));
+    };
+    if (respondFromCache(prompt, replay_cached)) {
+        return;
+    }
+    on_complete = storeInCache(prompt, std::move(on_complete));
     
-    std::string prompt = "Based on these user preferences:\n" + preferences + 
-                        "\n\nRecommend events from this list:\n" + available_events +
-                        "\n\nProvide a ranked list with explanations.";
-    return generateResponse(prompt);
+    nlohmann::json payload = {
+        {"model", MODEL_NAME},
+        {"stream", true},
+        {"messages", nlohmann::json::array({
+            {{"role", "user"}, {"content", prompt}}
+        })},
+        {"max_tokens", 1000}
+    };
+    
+    auto text = std::make_shared<std::string>();
+    auto stream_error = std::make_shared<std::string>();
+    
+    makeStreamingRequestAsync("/chat/completions", payload,
+        [on_delta, text, stream_error](const std::string&, const std::string& data) {
+            if (data == "[DONE]") {
+                return;
+            }
+            
+            try {
+                auto json_event = nlohmann::json::parse(data);
+                if (json_event.contains("error")) {
+                    *stream_error = json_event["error"].dump();
+                    return;
+                }
+                const auto& delta = json_event["choices"][0]["delta"];
+                if (delta.contains("content") && delta["content"].is_string()) {
+                    std::string content = delta["content"];
+                    *text += content;
+                    on_delta(content);
+                }
+            } catch (const std::exception& e) {
+                *stream_error = "Failed to parse OpenAI stream event: " + std::string(e.what());
+            }
+        },
+        [on_complete, text, stream_error](AIResponse response) {
+            if (response.success && !stream_error->empty()) {
+                response = AIResponse{false, "", "OpenAI stream error: " + *stream_error};
+            } else if (response.success) {
+                response.content = *text;
+            }
+            on_complete(std::move(response));
+        });
 }
\ No newline at end of file
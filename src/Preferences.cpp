@@ -1,19 +1,35 @@
 #include "Preferences.h"
 
-Preferences::Preferences() : max_travel_distance_(10.0) {
+Preferences::Preferences()
+    : max_travel_distance_(10.0), coordinates_{0.0, 0.0}, has_coordinates_(false) {
+    hour_of_week_mask_.setAll();
+    time_zone_ = TimeZone::get("");
+    if (!time_zone_) {
+        time_zone_ = TimeZone::utc();
+    }
 }
 
 void Preferences::addInterest(const std::string& interest, int weight) {
     interests_[interest] = weight;
+    setCompiledWeight(interest, weight);
 }
 
 void Preferences::removeInterest(const std::string& interest) {
-    interests_.erase(interest);
+    if (interests_.erase(interest) == 0) {
+        return;
+    }
+    
+    TagInterner::TagId tag = TagInterner::global().find(interest);
+    if (tag < interest_mask_.size()) {
+        interest_mask_[tag] = 0;
+        interest_weights_[tag] = 0;
+    }
 }
 
 void Preferences::setInterestWeight(const std::string& interest, int weight) {
     if (interests_.find(interest) != interests_.end()) {
         interests_[interest] = weight;
+        setCompiledWeight(interest, weight);
     }
 }
 
@@ -23,5 +39,38 @@ int Preferences::getInterestWeight(const std::string& interest) const {
 }
 
 void Preferences::setPreferredTimeSlots(const std::vector<std::pair<int, int>>& time_slots) {
-    preferred_time_slots_ = time_slots;
+    preferred_time_slots_.clear();
+    preferred_time_slot_days_.clear();
+    hour_of_week_mask_.setAll();
+    for (const auto& slot : time_slots) {
+        addPreferredTimeSlot(slot.first, slot.second);
+    }
+}
+
+void Preferences::addPreferredTimeSlot(int start_hour, int end_hour, std::uint8_t days) {
+    if (preferred_time_slots_.empty()) {
+        hour_of_week_mask_.clear();
+    }
+    preferred_time_slots_.push_back({start_hour, end_hour});
+    preferred_time_slot_days_.push_back(days);
+    hour_of_week_mask_.addSlot(start_hour, end_hour, days);
+}
+
+bool Preferences::setTimeZone(const std::string& time_zone) {
+    auto zone = TimeZone::get(time_zone);
+    if (!zone) {
+        return false;
+    }
+    time_zone_ = zone;
+    return true;
+}
+
+void Preferences::setCompiledWeight(const std::string& interest, int weight) {
+    TagInterner::TagId tag = TagInterner::global().intern(interest);
+    if (tag >= interest_mask_.size()) {
+        interest_weights_.resize(tag + 1, 0);
+        interest_mask_.resize(tag + 1, 0);
+    }
+    interest_weights_[tag] = weight;
+    interest_mask_[tag] = 1;
 }
\ No newline at end of file
@@ -0,0 +1,206 @@
+#include "RateLimiter.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+struct RateLimiter::State {
+    struct Bucket {
+        double rate_per_second;
+        double capacity;
+        double available;
+    };
+
+    struct Waiter {
+        double tokens;
+        ReadyCallback on_ready;
+        Clock::time_point queued_at;
+    };
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    // Ordered by earliest release time, then arrival
+    std::multimap<std::pair<Clock::time_point, std::uint64_t>, Waiter> waiters;
+    std::uint64_t next_sequence = 0;
+    Bucket requests;
+    Bucket tokens;
+    Clock::time_point refilled_at;
+    Clock::time_point paused_until;
+    std::thread thread;
+    bool stopping = false;
+
+    size_t granted = 0;
+    size_t delayed = 0;
+    size_t pauses = 0;
+    Clock::duration total_delay{0};
+
+    explicit State(const Options& options)
+        : requests(makeBucket(options.requests_per_minute)), tokens(makeBucket(options.tokens_per_minute)),
+          refilled_at(Clock::now()) {}
+
+    void refill(Clock::time_point now) {
+        double elapsed = std::chrono::duration<double>(now - refilled_at).count();
+        if (elapsed <= 0) {
+            return;
+        }
+        refilled_at = now;
+        for (Bucket* bucket : {&requests, &tokens}) {
+            bucket->available = std::min(bucket->capacity, bucket->available + bucket->rate_per_second * elapsed);
+        }
+    }
+
+    // Earliest time a waiter can go; now or earlier means it can go immediately
+    Clock::time_point readyAt(double cost, Clock::time_point not_before) const {
+        auto refill_time = [this](const Bucket& bucket, double needed) {
+            if (bucket.rate_per_second <= 0 || bucket.available >= needed) {
+                return refilled_at;
+            }
+            auto wait = std::chrono::duration<double>((needed - bucket.available) / bucket.rate_per_second);
+            // Round up so the bucket is full enough on wake-up
+            return refilled_at + std::chrono::ceil<Clock::duration>(wait);
+        };
+        Clock::time_point ready_at = std::max(not_before, paused_until);
+        ready_at = std::max(ready_at, refill_time(requests, 1.0));
+        return std::max(ready_at, refill_time(tokens, cost));
+    }
+
+    void take(double cost) {
+        if (requests.rate_per_second > 0) {
+            requests.available -= 1.0;
+        }
+        if (tokens.rate_per_second > 0) {
+            tokens.available -= cost;
+        }
+        granted++;
+    }
+
+    static Bucket makeBucket(double per_minute) {
+        if (per_minute <= 0) {
+            return {0, std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()};
+        }
+        return {per_minute / 60.0, per_minute, per_minute};
+    }
+};
+
+RateLimiter::RateLimiter() : RateLimiter(Options()) {
+}
+
+RateLimiter::RateLimiter(const Options& options)
+    : options_(options), state_(std::make_shared<State>(options)) {
+}
+
+RateLimiter::~RateLimiter() {
+    std::thread thread;
+    decltype(state_->waiters) waiters;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->stopping = true;
+        thread = std::move(state_->thread);
+        waiters.swap(state_->waiters);
+    }
+    state_->wake.notify_all();
+    if (thread.joinable()) {
+        if (thread.get_id() == std::this_thread::get_id()) {
+            thread.detach();
+        } else {
+            thread.join();
+        }
+    }
+
+    // Release anyone still queued so their requests complete rather than hang
+    for (auto& waiter : waiters) {
+        waiter.second.on_ready();
+    }
+}
+
+void RateLimiter::acquire(size_t tokens, ReadyCallback on_ready, Clock::time_point not_before) {
+    State& state = *state_;
+    double cost = static_cast<double>(tokens);
+    if (state.tokens.rate_per_second > 0) {
+        cost = std::min(cost, state.tokens.capacity);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        Clock::time_point now = Clock::now();
+        state.refill(now);
+        if (state.waiters.empty() && state.readyAt(cost, not_before) <= now) {
+            state.take(cost);
+        } else {
+            // The thread is only started once something has to wait
+            if (!state.thread.joinable()) {
+                state.thread = std::thread(&RateLimiter::run, state_);
+            }
+            state.waiters.emplace(std::make_pair(std::max(not_before, now), state.next_sequence++),
+                                  State::Waiter{cost, std::move(on_ready), now});
+            state.delayed++;
+            on_ready = nullptr;
+        }
+    }
+
+    if (on_ready) {
+        on_ready();
+    } else {
+        state.wake.notify_all();
+    }
+}
+
+void RateLimiter::acquire(size_t tokens) {
+    std::promise<void> ready;
+    auto future = ready.get_future();
+    acquire(tokens, [&ready]() { ready.set_value(); });
+    future.wait();
+}
+
+void RateLimiter::pauseUntil(Clock::time_point until) {
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (until <= state_->paused_until) {
+            return;
+        }
+        state_->paused_until = until;
+        state_->pauses++;
+    }
+    state_->wake.notify_all();
+}
+
+RateLimiter::Stats RateLimiter::getStats() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return {state_->granted, state_->delayed, state_->pauses, state_->waiters.size(),
+            std::chrono::duration_cast<std::chrono::milliseconds>(state_->total_delay)};
+}
+
+void RateLimiter::run(std::shared_ptr<State> state) {
+    std::unique_lock<std::mutex> lock(state->mutex);
+    while (!state->stopping) {
+        if (state->waiters.empty()) {
+            state->wake.wait(lock);
+            continue;
+        }
+
+        Clock::time_point now = Clock::now();
+        state->refill(now);
+        auto head = state->waiters.begin();
+        Clock::time_point ready_at = state->readyAt(head->second.tokens, head->first.first);
+        if (ready_at > now) {
+            state->wake.wait_until(lock, ready_at);
+            continue;
+        }
+
+        state->take(head->second.tokens);
+        state->total_delay += now - head->second.queued_at;
+        ReadyCallback on_ready = std::move(head->second.on_ready);
+        state->waiters.erase(head);
+
+        lock.unlock();
+        on_ready();
+        // May destroy the limiter; only the state is touched from here on
+        on_ready = nullptr;
+        lock.lock();
+    }
+}
\ No newline at end of file
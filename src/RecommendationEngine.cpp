@@ -1,10 +1,15 @@
 #include "RecommendationEngine.h"
+#include "BatchScorer.h"
 #include <algorithm>
+#include <cctype>
 #include <cmath>
+#include <ctime>
+#include <iterator>
 #include <sstream>
+#include <unordered_map>
 
 RecommendationEngine::RecommendationEngine(std::shared_ptr<AIService> ai_service)
-    : ai_service_(ai_service) {
+    : ai_service_(ai_service), prompt_token_budget_(2000), last_prompt_tokens_(0) {
 }
 
 std::vector<RecommendationEngine::EventRecommendation> RecommendationEngine::recommendEvents(
@@ -13,45 +18,354 @@ std::vector<RecommendationEngine::EventRecommendation> RecommendationEngine::rec
     const Schedule& user_schedule,
     int max_recommendations) {
     
-    std::vector<EventRecommendation> recommendations;
     const auto& preferences = user.getPreferences();
+    auto recommendations = rankEvents(preferences, available_events, user_schedule, max_recommendations);
+    requestAIReasoning(preferences, recommendations, nullptr);
+    return recommendations;
+}
+
+std::vector<RecommendationEngine::EventRecommendation> RecommendationEngine::recommendEvents(
+    const User& user,
+    const std::vector<Event>& available_events,
+    const Schedule& user_schedule,
+    int max_recommendations,
+    const StreamCallback& on_ai_delta) {
     
-    for (const auto& event : available_events) {
-        if (user_schedule.hasConflict(event)) {
-            continue;
-        }
+    const auto& preferences = user.getPreferences();
+    auto recommendations = rankEvents(preferences, available_events, user_schedule, max_recommendations);
+    requestAIReasoning(preferences, recommendations, on_ai_delta);
+    return recommendations;
+}
+
+std::vector<RecommendationEngine::EventRecommendation> RecommendationEngine::recommendEvents(
+    const User& user,
+    const EventStore& available_events,
+    const Schedule& user_schedule,
+    int max_recommendations) {
+    
+    const auto& preferences = user.getPreferences();
+    auto recommendations = rankEvents(preferences, available_events, user_schedule, max_recommendations);
+    requestAIReasoning(preferences, recommendations, nullptr);
+    return recommendations;
+}
+
+std::vector<std::vector<RecommendationEngine::EventRecommendation>> RecommendationEngine::recommendEventsForUsers(
+    const std::vector<BatchUser>& users,
+    const EventStore& available_events,
+    int max_recommendations) {
+    
+    std::vector<BatchScorer::Profile> profiles;
+    profiles.reserve(users.size());
+    for (const auto& user : users) {
+        profiles.push_back(BatchScorer::compile(*user.preferences));
+    }
+    
+    std::vector<TopKSelector> tops(users.size(), TopKSelector(static_cast<size_t>(std::max(max_recommendations, 0))));
+    
+    // Every worker walks the whole catalog once for its group of users, scoring each
+    // tile against all of them while the tile's columns are still in cache
+    auto score_users = [&](size_t first_user, size_t last_user) {
+        const auto& start_times = available_events.getStartTimes();
+        const auto& end_times = available_events.getEndTimes();
+        BatchScorer::Tile tile;
+        double scores[BatchScorer::TILE_SIZE];
+        bool in_range[BatchScorer::TILE_SIZE];
         
-        double score = calculateEventScore(event, preferences);
-        recommendations.push_back({event, score, "Basic compatibility score"});
+        for (size_t first = 0; first < available_events.size(); first += BatchScorer::TILE_SIZE) {
+            BatchScorer::loadTile(available_events, static_cast<EventStore::EventId>(first),
+                                  available_events.size() - first, tile);
+            
+            for (size_t u = first_user; u < last_user; ++u) {
+                BatchScorer::scoreTile(tile, profiles[u], scores, in_range);
+                const Schedule& schedule = *users[u].schedule;
+                for (size_t i = 0; i < tile.count; ++i) {
+                    EventStore::EventId id = tile.ids[i];
+                    if (in_range[i] && available_events.isActive(id) && tops[u].wouldAccept(scores[i], id) &&
+                        !schedule.hasConflict(start_times[id], end_times[id])) {
+                        tops[u].offer(scores[i], id);
+                    }
+                }
+            }
+        }
+    };
+    
+    if (thread_pool_ && users.size() > USER_GROUP_SIZE) {
+        thread_pool_->parallelFor(users.size(), USER_GROUP_SIZE,
+                                  [&](size_t, size_t begin, size_t end) { score_users(begin, end); });
+    } else {
+        score_users(0, users.size());
+    }
+    
+    std::vector<std::vector<EventRecommendation>> results(users.size());
+    for (size_t u = 0; u < users.size(); ++u) {
+        for (const auto& entry : tops[u].take()) {
+            results[u].push_back({available_events.materialize(static_cast<EventStore::EventId>(entry.index)),
+                                  entry.score, "Basic compatibility score"});
+        }
+    }
+    return results;
+}
+
+std::vector<RecommendationEngine::EventRecommendation> RecommendationEngine::recommendEvents(
+    const User& user,
+    const EventSource& next_event,
+    const Schedule& user_schedule,
+    int max_recommendations) {
+    
+    const auto& preferences = user.getPreferences();
+    auto recommendations = rankEvents(preferences, next_event, user_schedule, max_recommendations);
+    requestAIReasoning(preferences, recommendations, nullptr);
+    return recommendations;
+}
+
+std::vector<RecommendationEngine::EventRecommendation> RecommendationEngine::rankEvents(
+    const Preferences& preferences,
+    const std::vector<Event>& available_events,
+    const Schedule& user_schedule,
+    int max_recommendations) {
+    
+    // Select by index; only the winners are copied out of available_events
+    auto top = selectTop(available_events.size(), max_recommendations,
+        [&](size_t begin, size_t end, TopKSelector& partial) {
+            for (size_t i = begin; i < end; ++i) {
+                const auto& event = available_events[i];
+                if (!isWithinTravelDistance(event, preferences) ||
+                    user_schedule.hasConflict(event.getStartTime(), event.getEndTime())) {
+                    continue;
+                }
+                partial.offer(calculateEventScore(event, preferences), i);
+            }
+        });
+    
+    std::vector<EventRecommendation> recommendations;
+    for (const auto& entry : top.take()) {
+        recommendations.push_back({available_events[entry.index], entry.score, "Basic compatibility score"});
     }
+    return recommendations;
+}
+
+std::vector<RecommendationEngine::EventRecommendation> RecommendationEngine::rankEvents(
+    const Preferences& preferences,
+    const EventStore& available_events,
+    const Schedule& user_schedule,
+    int max_recommendations) {
     
-    std::sort(recommendations.begin(), recommendations.end(),
-              [](const EventRecommendation& a, const EventRecommendation& b) {
-                  return a.score > b.score;
-              });
+    const auto& start_times = available_events.getStartTimes();
+    const auto& end_times = available_events.getEndTimes();
     
-    if (recommendations.size() > max_recommendations) {
-        recommendations.resize(max_recommendations);
+    auto profile = BatchScorer::compile(preferences);
+    TopKSelector top(static_cast<size_t>(std::max(max_recommendations, 0)));
+    if (top.capacity() == 0) {
+        return {};
     }
     
-    auto ai_response = ai_service_->recommendEvents(
-        formatPreferences(preferences),
-        formatEventData(available_events)
-    );
+    // Scores the given rows (on the pool when large enough) and folds the winners into top
+    auto score_rows = [&](const std::vector<EventStore::EventId>& rows) {
+        top.merge(selectTop(rows.size(), max_recommendations,
+            [&](size_t begin, size_t end, TopKSelector& partial) {
+                BatchScorer::Tile tile;
+                double scores[BatchScorer::TILE_SIZE];
+                bool in_range[BatchScorer::TILE_SIZE];
+                for (size_t first = begin; first < end; first += BatchScorer::TILE_SIZE) {
+                    BatchScorer::loadTile(available_events, rows.data() + first, end - first, tile);
+                    BatchScorer::scoreTile(tile, profile, scores, in_range);
+                    
+                    for (size_t i = 0; i < tile.count; ++i) {
+                        EventStore::EventId id = tile.ids[i];
+                        if (in_range[i] && !user_schedule.hasConflict(start_times[id], end_times[id])) {
+                            partial.offer(scores[i], id);
+                        }
+                    }
+                }
+            }));
+    };
     
-    try {
-        auto result = ai_response.get();
-        if (result.success) {
-            for (auto& rec : recommendations) {
-                rec.reasoning = "AI-enhanced reasoning: " + result.content.substr(0, 100);
+    // With user coordinates, only events inside the travel radius (plus those with no
+    // coordinates to judge by) are eligible
+    std::vector<EventStore::EventId> eligible;
+    bool filtered = preferences.hasCoordinates();
+    if (filtered) {
+        std::vector<EventStore::EventId> nearby;
+        available_events.getGeoIndex().queryRadius(preferences.getCoordinates(),
+                                                   preferences.getMaxTravelDistance(), nearby);
+        const auto& without_coordinates = available_events.getEventsWithoutCoordinates();
+        eligible.reserve(nearby.size() + without_coordinates.size());
+        std::merge(nearby.begin(), nearby.end(), without_coordinates.begin(), without_coordinates.end(),
+                   std::back_inserter(eligible));
+    } else {
+        eligible.reserve(available_events.getActiveCount());
+        for (EventStore::EventId id = 0; id < available_events.size(); ++id) {
+            if (available_events.isActive(id)) {
+                eligible.push_back(id);
             }
         }
-    } catch (const std::exception& e) {
     }
     
+    // Posting lists are keyed by the global tag ids the compiled interests use
+    if (&available_events.getTagInterner() != &TagInterner::global() || preferences.getInterests().empty()) {
+        score_rows(eligible);
+    } else {
+        std::vector<std::uint8_t> allowed;
+        if (filtered) {
+            allowed.assign(available_events.size(), 0);
+            for (auto id : eligible) {
+                allowed[id] = 1;
+            }
+        }
+        
+        // Visit interests from the highest weight down. An event not yet scored when a term
+        // is reached matches no heavier interest, so its interest average is at most that
+        // term's weight; once that bound cannot beat the current k-th score, stop (WAND).
+        const auto& interest_mask = preferences.getInterestMask();
+        const auto& interest_weights = preferences.getInterestWeights();
+        std::vector<std::pair<int, TagInterner::TagId>> terms;
+        for (TagInterner::TagId tag = 0; tag < interest_mask.size(); ++tag) {
+            if (interest_mask[tag] && !available_events.getPostings(tag).empty()) {
+                terms.push_back({interest_weights[tag], tag});
+            }
+        }
+        std::sort(terms.begin(), terms.end(),
+                  [](const std::pair<int, TagInterner::TagId>& a, const std::pair<int, TagInterner::TagId>& b) {
+                      return a.first != b.first ? a.first > b.first : a.second < b.second;
+                  });
+        
+        std::vector<std::uint8_t> scored(available_events.size(), 0);
+        std::vector<EventStore::EventId> rows;
+        for (const auto& term : terms) {
+            if (top.full() && BatchScorer::getUpperBound(profile, term.first) < top.worst().score) {
+                break;
+            }
+            rows.clear();
+            for (auto id : available_events.getPostings(term.second)) {
+                if (!scored[id] && (!filtered || allowed[id])) {
+                    scored[id] = 1;
+                    rows.push_back(id);
+                }
+            }
+            score_rows(rows);
+        }
+        
+        // Everything left has an interest score of at most zero (or of a skipped term)
+        if (!top.full() || BatchScorer::getUpperBound(profile, 0.0) >= top.worst().score) {
+            rows.clear();
+            for (auto id : eligible) {
+                if (!scored[id]) {
+                    rows.push_back(id);
+                }
+            }
+            score_rows(rows);
+        }
+    }
+    
+    std::vector<EventRecommendation> recommendations;
+    for (const auto& entry : top.take()) {
+        recommendations.push_back({available_events.materialize(static_cast<EventStore::EventId>(entry.index)),
+                                   entry.score, "Basic compatibility score"});
+    }
     return recommendations;
 }
 
+std::vector<RecommendationEngine::EventRecommendation> RecommendationEngine::rankEvents(
+    const Preferences& preferences,
+    const EventSource& next_event,
+    const Schedule& user_schedule,
+    int max_recommendations) {
+    
+    // Events are numbered in arrival order; a copy is kept only while it is in the top k
+    TopKSelector top(static_cast<size_t>(std::max(max_recommendations, 0)));
+    std::unordered_map<size_t, Event> kept;
+    
+    size_t index = 0;
+    for (const Event* event = next_event(); event != nullptr; event = next_event(), ++index) {
+        if (!isWithinTravelDistance(*event, preferences) ||
+            user_schedule.hasConflict(event->getStartTime(), event->getEndTime())) {
+            continue;
+        }
+        
+        double score = calculateEventScore(*event, preferences);
+        if (!top.wouldAccept(score, index)) {
+            continue;
+        }
+        if (top.full()) {
+            kept.erase(top.worst().index);
+        }
+        top.offer(score, index);
+        kept.emplace(index, *event);
+    }
+    
+    std::vector<EventRecommendation> recommendations;
+    for (const auto& entry : top.take()) {
+        recommendations.push_back({std::move(kept.at(entry.index)), entry.score, "Basic compatibility score"});
+    }
+    return recommendations;
+}
+
+TopKSelector RecommendationEngine::selectTop(size_t count, int max_recommendations,
+                                             const CollectRange& collect) {
+    size_t k = static_cast<size_t>(std::max(max_recommendations, 0));
+    TopKSelector top(k);
+    
+    if (!thread_pool_ || count <= PARALLEL_GRAIN) {
+        collect(0, count, top);
+        return top;
+    }
+    
+    // One selector per worker; (score, index) is a total order, so the merged result
+    // is the same whichever worker scored which chunk
+    std::vector<TopKSelector> partials(thread_pool_->getThreadCount(), TopKSelector(k));
+    thread_pool_->parallelFor(count, PARALLEL_GRAIN, [&](size_t worker, size_t begin, size_t end) {
+        collect(begin, end, partials[worker]);
+    });
+    for (const auto& partial : partials) {
+        top.merge(partial);
+    }
+    return top;
+}
+
+void RecommendationEngine::setThreadCount(size_t thread_count) {
+    if (thread_count <= 1) {
+        thread_pool_.reset();
+    } else if (!thread_pool_ || thread_pool_->getThreadCount() != thread_count) {
+        thread_pool_ = std::make_unique<ThreadPool>(thread_count);
+    }
+}
+
+size_t RecommendationEngine::getThreadCount() const {
+    return thread_pool_ ? thread_pool_->getThreadCount() : 1;
+}
+
+void RecommendationEngine::requestAIReasoning(const Preferences& preferences,
+                                              std::vector<EventRecommendation>& recommendations,
+                                              const StreamCallback& on_ai_delta) {
+    std::string preferences_text, events_text;
+    buildPromptSections(preferences, recommendations, preferences_text, events_text);
+    
+    std::future<AIService::AIResponse> ai_response;
+    if (on_ai_delta) {
+        ai_response = AIService::toFuture([&](AIService::ResponseCallback on_complete) {
+            ai_service_->streamRecommendEvents(preferences_text, events_text, on_ai_delta, std::move(on_complete));
+        });
+    } else {
+        ai_response = ai_service_->recommendEvents(preferences_text, events_text);
+    }
+    
+    try {
+        applyAIReasoning(recommendations, ai_response.get());
+    } catch (const std::exception& e) {
+        last_ai_error_ = e.what();
+    }
+}
+
+void RecommendationEngine::applyAIReasoning(std::vector<EventRecommendation>& recommendations,
+                                            const AIService::AIResponse& result) {
+    last_ai_error_ = result.error_message;
+    if (result.success) {
+        for (auto& rec : recommendations) {
+            rec.reasoning = "AI-enhanced reasoning: " + result.content.substr(0, 100);
+        }
+    }
+}
+
 void RecommendationEngine::updateUserInterests(User& user, const std::vector<Event>& attended_events) {
     auto& preferences = user.getPreferences();
     
@@ -65,29 +379,26 @@ void RecommendationEngine::updateUserInterests(User& user, const std::vector<Eve
 
 double RecommendationEngine::calculateEventScore(const Event& event, const Preferences& preferences) {
     double interest_score = calculateInterestScore(event, preferences);
-    double time_score = calculateTimePreferenceScore(event, preferences);
-    double location_score = calculateLocationScore(event, preferences);
+    double time_score = calculateTimePreferenceScore(event.getStartTime(), preferences);
+    double location_score = calculateLocationScore(
+        event.getLocation(), event.hasCoordinates() ? &event.getCoordinates() : nullptr, preferences);
     
     return (interest_score * 0.5) + (time_score * 0.3) + (location_score * 0.2);
 }
 
-double RecommendationEngine::calculateTimePreferenceScore(const Event& event, const Preferences& preferences) {
-    auto start_time = std::chrono::system_clock::to_time_t(event.getStartTime());
-    struct tm* tm_info = std::localtime(&start_time);
-    int hour = tm_info->tm_hour;
-    
-    const auto& time_slots = preferences.getPreferredTimeSlots();
-    if (time_slots.empty()) {
-        return 1.0;
-    }
+double RecommendationEngine::calculateEventScore(const EventStore& store, EventStore::EventId id,
+                                                 const Preferences& preferences) {
+    double interest_score = calculateInterestScore(store, id, preferences);
+    double time_score = calculateTimePreferenceScore(store.getStartTimes()[id], preferences);
+    double location_score = calculateLocationScore(
+        store.getLocation(id), store.getHasCoordinates()[id] ? &store.getCoordinates()[id] : nullptr, preferences);
     
-    for (const auto& slot : time_slots) {
-        if (hour >= slot.first && hour <= slot.second) {
-            return 1.0;
-        }
-    }
-    
-    return 0.5;
+    return (interest_score * 0.5) + (time_score * 0.3) + (location_score * 0.2);
+}
+
+double RecommendationEngine::calculateTimePreferenceScore(const std::chrono::system_clock::time_point& start,
+                                                          const Preferences& preferences) {
+    return preferences.isPreferredTime(start) ? 1.0 : 0.5;
 }
 
 double RecommendationEngine::calculateInterestScore(const Event& event, const Preferences& preferences) {
@@ -106,25 +417,91 @@ double RecommendationEngine::calculateInterestScore(const Event& event, const Pr
     return matching_tags > 0 ? total_score / matching_tags : 0.0;
 }
 
-double RecommendationEngine::calculateLocationScore(const Event& event, const Preferences& preferences) {
-    if (event.getLocation().empty() || preferences.getLocation().empty()) {
+double RecommendationEngine::calculateInterestScore(const EventStore& store, EventStore::EventId id,
+                                                    const Preferences& preferences) {
+    const auto& tag_interner = store.getTagInterner();
+    double total_score = 0.0;
+    int matching_tags = 0;
+    
+    if (&tag_interner == &TagInterner::global()) {
+        // Same id space as the compiled preferences: plain array lookups
+        int weight = 0;
+        for (auto tag = store.tagsBegin(id); tag != store.tagsEnd(id); ++tag) {
+            if (preferences.findInterest(*tag, weight)) {
+                total_score += weight;
+                matching_tags++;
+            }
+        }
+    } else {
+        const auto& interests = preferences.getInterests();
+        for (auto tag = store.tagsBegin(id); tag != store.tagsEnd(id); ++tag) {
+            auto it = interests.find(tag_interner.getName(*tag));
+            if (it != interests.end()) {
+                total_score += it->second;
+                matching_tags++;
+            }
+        }
+    }
+    
+    return matching_tags > 0 ? total_score / matching_tags : 0.0;
+}
+
+double RecommendationEngine::calculateLocationScore(const std::string& location, const GeoPoint* coordinates,
+                                                    const Preferences& preferences) {
+    if (coordinates && preferences.hasCoordinates()) {
+        return preferences.getProximityScore(preferences.getTravelDistanceKm(*coordinates));
+    }
+    
+    if (location.empty() || preferences.getLocation().empty()) {
         return 0.8;
     }
     
     return 1.0;
 }
 
-std::string RecommendationEngine::formatEventData(const std::vector<Event>& events) {
+bool RecommendationEngine::isWithinTravelDistance(const Event& event, const Preferences& preferences) {
+    if (!event.hasCoordinates() || !preferences.hasCoordinates()) {
+        return true;
+    }
+    return preferences.isWithinTravelDistance(preferences.getTravelDistanceKm(event.getCoordinates()));
+}
+
+std::string RecommendationEngine::formatEventData(const std::vector<EventRecommendation>& candidates,
+                                                  const Preferences& preferences, size_t token_budget) {
+    // One compact line per candidate, best first, stopping before the budget is exceeded
     std::ostringstream oss;
-    for (const auto& event : events) {
-        oss << "Event: " << event.getName() << "\n";
-        oss << "Description: " << event.getDescription() << "\n";
-        oss << "Location: " << event.getLocation() << "\n";
-        oss << "Tags: ";
-        for (const auto& tag : event.getTags()) {
-            oss << tag << " ";
+    size_t used_tokens = 0;
+    // Start times in the user's zone, the one the time slots are given in
+    TimeZone::Cursor time_zone(preferences.getTimeZone());
+    
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        const auto& event = candidates[i].event;
+        
+        std::int64_t start_seconds = TimeZone::toUnixSeconds(event.getStartTime());
+        std::time_t local_start = static_cast<std::time_t>(start_seconds + time_zone.getOffset(start_seconds));
+        std::tm tm_info{};
+        gmtime_r(&local_start, &tm_info);
+        char start_text[32];
+        std::strftime(start_text, sizeof(start_text), "%a %Y-%m-%d %H:%M", &tm_info);
+        
+        std::ostringstream line;
+        line << (i + 1) << ". " << event.getName() << " | " << start_text << " | " << event.getLocation() << " | ";
+        for (size_t t = 0; t < event.getTags().size(); ++t) {
+            line << (t > 0 ? "," : "") << event.getTags()[t];
+        }
+        std::string description = event.getDescription();
+        if (description.size() > 120) {
+            description = description.substr(0, 117) + "...";
+        }
+        line << " | " << description << "\n";
+        
+        std::string text = line.str();
+        size_t tokens = estimateTokens(text);
+        if (used_tokens + tokens > token_budget) {
+            break;
         }
-        oss << "\n\n";
+        oss << text;
+        used_tokens += tokens;
     }
     return oss.str();
 }
@@ -136,13 +513,56 @@ std::string RecommendationEngine::formatPreferences(const Preferences& preferenc
         oss << "- " << interest.first << " (weight: " << interest.second << ")\n";
     }
     
-    oss << "\nPreferred Time Slots:\n";
-    for (const auto& slot : preferences.getPreferredTimeSlots()) {
-        oss << "- " << slot.first << ":00 to " << slot.second << ":00\n";
+    oss << "\nPreferred Time Slots (" << preferences.getTimeZone().getName() << "):\n";
+    const auto& time_slots = preferences.getPreferredTimeSlots();
+    const auto& time_slot_days = preferences.getPreferredTimeSlotDays();
+    for (size_t i = 0; i < time_slots.size(); ++i) {
+        oss << "- " << time_slots[i].first << ":00 to " << time_slots[i].second << ":00, "
+            << HourOfWeekMask::formatDays(time_slot_days[i]) << "\n";
     }
     
     oss << "\nLocation: " << preferences.getLocation() << "\n";
     oss << "Max Travel Distance: " << preferences.getMaxTravelDistance() << " km\n";
     
     return oss.str();
+}
+
+void RecommendationEngine::buildPromptSections(const Preferences& preferences,
+                                               const std::vector<EventRecommendation>& candidates,
+                                               std::string& preferences_text, std::string& events_text) {
+    preferences_text = formatPreferences(preferences);
+    
+    size_t fixed_tokens = estimateTokens(AIService::buildRecommendationPrompt(preferences_text, ""));
+    size_t event_budget = prompt_token_budget_ > fixed_tokens ? prompt_token_budget_ - fixed_tokens : 0;
+    events_text = formatEventData(candidates, preferences, event_budget);
+    
+    last_prompt_tokens_ = estimateTokens(AIService::buildRecommendationPrompt(preferences_text, events_text));
+}
+
+size_t RecommendationEngine::estimateTokens(const std::string& text) {
+    // BPE tokenizers average roughly four characters per token for English words;
+    // punctuation and digits usually cost a token each
+    size_t tokens = 0;
+    size_t word_length = 0;
+    
+    auto end_word = [&]() {
+        if (word_length > 0) {
+            tokens += (word_length + 3) / 4;
+            word_length = 0;
+        }
+    };
+    
+    for (unsigned char c : text) {
+        if (std::isalpha(c) || c >= 0x80) {
+            word_length++;
+        } else {
+            end_word();
+            if (!std::isspace(c)) {
+                tokens++;
+            }
+        }
+    }
+    end_word();
+    
+    return tokens;
 }
\ No newline at end of file
@@ -0,0 +1,201 @@
+#include "RecommenderSession.h"
+#include <algorithm>
+#include <iterator>
+
+RecommenderSession::RecommenderSession(EventStore& store, Preferences& preferences, const Schedule& schedule,
+                                       int max_recommendations, size_t reserve)
+    : store_(store), preferences_(preferences), schedule_(schedule),
+      max_recommendations_(static_cast<size_t>(std::max(max_recommendations, 0))),
+      capacity_(max_recommendations_ + reserve), complete_(true), stats_{0, 0, 0} {
+    rebuild();
+}
+
+void RecommenderSession::addInterest(const std::string& interest, int weight) {
+    preferences_.addInterest(interest, weight);
+    rescoreInterests({interest});
+}
+
+void RecommenderSession::setInterestWeight(const std::string& interest, int weight) {
+    preferences_.setInterestWeight(interest, weight);
+    rescoreInterests({interest});
+}
+
+void RecommenderSession::removeInterest(const std::string& interest) {
+    preferences_.removeInterest(interest);
+    rescoreInterests({interest});
+}
+
+void RecommenderSession::recordAttendance(const std::vector<Event>& attended_events) {
+    std::vector<std::string> changed;
+    for (const auto& event : attended_events) {
+        for (const auto& tag : event.getTags()) {
+            preferences_.setInterestWeight(tag, preferences_.getInterestWeight(tag) + 1);
+            changed.push_back(tag);
+        }
+    }
+    rescoreInterests(changed);
+}
+
+EventStore::EventId RecommenderSession::addEvent(const Event& event) {
+    EventStore::EventId id = store_.addEvent(event);
+    rescoreRows({id});
+    return id;
+}
+
+bool RecommenderSession::removeEvent(EventStore::EventId id) {
+    if (id >= store_.size() || !store_.isActive(id)) {
+        return false;
+    }
+    unrank(id);
+    bool removed = store_.removeEvent(id);
+    refillIfDrained();
+    return removed;
+}
+
+void RecommenderSession::rebuild() {
+    profile_ = BatchScorer::compile(preferences_);
+    rescan();
+    stats_.rebuilds++;
+}
+
+std::vector<RecommendationEngine::EventRecommendation> RecommenderSession::getRecommendations() const {
+    std::vector<RecommendationEngine::EventRecommendation> recommendations;
+    const auto& start_times = store_.getStartTimes();
+    const auto& end_times = store_.getEndTimes();
+
+    for (auto it = ranked_.begin(); it != ranked_.end() && recommendations.size() < max_recommendations_; ++it) {
+        auto id = static_cast<EventStore::EventId>(it->index);
+        if (!schedule_.hasConflict(start_times[id], end_times[id])) {
+            recommendations.push_back({store_.materialize(id), it->score, "Basic compatibility score"});
+        }
+    }
+    if (recommendations.size() == max_recommendations_ || complete_) {
+        return recommendations;
+    }
+
+    // The schedule blocks too many of the held events; rank the whole store instead
+    TopKSelector top(max_recommendations_);
+    std::vector<EventStore::EventId> rows = activeRows();
+    BatchScorer::Tile tile;
+    double scores[BatchScorer::TILE_SIZE];
+    bool in_range[BatchScorer::TILE_SIZE];
+    for (size_t done = 0; done < rows.size(); done += BatchScorer::TILE_SIZE) {
+        BatchScorer::loadTile(store_, rows.data() + done, rows.size() - done, tile);
+        BatchScorer::scoreTile(tile, profile_, scores, in_range);
+        for (size_t i = 0; i < tile.count; ++i) {
+            EventStore::EventId id = tile.ids[i];
+            if (in_range[i] && !schedule_.hasConflict(start_times[id], end_times[id])) {
+                top.offer(scores[i], id);
+            }
+        }
+    }
+
+    recommendations.clear();
+    for (const auto& entry : top.take()) {
+        recommendations.push_back({store_.materialize(static_cast<EventStore::EventId>(entry.index)),
+                                   entry.score, "Basic compatibility score"});
+    }
+    return recommendations;
+}
+
+void RecommenderSession::rescan() {
+    TopKSelector top(capacity_);
+    std::vector<EventStore::EventId> rows = activeRows();
+    size_t eligible = 0;
+
+    BatchScorer::Tile tile;
+    double scores[BatchScorer::TILE_SIZE];
+    bool in_range[BatchScorer::TILE_SIZE];
+    for (size_t done = 0; done < rows.size(); done += BatchScorer::TILE_SIZE) {
+        BatchScorer::loadTile(store_, rows.data() + done, rows.size() - done, tile);
+        BatchScorer::scoreTile(tile, profile_, scores, in_range);
+        for (size_t i = 0; i < tile.count; ++i) {
+            if (in_range[i]) {
+                top.offer(scores[i], tile.ids[i]);
+                eligible++;
+            }
+        }
+    }
+
+    ranked_.clear();
+    ranked_scores_.clear();
+    for (const auto& entry : top.take()) {
+        ranked_.insert(ranked_.end(), entry);
+        ranked_scores_[static_cast<EventStore::EventId>(entry.index)] = entry.score;
+    }
+    complete_ = eligible <= capacity_;
+    stats_.rescans++;
+    stats_.rescored_events += rows.size();
+}
+
+void RecommenderSession::refillIfDrained() {
+    if (!complete_ && ranked_.size() < max_recommendations_) {
+        rescan();
+    }
+}
+
+void RecommenderSession::offer(EventStore::EventId id, double score) {
+    TopKSelector::Entry entry{score, id};
+    // Events not held are only known to rank below the last held one, so a candidate
+    // that does not beat it cannot be placed
+    if (!complete_ && (ranked_.empty() || !TopKSelector::isBetter(entry, *ranked_.rbegin()))) {
+        return;
+    }
+    ranked_.insert(entry);
+    ranked_scores_[id] = score;
+    if (ranked_.size() > capacity_) {
+        auto last = std::prev(ranked_.end());
+        ranked_scores_.erase(static_cast<EventStore::EventId>(last->index));
+        ranked_.erase(last);
+        complete_ = false;
+    }
+}
+
+void RecommenderSession::unrank(EventStore::EventId id) {
+    auto it = ranked_scores_.find(id);
+    if (it != ranked_scores_.end()) {
+        ranked_.erase({it->second, id});
+        ranked_scores_.erase(it);
+    }
+}
+
+void RecommenderSession::rescoreRows(const std::vector<EventStore::EventId>& ids) {
+    BatchScorer::Tile tile;
+    double scores[BatchScorer::TILE_SIZE];
+    bool in_range[BatchScorer::TILE_SIZE];
+    for (size_t done = 0; done < ids.size(); done += BatchScorer::TILE_SIZE) {
+        BatchScorer::loadTile(store_, ids.data() + done, ids.size() - done, tile);
+        BatchScorer::scoreTile(tile, profile_, scores, in_range);
+        for (size_t i = 0; i < tile.count; ++i) {
+            unrank(tile.ids[i]);
+            if (in_range[i]) {
+                offer(tile.ids[i], scores[i]);
+            }
+        }
+    }
+    stats_.rescored_events += ids.size();
+    refillIfDrained();
+}
+
+void RecommenderSession::rescoreInterests(const std::vector<std::string>& interests) {
+    // Only events carrying one of the tags can see a different interest average
+    std::vector<EventStore::EventId> affected;
+    for (const auto& interest : interests) {
+        const auto& postings = store_.getPostings(store_.getTagInterner().find(interest));
+        affected.insert(affected.end(), postings.begin(), postings.end());
+    }
+    std::sort(affected.begin(), affected.end());
+    affected.erase(std::unique(affected.begin(), affected.end()), affected.end());
+    rescoreRows(affected);
+}
+
+std::vector<EventStore::EventId> RecommenderSession::activeRows() const {
+    std::vector<EventStore::EventId> rows;
+    rows.reserve(store_.getActiveCount());
+    for (EventStore::EventId id = 0; id < store_.size(); ++id) {
+        if (store_.isActive(id)) {
+            rows.push_back(id);
+        }
+    }
+    return rows;
+}
\ No newline at end of file
@@ -0,0 +1,295 @@
+#include "ResponseCache.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace {
+    uint64_t fnv1a(const std::string& data, uint64_t hash) {
+        for (unsigned char c : data) {
+            hash ^= c;
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+}
+
+ResponseCache::ResponseCache() : ResponseCache(Options()) {
+}
+
+ResponseCache::ResponseCache(const Options& options)
+    : options_(options), memory_bytes_(0), disk_bytes_(0), disk_generation_(0),
+      memory_hits_(0), disk_hits_(0), misses_(0), stores_(0), evictions_(0) {
+    loadDiskIndex();
+}
+
+bool ResponseCache::lookup(const std::string& provider, const std::string& model,
+                           const std::string& prompt, std::string& content) {
+    std::string key = makeKey(provider, model, prompt);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = memory_index_.find(key);
+        if (it != memory_index_.end()) {
+            if (!isExpired(it->second->created_at)) {
+                memory_lru_.splice(memory_lru_.begin(), memory_lru_, it->second);
+                content = it->second->content;
+                memory_hits_++;
+                return true;
+            }
+            memory_bytes_ -= it->second->content.size();
+            memory_lru_.erase(it->second);
+            memory_index_.erase(it);
+        }
+
+        auto disk_it = disk_index_.find(key);
+        if (disk_it == disk_index_.end() || disk_it->second->pending) {
+            misses_++;
+            return false;
+        }
+    }
+
+    int64_t created_at = 0;
+    bool loaded = false;
+    try {
+        std::ifstream file(pathFor(key));
+        nlohmann::json entry;
+        file >> entry;
+        if (entry.at("key").get<std::string>() == key) {
+            created_at = entry.at("created_at").get<int64_t>();
+            content = entry.at("content").get<std::string>();
+            loaded = true;
+        }
+    } catch (const std::exception&) {
+        loaded = false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!loaded || isExpired(created_at)) {
+        auto disk_it = disk_index_.find(key);
+        // A store may have claimed the key while the old file was being read
+        if (disk_it != disk_index_.end() && !disk_it->second->pending) {
+            removeDiskLocked(key);
+        }
+        misses_++;
+        return false;
+    }
+
+    auto disk_it = disk_index_.find(key);
+    if (disk_it != disk_index_.end() && !disk_it->second->pending) {
+        disk_lru_.splice(disk_lru_.begin(), disk_lru_, disk_it->second);
+    }
+    insertMemoryLocked(key, content, created_at);
+    disk_hits_++;
+    return true;
+}
+
+void ResponseCache::store(const std::string& provider, const std::string& model,
+                          const std::string& prompt, const std::string& content) {
+    if (content.size() > options_.max_bytes) {
+        return;
+    }
+
+    std::string key = makeKey(provider, model, prompt);
+    int64_t created_at = now();
+
+    nlohmann::json entry = {
+        {"key", key},
+        {"provider", provider},
+        {"model", model},
+        {"created_at", created_at},
+        {"content", content}
+    };
+    std::string serialized = entry.dump();
+
+    // Claim the key on disk before writing, so an eviction or a newer store of the
+    // same key in the meantime is seen when the file is about to be renamed into place
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        insertMemoryLocked(key, content, created_at);
+        stores_++;
+
+        auto it = disk_index_.find(key);
+        if (it != disk_index_.end()) {
+            disk_bytes_ -= it->second->bytes;
+            disk_lru_.erase(it->second);
+            disk_index_.erase(it);
+        }
+        generation = ++disk_generation_;
+        disk_lru_.push_front({key, serialized.size(), generation, true});
+        disk_index_[key] = disk_lru_.begin();
+        disk_bytes_ += serialized.size();
+
+        while (disk_bytes_ > options_.max_bytes && disk_lru_.size() > 1) {
+            removeDiskLocked(disk_lru_.back().key);
+            evictions_++;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(options_.directory, ec);
+    std::string path = pathFor(key);
+    std::string temp_path = path.substr(0, path.size() - 5) + "." + std::to_string(generation) + ".tmp";
+    bool written = false;
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (file.is_open()) {
+            file << serialized;
+            written = static_cast<bool>(file);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = disk_index_.find(key);
+    bool claimed = it != disk_index_.end() && it->second->generation == generation;
+    if (claimed && written) {
+        std::filesystem::rename(temp_path, path, ec);
+        written = !ec;
+    }
+    if (!claimed || !written) {
+        std::filesystem::remove(temp_path, ec);
+        if (claimed) {
+            removeDiskLocked(key);
+        }
+        return;
+    }
+    it->second->pending = false;
+}
+
+void ResponseCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    memory_lru_.clear();
+    memory_index_.clear();
+    memory_bytes_ = 0;
+
+    while (!disk_lru_.empty()) {
+        removeDiskLocked(disk_lru_.back().key);
+    }
+}
+
+ResponseCache::Stats ResponseCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return {memory_hits_, disk_hits_, misses_, stores_, evictions_,
+            memory_lru_.size(), memory_bytes_, disk_lru_.size(), disk_bytes_};
+}
+
+std::string ResponseCache::normalizePrompt(const std::string& prompt) {
+    std::string normalized;
+    normalized.reserve(prompt.size());
+
+    bool pending_space = false;
+    for (unsigned char c : prompt) {
+        if (std::isspace(c)) {
+            pending_space = !normalized.empty();
+            continue;
+        }
+        if (pending_space) {
+            normalized.push_back(' ');
+            pending_space = false;
+        }
+        normalized.push_back(static_cast<char>(c));
+    }
+    return normalized;
+}
+
+std::string ResponseCache::makeKey(const std::string& provider, const std::string& model,
+                                   const std::string& prompt) {
+    std::string material = provider + '\n' + model + '\n' + normalizePrompt(prompt);
+
+    // Two independently seeded 64-bit FNV-1a hashes give a 128-bit content address
+    uint64_t high = fnv1a(material, 14695981039346656037ULL);
+    uint64_t low = fnv1a(material, 0x84222325cbf29ce4ULL);
+
+    char buffer[33];
+    std::snprintf(buffer, sizeof(buffer), "%016llx%016llx",
+                  static_cast<unsigned long long>(high), static_cast<unsigned long long>(low));
+    return buffer;
+}
+
+void ResponseCache::loadDiskIndex() {
+    std::error_code ec;
+    if (!std::filesystem::is_directory(options_.directory, ec)) {
+        return;
+    }
+
+    std::vector<std::pair<std::filesystem::file_time_type, DiskEntry>> found;
+    for (const auto& file : std::filesystem::directory_iterator(options_.directory, ec)) {
+        if (!file.is_regular_file(ec)) {
+            continue;
+        }
+        if (file.path().extension() == ".tmp") {
+            // Left by a store that was interrupted before its rename
+            std::filesystem::remove(file.path(), ec);
+            continue;
+        }
+        if (file.path().extension() != ".json") {
+            continue;
+        }
+        found.push_back({file.last_write_time(ec),
+                         {file.path().stem().string(), static_cast<size_t>(file.file_size(ec)), 0, false}});
+    }
+
+    std::sort(found.begin(), found.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : found) {
+        disk_lru_.push_front(entry.second);
+        disk_index_[entry.second.key] = disk_lru_.begin();
+        disk_bytes_ += entry.second.bytes;
+    }
+
+    while (disk_bytes_ > options_.max_bytes && !disk_lru_.empty()) {
+        removeDiskLocked(disk_lru_.back().key);
+        evictions_++;
+    }
+}
+
+void ResponseCache::insertMemoryLocked(const std::string& key, const std::string& content, int64_t created_at) {
+    auto it = memory_index_.find(key);
+    if (it != memory_index_.end()) {
+        memory_bytes_ -= it->second->content.size();
+        memory_lru_.erase(it->second);
+        memory_index_.erase(it);
+    }
+
+    memory_lru_.push_front({key, content, created_at});
+    memory_index_[key] = memory_lru_.begin();
+    memory_bytes_ += content.size();
+
+    while (memory_bytes_ > options_.max_bytes && memory_lru_.size() > 1) {
+        memory_bytes_ -= memory_lru_.back().content.size();
+        memory_index_.erase(memory_lru_.back().key);
+        memory_lru_.pop_back();
+        evictions_++;
+    }
+}
+
+void ResponseCache::removeDiskLocked(std::string key) {
+    auto it = disk_index_.find(key);
+    if (it != disk_index_.end()) {
+        disk_bytes_ -= it->second->bytes;
+        disk_lru_.erase(it->second);
+        disk_index_.erase(it);
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(pathFor(key), ec);
+}
+
+bool ResponseCache::isExpired(int64_t created_at) const {
+    return options_.ttl.count() > 0 && now() - created_at > options_.ttl.count();
+}
+
+std::string ResponseCache::pathFor(const std::string& key) const {
+    return (std::filesystem::path(options_.directory) / (key + ".json")).string();
+}
+
+int64_t ResponseCache::now() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
\ No newline at end of file
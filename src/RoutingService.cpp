@@ -0,0 +1,484 @@
+#include "RoutingService.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    // Recent latencies kept per provider for the percentiles
+    const size_t SAMPLE_WINDOW = 256;
+
+    double percentile(std::vector<double> samples, double fraction) {
+        size_t rank = static_cast<size_t>(fraction * static_cast<double>(samples.size() - 1) + 0.5);
+        std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(rank), samples.end());
+        return samples[rank];
+    }
+}
+
+struct RoutingService::Shared {
+    struct Route {
+        std::shared_ptr<AIService> service;
+        std::vector<double> samples;
+        size_t next_sample = 0;
+        double ewma_ms = 0;
+        double p95_ms = 0;
+        double p99_ms = 0;
+        int consecutive_failures = 0;
+        Clock::time_point unhealthy_until;
+        size_t requests = 0;
+        size_t failures = 0;
+        size_t wins = 0;
+        size_t cancelled = 0;
+    };
+
+    Options options;
+
+    mutable std::mutex mutex;
+    std::vector<Route> routes;
+    // Races the caller may cancel, by their cancel flag
+    std::unordered_map<const std::atomic<bool>*, std::weak_ptr<Race>> cancellable;
+    size_t requests = 0;
+    size_t hedged = 0;
+    size_t hedge_wins = 0;
+    size_t failovers = 0;
+    size_t failures = 0;
+
+    std::mutex timer_mutex;
+    std::condition_variable timer_wake;
+    std::multimap<Clock::time_point, std::function<void()>> timers;
+    std::thread timer_thread;
+    bool stopping = false;
+
+    bool isHealthy(const Route& route, Clock::time_point now) const {
+        return route.consecutive_failures < options.failure_threshold || now >= route.unhealthy_until;
+    }
+
+    // Healthy providers, untimed ones first and then by EWMA, followed by unhealthy
+    // ones in the order they recover
+    std::vector<size_t> rank(Clock::time_point now) const {
+        std::vector<size_t> order(routes.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            bool healthy_a = isHealthy(routes[a], now);
+            bool healthy_b = isHealthy(routes[b], now);
+            if (healthy_a != healthy_b) {
+                return healthy_a;
+            }
+            if (!healthy_a) {
+                return routes[a].unhealthy_until < routes[b].unhealthy_until;
+            }
+            double ewma_a = routes[a].samples.empty() ? -1.0 : routes[a].ewma_ms;
+            double ewma_b = routes[b].samples.empty() ? -1.0 : routes[b].ewma_ms;
+            return ewma_a < ewma_b;
+        });
+        return order;
+    }
+
+    void recordSuccess(Route& route, double latency_ms) {
+        route.consecutive_failures = 0;
+        route.ewma_ms = route.samples.empty()
+            ? latency_ms
+            : options.ewma_alpha * latency_ms + (1.0 - options.ewma_alpha) * route.ewma_ms;
+        if (route.samples.size() < SAMPLE_WINDOW) {
+            route.samples.push_back(latency_ms);
+        } else {
+            route.samples[route.next_sample] = latency_ms;
+            route.next_sample = (route.next_sample + 1) % SAMPLE_WINDOW;
+        }
+        route.p95_ms = percentile(route.samples, 0.95);
+        route.p99_ms = percentile(route.samples, 0.99);
+    }
+
+    void recordFailure(Route& route, Clock::time_point now) {
+        route.failures++;
+        if (++route.consecutive_failures >= options.failure_threshold) {
+            route.unhealthy_until = now + options.unhealthy_cooldown;
+        }
+    }
+
+    Clock::duration hedgeDelay(const Route& route) const {
+        if (route.samples.size() < options.min_samples) {
+            return options.initial_hedge_delay;
+        }
+        auto p95 = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(route.p95_ms));
+        return std::max<Clock::duration>(p95, options.min_hedge_delay);
+    }
+
+    void schedule(Clock::time_point when, std::function<void()> task, const std::shared_ptr<Shared>& self) {
+        {
+            std::lock_guard<std::mutex> lock(timer_mutex);
+            if (stopping) {
+                return;
+            }
+            // The thread is only started once the first hedge is scheduled
+            if (!timer_thread.joinable()) {
+                timer_thread = std::thread(&RoutingService::runTimer, self);
+            }
+            timers.emplace(when, std::move(task));
+        }
+        timer_wake.notify_one();
+    }
+};
+
+struct RoutingService::Race {
+    struct Attempt {
+        size_t provider;
+        CancelFlag cancel;
+        bool hedge;
+    };
+
+    std::string prompt;
+    ResponseCallback on_complete;
+    CancelFlag caller_cancel;
+    std::vector<size_t> order;
+
+    std::mutex mutex;
+    std::vector<Attempt> attempts;
+    // Next entry of order to launch
+    size_t next = 0;
+    size_t in_flight = 0;
+    bool hedge_sent = false;
+    bool done = false;
+    AIResponse last_failure;
+};
+
+RoutingService::RoutingService(std::vector<std::shared_ptr<AIService>> providers)
+    : RoutingService(std::move(providers), Options()) {
+}
+
+RoutingService::RoutingService(std::vector<std::shared_ptr<AIService>> providers, const Options& options)
+    : AIService(""), shared_(std::make_shared<Shared>()) {
+    shared_->options = options;
+    for (auto& provider : providers) {
+        if (provider) {
+            Shared::Route route;
+            route.service = std::move(provider);
+            shared_->routes.push_back(std::move(route));
+        }
+    }
+}
+
+RoutingService::~RoutingService() {
+    std::thread timer_thread;
+    {
+        std::lock_guard<std::mutex> lock(shared_->timer_mutex);
+        shared_->stopping = true;
+        shared_->timers.clear();
+        timer_thread = std::move(shared_->timer_thread);
+    }
+    shared_->timer_wake.notify_all();
+    if (timer_thread.joinable()) {
+        // A hedge that completes inline can drop the last reference to the router from
+        // the timer thread itself; the thread holds its own reference to shared_
+        if (timer_thread.get_id() == std::this_thread::get_id()) {
+            timer_thread.detach();
+        } else {
+            timer_thread.join();
+        }
+    }
+}
+
+std::future<AIService::AIResponse> RoutingService::generateResponse(const std::string& prompt) {
+    return toFuture([this, prompt](ResponseCallback on_complete) {
+        generateResponse(prompt, std::move(on_complete));
+    });
+}
+
+void RoutingService::generateResponse(const std::string& prompt, ResponseCallback on_complete,
+                                      CancelFlag cancel) {
+    if (shared_->routes.empty()) {
+        on_complete({false, "", "No AI providers configured"});
+        return;
+    }
+
+    auto race = std::make_shared<Race>();
+    race->prompt = prompt;
+    race->on_complete = std::move(on_complete);
+    race->caller_cancel = std::move(cancel);
+
+    Clock::duration hedge_delay;
+    {
+        std::lock_guard<std::mutex> lock(shared_->mutex);
+        shared_->requests++;
+        race->order = shared_->rank(Clock::now());
+        hedge_delay = shared_->hedgeDelay(shared_->routes[race->order[0]]);
+        if (race->caller_cancel) {
+            shared_->cancellable[race->caller_cancel.get()] = race;
+        }
+    }
+
+    launch(shared_, race, race->order[0], false);
+
+    if (!shared_->options.hedge || race->order.size() < 2) {
+        return;
+    }
+    std::weak_ptr<Race> weak_race = race;
+    std::shared_ptr<Shared> shared = shared_;
+    shared_->schedule(Clock::now() + hedge_delay, [shared, weak_race]() {
+        auto race = weak_race.lock();
+        if (!race) {
+            return;
+        }
+        size_t provider;
+        {
+            std::lock_guard<std::mutex> lock(race->mutex);
+            if (race->done || race->hedge_sent || race->next >= race->order.size() ||
+                (race->caller_cancel && *race->caller_cancel)) {
+                return;
+            }
+            provider = race->order[race->next];
+            std::lock_guard<std::mutex> shared_lock(shared->mutex);
+            // Duplicating onto a provider that is failing would only add load
+            if (!shared->isHealthy(shared->routes[provider], Clock::now())) {
+                return;
+            }
+            race->hedge_sent = true;
+            shared->hedged++;
+        }
+        launch(shared, race, provider, true);
+    }, shared_);
+}
+
+std::future<AIService::AIResponse> RoutingService::analyzePreferences(const std::string& user_data) {
+    std::string prompt = "Analyze the following user data and extract preferences for event recommendations:\n" + user_data;
+    return generateResponse(prompt);
+}
+
+std::future<AIService::AIResponse> RoutingService::recommendEvents(
+    const std::string& preferences,
+    const std::string& available_events) {
+    return generateResponse(buildRecommendationPrompt(preferences, available_events));
+}
+
+void RoutingService::streamResponse(const std::string& prompt, DeltaCallback on_delta,
+                                    ResponseCallback on_complete) {
+    if (shared_->routes.empty()) {
+        on_complete({false, "", "No AI providers configured"});
+        return;
+    }
+
+    size_t provider;
+    std::shared_ptr<AIService> service;
+    {
+        std::lock_guard<std::mutex> lock(shared_->mutex);
+        shared_->requests++;
+        provider = shared_->rank(Clock::now())[0];
+        service = shared_->routes[provider].service;
+        shared_->routes[provider].requests++;
+    }
+
+    // A stream's duration depends on its length, so only its health is recorded
+    std::shared_ptr<Shared> shared = shared_;
+    service->streamResponse(prompt, std::move(on_delta), [shared, provider, on_complete](AIResponse response) {
+        {
+            std::lock_guard<std::mutex> lock(shared->mutex);
+            auto& route = shared->routes[provider];
+            if (response.success) {
+                route.consecutive_failures = 0;
+                route.wins++;
+            } else {
+                shared->recordFailure(route, Clock::now());
+                shared->failures++;
+            }
+        }
+        on_complete(std::move(response));
+    });
+}
+
+void RoutingService::cancel(const CancelFlag& flag) {
+    if (!flag) {
+        return;
+    }
+    *flag = true;
+
+    std::shared_ptr<Race> race;
+    {
+        std::lock_guard<std::mutex> lock(shared_->mutex);
+        auto it = shared_->cancellable.find(flag.get());
+        if (it == shared_->cancellable.end()) {
+            return;
+        }
+        race = it->second.lock();
+        shared_->cancellable.erase(it);
+    }
+    if (!race) {
+        return;
+    }
+
+    std::vector<Race::Attempt> running;
+    {
+        std::lock_guard<std::mutex> lock(race->mutex);
+        if (race->done) {
+            return;
+        }
+        race->done = true;
+        running = race->attempts;
+    }
+    for (const auto& attempt : running) {
+        shared_->routes[attempt.provider].service->cancel(attempt.cancel);
+    }
+    race->on_complete({false, "", "Request cancelled"});
+}
+
+std::string RoutingService::getModelName() const {
+    std::string names;
+    for (const auto& route : shared_->routes) {
+        names += (names.empty() ? "" : ",") + route.service->getModelName();
+    }
+    return names;
+}
+
+std::vector<RoutingService::ProviderStats> RoutingService::getProviderStats() const {
+    std::lock_guard<std::mutex> lock(shared_->mutex);
+    Clock::time_point now = Clock::now();
+    std::vector<ProviderStats> stats;
+    for (const auto& route : shared_->routes) {
+        stats.push_back({route.service->getProviderName(), shared_->isHealthy(route, now), route.samples.size(),
+                         route.ewma_ms, route.p95_ms, route.p99_ms, route.requests, route.failures, route.wins,
+                         route.cancelled});
+    }
+    return stats;
+}
+
+RoutingService::Stats RoutingService::getStats() const {
+    std::lock_guard<std::mutex> lock(shared_->mutex);
+    return {shared_->requests, shared_->hedged, shared_->hedge_wins, shared_->failovers, shared_->failures};
+}
+
+void RoutingService::launch(const std::shared_ptr<Shared>& shared, const std::shared_ptr<Race>& race,
+                            size_t provider, bool hedge) {
+    auto cancel = std::make_shared<std::atomic<bool>>(false);
+    {
+        std::lock_guard<std::mutex> lock(race->mutex);
+        race->attempts.push_back({provider, cancel, hedge});
+        race->next++;
+        race->in_flight++;
+    }
+
+    std::shared_ptr<AIService> service;
+    {
+        std::lock_guard<std::mutex> lock(shared->mutex);
+        shared->routes[provider].requests++;
+        service = shared->routes[provider].service;
+    }
+
+    Clock::time_point started = Clock::now();
+    // May complete inline, e.g. from the provider's response cache
+    service->generateResponse(race->prompt, [shared, race, provider, started](AIResponse response) {
+        finishAttempt(shared, race, provider, started, std::move(response));
+    }, cancel);
+}
+
+void RoutingService::finishAttempt(const std::shared_ptr<Shared>& shared, const std::shared_ptr<Race>& race,
+                                   size_t provider, Clock::time_point started, AIResponse response) {
+    Clock::time_point now = Clock::now();
+    bool hedge = false;
+    bool cancelled = false;
+    {
+        std::lock_guard<std::mutex> lock(race->mutex);
+        for (const auto& attempt : race->attempts) {
+            if (attempt.provider == provider) {
+                hedge = attempt.hedge;
+                cancelled = *attempt.cancel;
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(shared->mutex);
+        auto& route = shared->routes[provider];
+        if (cancelled) {
+            // Lost the race; says nothing about the provider
+            route.cancelled++;
+        } else if (response.success) {
+            shared->recordSuccess(route, std::chrono::duration<double, std::milli>(now - started).count());
+        } else {
+            shared->recordFailure(route, now);
+        }
+    }
+
+    std::vector<Race::Attempt> losers;
+    size_t failover = race->order.size();
+    {
+        std::lock_guard<std::mutex> lock(race->mutex);
+        race->in_flight--;
+        if (race->done) {
+            return;
+        }
+
+        if (response.success) {
+            race->done = true;
+            for (const auto& attempt : race->attempts) {
+                if (attempt.provider != provider) {
+                    losers.push_back(attempt);
+                }
+            }
+        } else {
+            race->last_failure = std::move(response);
+            if (race->in_flight > 0) {
+                // The other attempt may still succeed
+                return;
+            }
+            if (race->next < race->order.size() && !(race->caller_cancel && *race->caller_cancel)) {
+                failover = race->order[race->next];
+            } else {
+                race->done = true;
+            }
+        }
+    }
+
+    if (failover < race->order.size()) {
+        {
+            std::lock_guard<std::mutex> lock(shared->mutex);
+            shared->failovers++;
+        }
+        launch(shared, race, failover, false);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(shared->mutex);
+        if (response.success) {
+            shared->routes[provider].wins++;
+            shared->hedge_wins += hedge;
+        } else {
+            shared->failures++;
+        }
+        if (race->caller_cancel) {
+            shared->cancellable.erase(race->caller_cancel.get());
+        }
+    }
+    for (const auto& loser : losers) {
+        shared->routes[loser.provider].service->cancel(loser.cancel);
+    }
+    race->on_complete(response.success ? std::move(response) : std::move(race->last_failure));
+}
+
+void RoutingService::runTimer(std::shared_ptr<Shared> shared) {
+    std::unique_lock<std::mutex> lock(shared->timer_mutex);
+    while (!shared->stopping) {
+        if (shared->timers.empty()) {
+            shared->timer_wake.wait(lock);
+            continue;
+        }
+        auto first = shared->timers.begin();
+        if (first->first > Clock::now()) {
+            shared->timer_wake.wait_until(lock, first->first);
+            continue;
+        }
+        std::function<void()> task = std::move(first->second);
+        shared->timers.erase(first);
+
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+}
\ No newline at end of file
@@ -4,44 +4,108 @@
 Schedule::Schedule() {
 }
 
+namespace {
+    bool startsBefore(const Event& a, const Event& b) {
+        return a.getStartTime() < b.getStartTime();
+    }
+}
+
 void Schedule::addEvent(const Event& event) {
-    events_.push_back(event);
-    std::sort(events_.begin(), events_.end(), 
-              [](const Event& a, const Event& b) {
-                  return a.getStartTime() < b.getStartTime();
-              });
+    insertSorted(Event(event));
+}
+
+void Schedule::addEvent(Event&& event) {
+    insertSorted(std::move(event));
+}
+
+void Schedule::addEvents(std::vector<Event> events) {
+    if (events.empty()) {
+        return;
+    }
+    
+    size_t existing = events_.size();
+    events_.reserve(existing + events.size());
+    for (auto& event : events) {
+        indexEvent(event);
+        events_.push_back(std::move(event));
+    }
+    
+    // Sort only the new block, then merge it with the already sorted prefix. Events
+    // starting no later than the earliest new one keep their place and their max-end.
+    auto middle = events_.begin() + static_cast<std::ptrdiff_t>(existing);
+    std::stable_sort(middle, events_.end(), startsBefore);
+    size_t first_changed = static_cast<size_t>(
+        std::upper_bound(events_.begin(), middle, *middle, startsBefore) - events_.begin());
+    std::inplace_merge(events_.begin(), middle, events_.end(), startsBefore);
+    rebuildIndexFrom(first_changed);
 }
 
 void Schedule::removeEvent(const std::string& event_name) {
-    events_.erase(
-        std::remove_if(events_.begin(), events_.end(),
-                      [&event_name](const Event& e) {
-                          return e.getName() == event_name;
-                      }),
-        events_.end());
+    auto range = name_index_.equal_range(event_name);
+    std::vector<size_t> positions;
+    for (auto it = range.first; it != range.second; ++it) {
+        findStartingAt(it->second, [&event_name](const Event& event) {
+            return event.getName() == event_name;
+        }, positions);
+    }
+    eraseAt(std::move(positions));
+}
+
+bool Schedule::removeEventById(Event::Id event_id) {
+    auto range = id_index_.equal_range(event_id);
+    if (range.first == range.second) {
+        return false;
+    }
+    
+    std::vector<size_t> positions;
+    for (auto it = range.first; it != range.second; ++it) {
+        findStartingAt(it->second, [event_id](const Event& event) {
+            return event.getId() == event_id;
+        }, positions);
+    }
+    eraseAt(std::move(positions));
+    return true;
 }
 
 std::vector<Event> Schedule::getEventsInRange(
     const std::chrono::system_clock::time_point& start,
     const std::chrono::system_clock::time_point& end) const {
     
-    std::vector<Event> result;
-    for (const auto& event : events_) {
-        if (event.getStartTime() >= start && event.getEndTime() <= end) {
-            result.push_back(event);
-        }
-    }
-    return result;
+    auto view = viewEventsInRange(start, end);
+    return std::vector<Event>(view.begin(), view.end());
+}
+
+Schedule::EventRangeView Schedule::viewEventsInRange(
+    const std::chrono::system_clock::time_point& start,
+    const std::chrono::system_clock::time_point& end) const {
+    
+    // Only events starting inside [start, end] can also end inside it
+    auto first = events_.begin() + countStartingBefore(start);
+    auto last = std::upper_bound(first, events_.end(), end,
+                                 [](const std::chrono::system_clock::time_point& t, const Event& event) {
+                                     return t < event.getStartTime();
+                                 });
+    const Event* base = events_.data();
+    return EventRangeView(base + (first - events_.begin()), base + (last - events_.begin()), end);
 }
 
 bool Schedule::hasConflict(const Event& event) const {
-    for (const auto& existing_event : events_) {
-        if (event.getStartTime() < existing_event.getEndTime() &&
-            event.getEndTime() > existing_event.getStartTime()) {
-            return true;
-        }
-    }
-    return false;
+    return hasConflict(event.getStartTime(), event.getEndTime());
+}
+
+bool Schedule::hasConflict(
+    const std::chrono::system_clock::time_point& start,
+    const std::chrono::system_clock::time_point& end) const {
+    
+    // Any overlap must start before `end`; among those, the latest end decides
+    size_t candidates = countStartingBefore(end);
+    return candidates > 0 && max_end_[candidates - 1] > start;
+}
+
+std::vector<bool> Schedule::conflictsFor(const std::vector<Event>& events) const {
+    std::vector<bool> conflicts(events.size());
+    conflictsFor(events.begin(), events.end(), conflicts.begin());
+    return conflicts;
 }
 
 std::vector<std::pair<std::chrono::system_clock::time_point, std::chrono::system_clock::time_point>> 
@@ -51,10 +115,15 @@ Schedule::getFreeTimeSlots(
     
     std::vector<std::pair<std::chrono::system_clock::time_point, std::chrono::system_clock::time_point>> free_slots;
     
+    size_t first = countStartingBefore(start);
     auto current_time = start;
-    for (const auto& event : events_) {
+    if (first > 0) {
+        current_time = std::max(current_time, max_end_[first - 1]);
+    }
+    
+    for (size_t i = first; i < events_.size(); ++i) {
+        const auto& event = events_[i];
         if (event.getStartTime() >= end) break;
-        if (event.getEndTime() <= start) continue;
         
         if (current_time < event.getStartTime()) {
             free_slots.push_back({current_time, event.getStartTime()});
@@ -67,4 +136,100 @@ Schedule::getFreeTimeSlots(
     }
     
     return free_slots;
+}
+
+void Schedule::insertSorted(Event&& event) {
+    // After any events with the same start time, so equal starts keep insertion order
+    auto pos = std::upper_bound(events_.begin(), events_.end(), event, startsBefore);
+    size_t index = static_cast<size_t>(pos - events_.begin());
+    
+    indexEvent(event);
+    events_.insert(pos, std::move(event));
+    rebuildIndexFrom(index);
+}
+
+void Schedule::indexEvent(const Event& event) {
+    id_index_.emplace(event.getId(), event.getStartTime());
+    name_index_.emplace(event.getName(), event.getStartTime());
+}
+
+void Schedule::unindexEvent(const Event& event) {
+    auto unindex = [&event](auto& index, const auto& key) {
+        auto range = index.equal_range(key);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == event.getStartTime()) {
+                index.erase(it);
+                return;
+            }
+        }
+    };
+    unindex(id_index_, event.getId());
+    unindex(name_index_, event.getName());
+}
+
+template <typename Predicate>
+void Schedule::findStartingAt(const std::chrono::system_clock::time_point& start, Predicate matches,
+                              std::vector<size_t>& positions) const {
+    for (size_t i = countStartingBefore(start); i < events_.size() && events_[i].getStartTime() == start; ++i) {
+        if (matches(events_[i])) {
+            positions.push_back(i);
+        }
+    }
+}
+
+void Schedule::eraseAt(std::vector<size_t> positions) {
+    // Several index entries can lead to the same event
+    std::sort(positions.begin(), positions.end());
+    positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+    if (positions.empty()) {
+        return;
+    }
+    
+    // One compaction pass over the tail, however many events go
+    size_t kept = positions[0];
+    size_t next = 0;
+    for (size_t i = positions[0]; i < events_.size(); ++i) {
+        if (next < positions.size() && positions[next] == i) {
+            unindexEvent(events_[i]);
+            ++next;
+        } else {
+            events_[kept++] = std::move(events_[i]);
+        }
+    }
+    events_.erase(events_.begin() + static_cast<std::ptrdiff_t>(kept), events_.end());
+    rebuildIndexFrom(positions[0]);
+}
+
+void Schedule::rebuildIndexFrom(size_t first) {
+    max_end_.resize(events_.size());
+    for (size_t i = first; i < events_.size(); ++i) {
+        max_end_[i] = i == 0 ? events_[i].getEndTime() : std::max(max_end_[i - 1], events_[i].getEndTime());
+    }
+}
+
+size_t Schedule::countStartingBefore(const std::chrono::system_clock::time_point& time) const {
+    auto it = std::lower_bound(events_.begin(), events_.end(), time,
+                               [](const Event& event, const std::chrono::system_clock::time_point& t) {
+                                   return event.getStartTime() < t;
+                               });
+    return static_cast<size_t>(it - events_.begin());
+}
+
+size_t Schedule::countStartingBefore(const std::chrono::system_clock::time_point& time, size_t from) const {
+    // Gallop forward from `from`, which is known to start before `time`, then bisect
+    size_t low = from;
+    size_t high = from;
+    size_t step = 1;
+    while (high < events_.size() && events_[high].getStartTime() < time) {
+        low = high + 1;
+        high = from + step;
+        step *= 2;
+    }
+    high = std::min(high, events_.size());
+    auto it = std::lower_bound(events_.begin() + static_cast<std::ptrdiff_t>(low),
+                               events_.begin() + static_cast<std::ptrdiff_t>(high), time,
+                               [](const Event& event, const std::chrono::system_clock::time_point& t) {
+                                   return event.getStartTime() < t;
+                               });
+    return static_cast<size_t>(it - events_.begin());
 }
\ No newline at end of file
@@ -0,0 +1,78 @@
+#include "SseParser.h"
+
+SseParser::SseParser(EventCallback on_event)
+    : on_event_(std::move(on_event)), has_data_(false), skip_line_feed_(false) {
+}
+
+void SseParser::feed(const char* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        char c = data[i];
+
+        // A CR LF pair split across chunks must only end one line
+        if (skip_line_feed_) {
+            skip_line_feed_ = false;
+            if (c == '\n') {
+                continue;
+            }
+        }
+
+        if (c == '\r' || c == '\n') {
+            skip_line_feed_ = (c == '\r');
+            processLine();
+            line_.clear();
+        } else {
+            line_.push_back(c);
+        }
+    }
+}
+
+void SseParser::finish() {
+    // An event without its terminating blank line is incomplete and is discarded,
+    // as the event-stream spec requires; the stream may have been cut off mid-event
+    line_.clear();
+    event_.clear();
+    data_.clear();
+    has_data_ = false;
+    skip_line_feed_ = false;
+}
+
+void SseParser::processLine() {
+    if (line_.empty()) {
+        dispatch();
+        return;
+    }
+
+    if (line_[0] == ':') {
+        return;
+    }
+
+    size_t colon = line_.find(':');
+    std::string field = line_.substr(0, colon);
+    std::string value;
+    if (colon != std::string::npos) {
+        size_t start = colon + 1;
+        if (start < line_.size() && line_[start] == ' ') {
+            start++;
+        }
+        value = line_.substr(start);
+    }
+
+    if (field == "event") {
+        event_ = value;
+    } else if (field == "data") {
+        if (has_data_) {
+            data_.push_back('\n');
+        }
+        data_ += value;
+        has_data_ = true;
+    }
+}
+
+void SseParser::dispatch() {
+    if (has_data_ && on_event_) {
+        on_event_(event_.empty() ? "message" : event_, data_);
+    }
+    event_.clear();
+    data_.clear();
+    has_data_ = false;
+}
\ No newline at end of file
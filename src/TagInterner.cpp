@@ -0,0 +1,47 @@
+#include "TagInterner.h"
+#include <limits>
+#include <mutex>
+
+const TagInterner::TagId TagInterner::INVALID_TAG = std::numeric_limits<TagInterner::TagId>::max();
+
+TagInterner::TagId TagInterner::intern(const std::string& tag) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = ids_.find(tag);
+        if (it != ids_.end()) {
+            return it->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = ids_.find(tag);
+    if (it != ids_.end()) {
+        return it->second;
+    }
+
+    TagId id = static_cast<TagId>(names_.size());
+    names_.push_back(tag);
+    ids_.emplace(tag, id);
+    return id;
+}
+
+TagInterner::TagId TagInterner::find(const std::string& tag) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = ids_.find(tag);
+    return it != ids_.end() ? it->second : INVALID_TAG;
+}
+
+const std::string& TagInterner::getName(TagId id) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return names_.at(id);
+}
+
+size_t TagInterner::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return names_.size();
+}
+
+TagInterner& TagInterner::global() {
+    static TagInterner interner;
+    return interner;
+}
\ No newline at end of file
@@ -0,0 +1,136 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <exception>
+
+namespace {
+    // Set on worker threads so tasks submitted from a worker go to its own queue
+    thread_local const void* current_pool = nullptr;
+    thread_local size_t current_worker = 0;
+}
+
+ThreadPool::ThreadPool(size_t thread_count)
+    : pending_(0), next_queue_(0), stopping_(false) {
+    if (thread_count == 0) {
+        thread_count = 1;
+    }
+
+    for (size_t i = 0; i < thread_count; ++i) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (size_t i = 0; i < thread_count; ++i) {
+        threads_.emplace_back(&ThreadPool::run, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+void ThreadPool::submit(Task task) {
+    size_t queue = current_pool == this
+        ? current_worker
+        : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+
+    // Counted before it is visible, so the worker that runs it can never decrement first
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        ++pending_;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues_[queue]->mutex);
+        queues_[queue]->tasks.push_back(std::move(task));
+    }
+    wake_.notify_one();
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grain, const RangeTask& body) {
+    if (count == 0) {
+        return;
+    }
+    if (grain == 0) {
+        grain = 1;
+    }
+
+    std::mutex done_mutex;
+    std::condition_variable done;
+    size_t remaining = (count + grain - 1) / grain;
+    std::exception_ptr error;
+
+    for (size_t begin = 0; begin < count; begin += grain) {
+        size_t end = std::min(count, begin + grain);
+        submit([&, begin, end](size_t worker) {
+            std::exception_ptr chunk_error;
+            try {
+                body(worker, begin, end);
+            } catch (...) {
+                chunk_error = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(done_mutex);
+            if (chunk_error && !error) {
+                error = chunk_error;
+            }
+            if (--remaining == 0) {
+                done.notify_one();
+            }
+        });
+    }
+
+    std::unique_lock<std::mutex> lock(done_mutex);
+    done.wait(lock, [&remaining]() { return remaining == 0; });
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::run(size_t worker) {
+    current_pool = this;
+    current_worker = worker;
+
+    while (true) {
+        Task task;
+        if (popLocal(worker, task) || steal(worker, task)) {
+            --pending_;
+            task(worker);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        wake_.wait(lock, [this]() { return stopping_ || pending_ > 0; });
+        if (stopping_ && pending_ == 0) {
+            return;
+        }
+    }
+}
+
+bool ThreadPool::popLocal(size_t worker, Task& task) {
+    auto& queue = *queues_[worker];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::steal(size_t worker, Task& task) {
+    for (size_t offset = 1; offset < queues_.size(); ++offset) {
+        auto& queue = *queues_[(worker + offset) % queues_.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
\ No newline at end of file
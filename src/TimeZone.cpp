@@ -0,0 +1,411 @@
+#include "TimeZone.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+namespace {
+    const int LAST_EXPANDED_YEAR = 2100;
+
+    std::int64_t readBigEndian(const std::string& data, size_t pos, size_t bytes) {
+        std::uint64_t value = 0;
+        for (size_t i = 0; i < bytes; ++i) {
+            value = (value << 8) | static_cast<unsigned char>(data[pos + i]);
+        }
+        if (bytes == 4) {
+            return static_cast<std::int32_t>(static_cast<std::uint32_t>(value));
+        }
+        return static_cast<std::int64_t>(value);
+    }
+
+    // Days since 1970-01-01 for a proleptic Gregorian date
+    std::int64_t daysFromCivil(std::int64_t year, int month, int day) {
+        year -= month <= 2;
+        std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+        std::int64_t year_of_era = year - era * 400;
+        std::int64_t day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        std::int64_t day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+        return era * 146097 + day_of_era - 719468;
+    }
+
+    std::int64_t civilYear(std::int64_t days) {
+        days += 719468;
+        std::int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+        std::int64_t day_of_era = days - era * 146097;
+        std::int64_t year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+        std::int64_t day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+        std::int64_t month_index = (5 * day_of_year + 2) / 153;
+        return year_of_era + era * 400 + (month_index >= 10 ? 1 : 0);
+    }
+
+    bool isLeapYear(std::int64_t year) {
+        return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    }
+
+    int daysInMonth(std::int64_t year, int month) {
+        static const int lengths[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        return month == 2 && isLeapYear(year) ? 29 : lengths[month - 1];
+    }
+
+    // Minimal reader for the POSIX TZ grammar used in TZif footers
+    class PosixRuleReader {
+    public:
+        explicit PosixRuleReader(const std::string& text) : text_(text), pos_(0) {}
+
+        bool atEnd() const { return pos_ >= text_.size(); }
+        bool peek(char c) const { return pos_ < text_.size() && text_[pos_] == c; }
+        bool consume(char c) {
+            if (!peek(c)) return false;
+            ++pos_;
+            return true;
+        }
+
+        bool readName() {
+            if (consume('<')) {
+                size_t close = text_.find('>', pos_);
+                if (close == std::string::npos) return false;
+                pos_ = close + 1;
+                return true;
+            }
+            size_t start = pos_;
+            while (pos_ < text_.size() && std::isalpha(static_cast<unsigned char>(text_[pos_]))) ++pos_;
+            return pos_ - start >= 3;
+        }
+
+        // [+-]hh[:mm[:ss]] in seconds
+        bool readTime(std::int64_t& seconds) {
+            int sign = 1;
+            if (consume('-')) sign = -1;
+            else consume('+');
+
+            std::int64_t parts[3] = {0, 0, 0};
+            for (int i = 0; i < 3; ++i) {
+                if (i > 0 && !consume(':')) break;
+                if (!readNumber(parts[i])) return false;
+            }
+            seconds = sign * (parts[0] * 3600 + parts[1] * 60 + parts[2]);
+            return true;
+        }
+
+        bool readNumber(std::int64_t& value) {
+            size_t start = pos_;
+            value = 0;
+            while (pos_ < text_.size() && std::isdigit(static_cast<unsigned char>(text_[pos_]))) {
+                value = value * 10 + (text_[pos_++] - '0');
+            }
+            return pos_ > start;
+        }
+
+    private:
+        const std::string& text_;
+        size_t pos_;
+    };
+
+    struct RuleDate {
+        char kind;  // 'J' (1-365, no leap day), 'N' (0-365), 'M' (month.week.weekday)
+        std::int64_t day;
+        std::int64_t month;
+        std::int64_t week;
+        std::int64_t weekday;
+        std::int64_t time;  // local wall clock seconds after midnight
+    };
+
+    bool readRuleDate(PosixRuleReader& reader, RuleDate& date) {
+        date = {'N', 0, 0, 0, 0, 7200};
+        if (reader.consume('M')) {
+            date.kind = 'M';
+            if (!reader.readNumber(date.month) || !reader.consume('.') ||
+                !reader.readNumber(date.week) || !reader.consume('.') ||
+                !reader.readNumber(date.weekday)) {
+                return false;
+            }
+            if (date.month < 1 || date.month > 12 || date.week < 1 || date.week > 5 || date.weekday > 6) {
+                return false;
+            }
+        } else {
+            if (reader.consume('J')) date.kind = 'J';
+            if (!reader.readNumber(date.day)) return false;
+        }
+        if (reader.consume('/')) {
+            return reader.readTime(date.time);
+        }
+        return true;
+    }
+
+    // Local midnight (as days since the epoch) of the rule date in the given year
+    std::int64_t ruleDay(const RuleDate& date, std::int64_t year) {
+        std::int64_t jan1 = daysFromCivil(year, 1, 1);
+        if (date.kind == 'J') {
+            return jan1 + date.day - 1 + (isLeapYear(year) && date.day >= 60 ? 1 : 0);
+        }
+        if (date.kind == 'N') {
+            return jan1 + date.day;
+        }
+
+        int month = static_cast<int>(date.month);
+        std::int64_t first = daysFromCivil(year, month, 1);
+        std::int64_t first_weekday = ((first + 4) % 7 + 7) % 7;  // 0 = Sunday
+        std::int64_t day = 1 + (date.weekday - first_weekday + 7) % 7 + (date.week - 1) * 7;
+        while (day > daysInMonth(year, month)) {
+            day -= 7;
+        }
+        return first + day - 1;
+    }
+
+    std::mutex zones_mutex;
+    std::map<std::string, std::shared_ptr<const TimeZone>> zones;
+}
+
+TimeZone::Cursor::Cursor(const TimeZone& zone)
+    : zone_(&zone), begin_(1), end_(0), offset_(0) {
+}
+
+std::int32_t TimeZone::Cursor::getOffset(std::int64_t utc_seconds) {
+    if (utc_seconds < begin_ || utc_seconds >= end_) {
+        size_t interval = zone_->findInterval(utc_seconds);
+        const auto& transitions = zone_->transitions_;
+        begin_ = interval > 0 ? transitions[interval - 1] : std::numeric_limits<std::int64_t>::min();
+        end_ = interval < transitions.size() ? transitions[interval] : std::numeric_limits<std::int64_t>::max();
+        offset_ = zone_->offsets_[interval];
+    }
+    return offset_;
+}
+
+TimeZone::TimeZone() : offsets_{0} {
+}
+
+std::shared_ptr<const TimeZone> TimeZone::get(const std::string& name) {
+    std::lock_guard<std::mutex> lock(zones_mutex);
+    auto it = zones.find(name);
+    if (it != zones.end()) {
+        return it->second;
+    }
+
+    std::shared_ptr<const TimeZone> result;
+    if (name == "UTC" || name == "Etc/UTC") {
+        std::shared_ptr<TimeZone> zone(new TimeZone());
+        zone->name_ = name;
+        result = zone;
+    } else if (name.find("..") == std::string::npos && (name.empty() || name[0] != '/')) {
+        std::string path;
+        if (name.empty()) {
+            path = "/etc/localtime";
+        } else {
+            const char* tzdir = std::getenv("TZDIR");
+            path = std::string(tzdir ? tzdir : "/usr/share/zoneinfo") + "/" + name;
+        }
+
+        std::ifstream file(path, std::ios::binary);
+        if (file) {
+            std::ostringstream buffer;
+            buffer << file.rdbuf();
+
+            std::shared_ptr<TimeZone> zone(new TimeZone());
+            zone->name_ = name.empty() ? "local" : name;
+            if (zone->parseTzif(buffer.str())) {
+                result = zone;
+            }
+        }
+    }
+
+    // Failures are cached too, so a bad name is not retried on every call
+    zones.emplace(name, result);
+    return result;
+}
+
+std::shared_ptr<const TimeZone> TimeZone::utc() {
+    static std::shared_ptr<const TimeZone> zone = get("UTC");
+    return zone;
+}
+
+std::int32_t TimeZone::getOffset(std::int64_t utc_seconds) const {
+    return offsets_[findInterval(utc_seconds)];
+}
+
+std::int32_t TimeZone::getOffset(const std::chrono::system_clock::time_point& time) const {
+    return getOffset(toUnixSeconds(time));
+}
+
+std::int64_t TimeZone::toUnixSeconds(const std::chrono::system_clock::time_point& time) {
+    return std::chrono::floor<std::chrono::seconds>(time.time_since_epoch()).count();
+}
+
+bool TimeZone::fromUnixSeconds(std::int64_t utc_seconds, std::chrono::system_clock::time_point& time) {
+    const std::int64_t limit =
+        std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::duration::max()).count();
+    if (utc_seconds < -limit || utc_seconds > limit) {
+        return false;
+    }
+    time = std::chrono::system_clock::time_point(std::chrono::seconds(utc_seconds));
+    return true;
+}
+
+bool TimeZone::parseIso8601(const std::string& text, std::int64_t& utc_seconds) {
+    int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0, consumed = 0;
+    if (std::sscanf(text.c_str(), "%4d-%2d-%2d%*1[Tt ]%2d:%2d%n", &year, &month, &day, &hour, &minute,
+                    &consumed) != 5) {
+        return false;
+    }
+    const char* rest = text.c_str() + consumed;
+    if (*rest == ':') {
+        int more = 0;
+        if (std::sscanf(rest, ":%2d%n", &second, &more) != 1) {
+            return false;
+        }
+        rest += more;
+    }
+    int offset = 0;
+    if (*rest == '+' || *rest == '-') {
+        int offset_hours = 0, offset_minutes = 0, more = 0;
+        if (std::sscanf(rest + 1, "%2d:%2d%n", &offset_hours, &offset_minutes, &more) != 2) {
+            return false;
+        }
+        offset = (*rest == '-' ? -1 : 1) * (offset_hours * 3600 + offset_minutes * 60);
+        rest += 1 + more;
+    } else if (*rest == 'Z' || *rest == 'z') {
+        ++rest;
+    }
+    if (*rest != '\0' || month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month) || hour > 23 ||
+        minute > 59 || second > 60) {
+        return false;
+    }
+    utc_seconds = daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second - offset;
+    return true;
+}
+
+size_t TimeZone::findInterval(std::int64_t utc_seconds) const {
+    auto it = std::upper_bound(transitions_.begin(), transitions_.end(), utc_seconds);
+    return static_cast<size_t>(it - transitions_.begin());
+}
+
+bool TimeZone::parseTzif(const std::string& data) {
+    // RFC 8536: 44-byte header, then the data block; v2+ files repeat both with 64-bit times
+    const size_t HEADER_SIZE = 44;
+    if (data.size() < HEADER_SIZE || data.compare(0, 4, "TZif") != 0) {
+        return false;
+    }
+
+    size_t pos = 0;
+    int version = data[4] == '\0' ? 1 : data[4] - '0';
+    size_t time_size = 4;
+
+    for (int pass = 0; pass < 2; ++pass) {
+        if (data.size() < pos + HEADER_SIZE) {
+            return false;
+        }
+        size_t isutcnt = static_cast<size_t>(readBigEndian(data, pos + 20, 4));
+        size_t isstdcnt = static_cast<size_t>(readBigEndian(data, pos + 24, 4));
+        size_t leapcnt = static_cast<size_t>(readBigEndian(data, pos + 28, 4));
+        size_t timecnt = static_cast<size_t>(readBigEndian(data, pos + 32, 4));
+        size_t typecnt = static_cast<size_t>(readBigEndian(data, pos + 36, 4));
+        size_t charcnt = static_cast<size_t>(readBigEndian(data, pos + 40, 4));
+        pos += HEADER_SIZE;
+
+        size_t block_size = timecnt * time_size + timecnt + typecnt * 6 + charcnt +
+                            leapcnt * (time_size + 4) + isstdcnt + isutcnt;
+        if (typecnt == 0 || data.size() < pos + block_size) {
+            return false;
+        }
+
+        if (version >= 2 && pass == 0) {
+            // Skip the 32-bit block in favour of the 64-bit one that follows
+            pos += block_size;
+            time_size = 8;
+            continue;
+        }
+
+        size_t types_pos = pos + timecnt * time_size + timecnt;
+        std::vector<std::int32_t> type_offsets(typecnt);
+        for (size_t i = 0; i < typecnt; ++i) {
+            type_offsets[i] = static_cast<std::int32_t>(readBigEndian(data, types_pos + i * 6, 4));
+        }
+
+        transitions_.clear();
+        offsets_.assign(1, type_offsets[0]);
+        for (size_t i = 0; i < timecnt; ++i) {
+            std::int64_t when = readBigEndian(data, pos + i * time_size, time_size);
+            size_t type = static_cast<unsigned char>(data[pos + timecnt * time_size + i]);
+            if (type >= typecnt) {
+                return false;
+            }
+            transitions_.push_back(when);
+            offsets_.push_back(type_offsets[type]);
+        }
+        pos += block_size;
+        break;
+    }
+
+    if (version >= 2 && pos < data.size() && data[pos] == '\n') {
+        size_t end = data.find('\n', pos + 1);
+        if (end != std::string::npos && end > pos + 1) {
+            applyPosixRule(data.substr(pos + 1, end - pos - 1));
+        }
+    }
+    return true;
+}
+
+bool TimeZone::applyPosixRule(const std::string& rule) {
+    PosixRuleReader reader(rule);
+
+    std::int64_t std_offset = 0;
+    if (!reader.readName() || !reader.readTime(std_offset)) {
+        return false;
+    }
+    // POSIX offsets count hours west of Greenwich
+    std::int32_t std_utc_offset = static_cast<std::int32_t>(-std_offset);
+
+    if (reader.atEnd()) {
+        offsets_.back() = std_utc_offset;
+        return true;
+    }
+
+    if (!reader.readName()) {
+        return false;
+    }
+    std::int32_t dst_utc_offset = std_utc_offset + 3600;
+    if (!reader.peek(',')) {
+        std::int64_t dst_offset = 0;
+        if (!reader.atEnd() && reader.readTime(dst_offset)) {
+            dst_utc_offset = static_cast<std::int32_t>(-dst_offset);
+        }
+    }
+
+    RuleDate start, end;
+    if (reader.consume(',')) {
+        if (!readRuleDate(reader, start) || !reader.consume(',') || !readRuleDate(reader, end)) {
+            return false;
+        }
+    } else {
+        // Default rule from POSIX: US rules since 2007
+        start = {'M', 0, 3, 2, 0, 7200};
+        end = {'M', 0, 11, 1, 0, 7200};
+    }
+
+    std::int64_t last = transitions_.empty() ? std::numeric_limits<std::int64_t>::min() : transitions_.back();
+    std::int64_t first_year = transitions_.empty() ? 1970 : civilYear(last / 86400);
+
+    for (std::int64_t year = first_year; year <= LAST_EXPANDED_YEAR; ++year) {
+        // DST starts at local standard time and ends at local daylight time
+        std::int64_t dst_begins = ruleDay(start, year) * 86400 + start.time - std_utc_offset;
+        std::int64_t dst_ends = ruleDay(end, year) * 86400 + end.time - dst_utc_offset;
+
+        std::pair<std::int64_t, std::int32_t> changes[2] = {
+            {dst_begins, dst_utc_offset}, {dst_ends, std_utc_offset}};
+        if (dst_ends < dst_begins) {
+            std::swap(changes[0], changes[1]);
+        }
+        for (const auto& change : changes) {
+            if (change.first > last) {
+                transitions_.push_back(change.first);
+                offsets_.push_back(change.second);
+                last = change.first;
+            }
+        }
+    }
+    return true;
+}
\ No newline at end of file
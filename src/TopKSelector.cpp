@@ -0,0 +1,42 @@
+#include "TopKSelector.h"
+#include <algorithm>
+
+TopKSelector::TopKSelector(size_t k) : k_(k) {
+    heap_.reserve(k);
+}
+
+bool TopKSelector::offer(double score, size_t index) {
+    if (!wouldAccept(score, index)) {
+        return false;
+    }
+
+    // With isBetter as the ordering, the heap front is the worst retained entry
+    if (full()) {
+        std::pop_heap(heap_.begin(), heap_.end(), isBetter);
+        heap_.back() = {score, index};
+    } else {
+        heap_.push_back({score, index});
+    }
+    std::push_heap(heap_.begin(), heap_.end(), isBetter);
+    return true;
+}
+
+bool TopKSelector::wouldAccept(double score, size_t index) const {
+    if (k_ == 0) {
+        return false;
+    }
+    return !full() || isBetter({score, index}, heap_.front());
+}
+
+void TopKSelector::merge(const TopKSelector& other) {
+    for (const auto& entry : other.heap_) {
+        offer(entry.score, entry.index);
+    }
+}
+
+std::vector<TopKSelector::Entry> TopKSelector::take() {
+    std::sort_heap(heap_.begin(), heap_.end(), isBetter);
+    std::vector<Entry> result;
+    result.swap(heap_);
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,379 @@
+#include "UserConfigStore.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+
+UserConfigStore::UserConfigStore() : UserConfigStore(Options()) {
+}
+
+UserConfigStore::UserConfigStore(const Options& options)
+    : options_(options), stopping_(false) {
+    options_.shard_count = std::max<size_t>(1, options_.shard_count);
+    shard_bytes_ = options_.max_bytes / options_.shard_count;
+    shards_.reserve(options_.shard_count);
+    for (size_t i = 0; i < options_.shard_count; ++i) {
+        shards_.push_back(std::make_unique<Shard>());
+    }
+
+    if (options_.flush_interval.count() > 0) {
+        writer_ = std::thread(&UserConfigStore::runWriter, this);
+    }
+}
+
+UserConfigStore::~UserConfigStore() {
+    if (writer_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(writer_mutex_);
+            stopping_ = true;
+        }
+        writer_wake_.notify_all();
+        writer_.join();
+    }
+    flush();
+}
+
+std::shared_ptr<const UserConfigStore::Entry> UserConfigStore::get(const std::string& user_id) {
+    std::string error;
+    return get(user_id, error);
+}
+
+std::shared_ptr<const UserConfigStore::Entry> UserConfigStore::get(const std::string& user_id,
+                                                                   std::string& error) {
+    if (!isValidUserId(user_id)) {
+        error = "Invalid user id: " + user_id;
+        return nullptr;
+    }
+
+    Shard& shard = shardFor(user_id);
+    std::shared_ptr<Loading> loading;
+    bool parsing = false;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (auto entry = findLocked(shard, user_id)) {
+            shard.hits++;
+            return entry;
+        }
+        auto it = shard.loading.find(user_id);
+        if (it != shard.loading.end()) {
+            loading = it->second;
+            shard.hits++;
+        } else {
+            loading = std::make_shared<Loading>();
+            shard.loading.emplace(user_id, loading);
+            parsing = true;
+        }
+    }
+
+    LoadResult result;
+    if (!parsing) {
+        // Another thread is already parsing this user's file
+        result = loading->result.get();
+        if (!result.entry) {
+            error = result.error;
+        }
+        return result.entry;
+    }
+
+    // Parse outside the lock; only misses for this user wait on it
+    while (true) {
+        result = LoadResult();
+        bool loaded = loadEntry(user_id, result.entry, result.error);
+        std::shared_ptr<Loading> newer;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            if (loaded) {
+                shard.loads++;
+            } else {
+                shard.load_failures++;
+            }
+            auto it = shard.loading.find(user_id);
+            if (it != shard.loading.end() && it->second == loading) {
+                shard.loading.erase(it);
+                if (loaded) {
+                    insertLocked(shard, user_id, result.entry);
+                }
+                break;
+            }
+            // A put() for this user landed meanwhile, so the file may be stale
+            result = {findLocked(shard, user_id), ""};
+            if (result.entry) {
+                break;
+            }
+            // That config has since been written back and evicted: read the file again,
+            // or share the parse another miss has started in the meantime
+            if (it != shard.loading.end()) {
+                newer = it->second;
+            } else {
+                shard.loading.emplace(user_id, loading);
+            }
+        }
+        if (newer) {
+            result = newer->result.get();
+            break;
+        }
+    }
+
+    loading->promise.set_value(result);
+    if (!result.entry) {
+        error = result.error;
+    }
+    return result.entry;
+}
+
+bool UserConfigStore::put(const std::string& user_id, const UserConfig& config, std::string& error) {
+    if (!isValidUserId(user_id)) {
+        error = "Invalid user id: " + user_id;
+        return false;
+    }
+    std::vector<std::string> errors = ConfigManager::getValidationErrors(config);
+    if (!errors.empty()) {
+        error = errors.front();
+        return false;
+    }
+
+    auto entry = std::make_shared<Entry>();
+    entry->config = config;
+    compilePreferences(entry->config, entry->preferences);
+
+    Shard& shard = shardFor(user_id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.loading.erase(user_id);
+    shard.dirty[user_id] = entry;
+    insertLocked(shard, user_id, std::move(entry));
+    return true;
+}
+
+size_t UserConfigStore::flush() {
+    std::lock_guard<std::mutex> flush_lock(flush_mutex_);
+    size_t written = 0;
+
+    for (auto& shard_ptr : shards_) {
+        Shard& shard = *shard_ptr;
+        std::vector<std::pair<std::string, std::shared_ptr<const Entry>>> batch;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            batch.assign(shard.dirty.begin(), shard.dirty.end());
+        }
+        if (batch.empty()) {
+            continue;
+        }
+
+        // Entries stay in the dirty map until they are on disk, so a miss in between
+        // still finds the newest config rather than the old file
+        std::vector<bool> succeeded(batch.size());
+        for (size_t i = 0; i < batch.size(); ++i) {
+            succeeded[i] = writeEntry(batch[i].first, *batch[i].second);
+        }
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (!succeeded[i]) {
+                shard.write_failures++;
+                continue;
+            }
+            shard.writes++;
+            written++;
+            // Keep it dirty if it was replaced while being written
+            auto it = shard.dirty.find(batch[i].first);
+            if (it != shard.dirty.end() && it->second == batch[i].second) {
+                shard.dirty.erase(it);
+            }
+        }
+    }
+    return written;
+}
+
+UserConfigStore::Stats UserConfigStore::getStats() const {
+    Stats stats{};
+    for (const auto& shard_ptr : shards_) {
+        Shard& shard = *shard_ptr;
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        stats.hits += shard.hits;
+        stats.loads += shard.loads;
+        stats.load_failures += shard.load_failures;
+        stats.evictions += shard.evictions;
+        stats.writes += shard.writes;
+        stats.write_failures += shard.write_failures;
+        stats.cached_entries += shard.lru.size();
+        stats.cached_bytes += shard.bytes;
+        stats.dirty_entries += shard.dirty.size();
+    }
+    return stats;
+}
+
+bool UserConfigStore::compilePreferences(const UserConfig& config, Preferences& preferences) {
+    for (const auto& interest : config.interests) {
+        preferences.addInterest(interest.first, interest.second);
+    }
+    for (const auto& slot : config.preferred_time_slots) {
+        preferences.addPreferredTimeSlot(slot.start_hour, slot.end_hour, HourOfWeekMask::parseDays(slot.days));
+    }
+    bool known_zone = preferences.setTimeZone(config.location.timezone);
+    preferences.setLocation(config.location.city);
+    preferences.setMaxTravelDistance(config.max_travel_distance_km);
+    // 0,0 is the unset default rather than a real home location
+    if (config.location.latitude != 0.0 || config.location.longitude != 0.0) {
+        preferences.setCoordinates({config.location.latitude, config.location.longitude});
+    }
+    return known_zone;
+}
+
+bool UserConfigStore::isValidUserId(const std::string& user_id) {
+    if (user_id.empty() || user_id[0] == '.') {
+        return false;
+    }
+    return std::all_of(user_id.begin(), user_id.end(), [](char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+               c == '_' || c == '-' || c == '.';
+    });
+}
+
+UserConfigStore::Shard& UserConfigStore::shardFor(const std::string& user_id) {
+    return *shards_[std::hash<std::string>()(user_id) % shards_.size()];
+}
+
+void UserConfigStore::insertLocked(Shard& shard, const std::string& user_id, std::shared_ptr<const Entry> entry) {
+    size_t bytes = estimateBytes(*entry);
+    auto it = shard.index.find(user_id);
+    if (it != shard.index.end()) {
+        shard.bytes -= it->second->bytes;
+        it->second->entry = std::move(entry);
+        it->second->bytes = bytes;
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    } else {
+        shard.lru.push_front({user_id, std::move(entry), bytes});
+        shard.index[user_id] = shard.lru.begin();
+    }
+    shard.bytes += bytes;
+
+    // Dirty entries evicted here are still held by the dirty map until written
+    while (shard.bytes > shard_bytes_ && shard.lru.size() > 1) {
+        auto& oldest = shard.lru.back();
+        shard.bytes -= oldest.bytes;
+        shard.index.erase(oldest.user_id);
+        shard.lru.pop_back();
+        shard.evictions++;
+    }
+}
+
+std::shared_ptr<const UserConfigStore::Entry> UserConfigStore::findLocked(Shard& shard,
+                                                                          const std::string& user_id) {
+    auto it = shard.index.find(user_id);
+    if (it != shard.index.end()) {
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        return it->second->entry;
+    }
+    // Evicted before it was written back; the file is stale
+    auto dirty_it = shard.dirty.find(user_id);
+    if (dirty_it != shard.dirty.end()) {
+        std::shared_ptr<const Entry> entry = dirty_it->second;
+        insertLocked(shard, user_id, entry);
+        return entry;
+    }
+    return nullptr;
+}
+
+bool UserConfigStore::loadEntry(const std::string& user_id, std::shared_ptr<const Entry>& entry,
+                                std::string& error) const {
+    std::string path = pathFor(user_id);
+    auto loaded = std::make_shared<Entry>();
+    try {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            error = "No config for user: " + user_id;
+            return false;
+        }
+        nlohmann::json j;
+        file >> j;
+        j.get_to(loaded->config);
+    } catch (const std::exception& e) {
+        error = path + ": " + e.what();
+        return false;
+    }
+
+    std::vector<std::string> errors = ConfigManager::getValidationErrors(loaded->config);
+    if (!errors.empty()) {
+        error = path + ": " + errors.front();
+        return false;
+    }
+
+    compilePreferences(loaded->config, loaded->preferences);
+    entry = std::move(loaded);
+    return true;
+}
+
+bool UserConfigStore::writeEntry(const std::string& user_id, const Entry& entry) const {
+    std::string serialized = ConfigManager::toJson(entry.config).dump(2);
+
+    std::error_code ec;
+    std::filesystem::create_directories(options_.directory, ec);
+    std::string path = pathFor(user_id);
+    std::string temp_path = path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        file << serialized;
+        if (!file) {
+            return false;
+        }
+    }
+    std::filesystem::rename(temp_path, path, ec);
+    if (ec) {
+        std::filesystem::remove(temp_path, ec);
+        return false;
+    }
+    return true;
+}
+
+std::string UserConfigStore::pathFor(const std::string& user_id) const {
+    return (std::filesystem::path(options_.directory) / (user_id + ".json")).string();
+}
+
+void UserConfigStore::runWriter() {
+    std::unique_lock<std::mutex> lock(writer_mutex_);
+    while (!stopping_) {
+        writer_wake_.wait_for(lock, options_.flush_interval, [this] { return stopping_; });
+        if (stopping_) {
+            break;
+        }
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
+
+size_t UserConfigStore::estimateBytes(const Entry& entry) {
+    // Rough footprint of the config plus its compiled preferences; exact accounting
+    // is not needed to hold the cache near its cap
+    const UserConfig& config = entry.config;
+    size_t bytes = sizeof(Entry) + sizeof(CachedEntry) + 2 * config.name.size() + config.email.size() +
+                   config.location.address.size() + config.location.city.size() +
+                   config.openai_config.api_key.size() + config.claude_config.api_key.size();
+    for (const auto& interest : config.interests) {
+        // Map node in the config plus hash node in the preferences
+        bytes += 2 * interest.first.size() + 96;
+    }
+    for (const auto& slot : config.preferred_time_slots) {
+        bytes += sizeof(TimeSlot) + slot.days.size() * sizeof(std::string) + 16;
+    }
+    for (const auto& list : {&config.preferred_transportation, &config.accessibility_needs,
+                             &config.dietary_restrictions}) {
+        for (const auto& item : *list) {
+            bytes += sizeof(std::string) + item.size();
+        }
+    }
+
+    // The compiled weights are dense over global tag ids, so a user with one interest
+    // still pays for every tag interned before it
+    const Preferences& preferences = entry.preferences;
+    bytes += preferences.getInterests().bucket_count() * sizeof(void*) +
+             preferences.getInterestWeights().capacity() * sizeof(int) +
+             preferences.getInterestMask().capacity() * sizeof(std::uint8_t) +
+             preferences.getPreferredTimeSlots().capacity() * sizeof(std::pair<int, int>) +
+             preferences.getPreferredTimeSlotDays().capacity() * sizeof(std::uint8_t);
+    return bytes;
+}
\ No newline at end of file
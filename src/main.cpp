@@ -4,10 +4,17 @@
 #include "RecommendationEngine.h"
 #include "OpenAIService.h"
 #include "ClaudeService.h"
+#include "RoutingService.h"
 #include "ConfigManager.h"
+#include "ConfigWatcher.h"
+#include "EventCatalog.h"
+#include "EventFeedReader.h"
+#include "UserConfigStore.h"
+#include <cstring>
 #include <iostream>
 #include <memory>
 #include <chrono>
+#include <thread>
 
 void printRecommendations(const std::vector<RecommendationEngine::EventRecommendation>& recommendations) {
     std::cout << "\n=== Event Recommendations ===\n";
@@ -20,22 +27,51 @@ void printRecommendations(const std::vector<RecommendationEngine::EventRecommend
     }
 }
 
-void setupSampleData(User& user, std::vector<Event>& events, const UserConfig& config) {
-    // Load preferences from config
-    auto& preferences = user.getPreferences();
-    for (const auto& interest : config.interests) {
-        preferences.addInterest(interest.first, interest.second);
+void printConnectionStats(const ConnectionPool::Stats& stats) {
+    std::cout << "Connection pool: " << stats.created << " created, " << stats.reused << " reused, "
+              << stats.evicted << " evicted, " << stats.idle << "/" << stats.max_size << " idle"
+              << " (idle timeout " << stats.idle_timeout_seconds << "s)\n";
+}
+
+void printRequestStats(const AIService& service) {
+    auto stats = service.getRequestStats();
+    auto limiter_stats = service.getRateLimiter()->getStats();
+    std::cout << "AI requests (" << service.getProviderName() << "): " << stats.requests << " sent, " << stats.retries << " retries ("
+              << stats.throttled << " throttled, " << stats.server_errors << " server errors, "
+              << stats.timeouts << " timeouts), " << stats.failures << " failed; "
+              << limiter_stats.delayed << " held by the rate limiter for "
+              << limiter_stats.total_delay.count() << " ms\n";
+}
+
+void printRoutingStats(const RoutingService& router) {
+    auto stats = router.getStats();
+    std::cout << "Routing: " << stats.requests << " requests, " << stats.hedged << " hedged ("
+              << stats.hedge_wins << " won by the hedge), " << stats.failovers << " failovers, "
+              << stats.failures << " failed\n";
+    for (const auto& provider : router.getProviderStats()) {
+        std::cout << "  " << provider.name << (provider.healthy ? "" : " (unhealthy)") << ": "
+                  << provider.requests << " requests, " << provider.wins << " won, "
+                  << provider.cancelled << " cancelled, " << provider.failures << " failed; latency ewma "
+                  << provider.ewma_ms << " ms, p95 " << provider.p95_ms << " ms, p99 "
+                  << provider.p99_ms << " ms over " << provider.samples << " samples\n";
     }
-    
-    // Convert time slots from config
-    std::vector<std::pair<int, int>> time_slots;
-    for (const auto& slot : config.preferred_time_slots) {
-        time_slots.push_back({slot.start_hour, slot.end_hour});
+}
+
+void printCacheStats(const ResponseCache::Stats& stats) {
+    std::cout << "Response cache: " << (stats.memory_hits + stats.disk_hits) << " hits ("
+              << stats.disk_hits << " from disk), " << stats.misses << " misses, "
+              << stats.memory_entries << " entries in memory, " << stats.disk_entries << " on disk\n";
+}
+
+void loadPreferences(User& user, const UserConfig& config) {
+    auto& preferences = user.getPreferences();
+    if (!UserConfigStore::compilePreferences(config, preferences)) {
+        std::cerr << "Unknown time zone '" << config.location.timezone << "', using "
+                  << preferences.getTimeZone().getName() << "\n";
     }
-    preferences.setPreferredTimeSlots(time_slots);
-    preferences.setLocation(config.location.city);
-    preferences.setMaxTravelDistance(config.max_travel_distance_km);
-    
+}
+
+void setupSampleData(std::vector<Event>& events) {
     auto now = std::chrono::system_clock::now();
     auto tomorrow = now + std::chrono::hours(24);
     auto day_after = now + std::chrono::hours(48);
@@ -43,21 +79,50 @@ void setupSampleData(User& user, std::vector<Event>& events, const UserConfig& c
     events.push_back(Event("Tech Conference 2024", "Annual technology conference", 
                           tomorrow, tomorrow + std::chrono::hours(8), 
                           "San Francisco Convention Center", {"technology", "networking"}));
+    events.back().setCoordinates({37.7842, -122.4016});
     
     events.push_back(Event("Jazz Night", "Live jazz music performance", 
                           tomorrow + std::chrono::hours(19), tomorrow + std::chrono::hours(22), 
                           "Blue Note SF", {"music", "entertainment"}));
+    events.back().setCoordinates({37.7989, -122.4072});
     
     events.push_back(Event("Basketball Game", "Local team championship", 
                           day_after + std::chrono::hours(15), day_after + std::chrono::hours(18), 
                           "Oracle Arena", {"sports", "entertainment"}));
+    events.back().setCoordinates({37.7503, -122.2030});
     
     events.push_back(Event("Cooking Workshop", "Learn Italian cuisine", 
                           day_after + std::chrono::hours(11), day_after + std::chrono::hours(14), 
                           "Culinary Institute", {"cooking", "education"}));
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc == 4 && std::strcmp(argv[1], "--build-catalog") == 0) {
+        std::string error;
+        if (!EventCatalog::convertJson(argv[2], argv[3], error)) {
+            std::cerr << "Failed to build catalog: " << error << "\n";
+            return 1;
+        }
+        std::cout << "Wrote event catalog " << argv[3] << "\n";
+        return 0;
+    }
+    
+    std::shared_ptr<const EventCatalog> catalog;
+    std::string feed_path;
+    if (argc == 3 && std::strcmp(argv[1], "--feed") == 0) {
+        feed_path = argv[2];
+    } else if (argc == 3 && std::strcmp(argv[1], "--catalog") == 0) {
+        std::string error;
+        catalog = EventCatalog::open(argv[2], error);
+        if (!catalog) {
+            std::cerr << "Failed to open catalog: " << error << "\n";
+            return 1;
+        }
+    } else if (argc != 1) {
+        std::cerr << "Usage: " << argv[0] << " [--catalog <file> | --feed <events.json> | --build-catalog <events.json> <file>]\n";
+        return 1;
+    }
+    
     std::cout << "=== MasterBot Schedule Manager ===\n";
     
     ConfigManager config_manager;
@@ -67,52 +132,144 @@ int main() {
         return 1;
     }
     
-    const auto& config = config_manager.getConfig();
+    // Each phase below reads the snapshot current when it starts, so reloads apply from
+    // the next phase on and no phase mixes fields from two versions of the file
+    auto config = config_manager.getSnapshot();
+    
+    // Later edits to the file are validated and published as new snapshots in the background
+    ConfigWatcher config_watcher(config_manager, [&config_manager](bool reloaded) {
+        if (reloaded) {
+            std::cout << "\nConfiguration reloaded in "
+                      << config_manager.getReloadStats().last_latency.count() / 1000.0 << " ms\n";
+        }
+    });
+    config_watcher.start();
+    
+    std::cout << "Welcome, " << config->name << "!\n";
+    std::cout << "Location: " << config->location.city << ", " << config->location.state << "\n";
+    std::cout << "Using AI provider: " << config->default_ai_provider << "\n\n";
     
-    std::cout << "Welcome, " << config.name << "!\n";
-    std::cout << "Location: " << config.location.city << ", " << config.location.state << "\n";
-    std::cout << "Using AI provider: " << config.default_ai_provider << "\n\n";
+    ConnectionPool::Options pool_options;
+    pool_options.max_size = static_cast<size_t>(config->connection_pool.max_connections);
+    pool_options.idle_timeout = std::chrono::seconds(config->connection_pool.idle_timeout_seconds);
+    auto connection_pool = std::make_shared<ConnectionPool>(pool_options);
+    // Services pick up the shared transport when constructed, so install it first
+    HttpTransport::setShared(std::make_shared<HttpTransport>(connection_pool));
     
+    std::vector<std::shared_ptr<AIService>> providers;
+    std::shared_ptr<RoutingService> router;
     std::shared_ptr<AIService> ai_service;
-    if (config.default_ai_provider == "openai") {
-        if (config.openai_config.api_key.empty()) {
+    if (!config->claude_config.api_key.empty() && !config->openai_config.api_key.empty()) {
+        auto claude = std::make_shared<ClaudeService>(config->claude_config.api_key);
+        auto openai = std::make_shared<OpenAIService>(config->openai_config.api_key);
+        // The default provider takes the first request, before either has been timed
+        if (config->default_ai_provider == "openai") {
+            providers = {openai, claude};
+        } else {
+            providers = {claude, openai};
+        }
+        router = std::make_shared<RoutingService>(providers);
+        ai_service = router;
+        std::cout << "Routing between Claude and OpenAI by latency\n";
+    } else if (config->default_ai_provider == "openai") {
+        if (config->openai_config.api_key.empty()) {
             std::cout << "OpenAI API key not configured. Enter API key: ";
             std::string api_key;
             std::cin >> api_key;
             ai_service = std::make_shared<OpenAIService>(api_key);
         } else {
-            ai_service = std::make_shared<OpenAIService>(config.openai_config.api_key);
+            ai_service = std::make_shared<OpenAIService>(config->openai_config.api_key);
         }
+        providers = {ai_service};
         std::cout << "Using OpenAI service\n";
     } else {
-        if (config.claude_config.api_key.empty()) {
+        if (config->claude_config.api_key.empty()) {
             std::cout << "Claude API key not configured. Enter API key: ";
             std::string api_key;
             std::cin >> api_key;
             ai_service = std::make_shared<ClaudeService>(api_key);
         } else {
-            ai_service = std::make_shared<ClaudeService>(config.claude_config.api_key);
+            ai_service = std::make_shared<ClaudeService>(config->claude_config.api_key);
         }
+        providers = {ai_service};
         std::cout << "Using Claude service\n";
     }
     
-    User user(config.name, config.email);
+    ResponseCache::Options cache_options;
+    cache_options.max_bytes = static_cast<size_t>(config->cache_size_mb) * 1024 * 1024;
+    cache_options.ttl = std::chrono::hours(config->cache_ttl_hours);
+    cache_options.directory = config_manager.resolvePath(config->cache_directory);
+    auto response_cache = std::make_shared<ResponseCache>(cache_options);
+    for (const auto& provider : providers) {
+        const AIServiceConfig& provider_config =
+            provider->getProviderName() == "openai" ? config->openai_config : config->claude_config;
+        RateLimiter::Options limiter_options;
+        limiter_options.requests_per_minute = provider_config.requests_per_minute;
+        limiter_options.tokens_per_minute = provider_config.tokens_per_minute;
+        provider->setRateLimiter(std::make_shared<RateLimiter>(limiter_options));
+        provider->setResponseCache(response_cache);
+        provider->setOfflineMode(config->offline_mode);
+    }
+    
+    // The recommendation request runs against the configuration current now
+    config = config_manager.getSnapshot();
+    User user(config->name, config->email);
     Schedule schedule;
     std::vector<Event> available_events;
+    EventStore event_store;
     
-    setupSampleData(user, available_events, config);
-    
-    std::cout << "\nSample events loaded:\n";
-    for (const auto& event : available_events) {
-        std::cout << "- " << event.getName() << " at " << event.getLocation() << "\n";
+    loadPreferences(user, *config);
+    if (catalog) {
+        event_store.addEvents(catalog);
+        std::cout << "\nLoaded " << event_store.size() << " events from catalog\n";
+    } else if (!feed_path.empty()) {
+        std::cout << "\nStreaming events from " << feed_path << "\n";
+    } else {
+        setupSampleData(available_events);
+        
+        std::cout << "\nSample events loaded:\n";
+        for (const auto& event : available_events) {
+            std::cout << "- " << event.getName() << " at " << event.getLocation() << "\n";
+        }
     }
     
     RecommendationEngine engine(ai_service);
+    engine.setPromptTokenBudget(static_cast<size_t>(config->prompt_token_budget));
+    engine.setThreadCount(config->scoring_threads == 0
+        ? std::thread::hardware_concurrency()
+        : static_cast<size_t>(config->scoring_threads));
     
     std::cout << "\nGenerating recommendations...\n";
-    auto recommendations = engine.recommendEvents(user, available_events, schedule, 5);
+    std::vector<RecommendationEngine::EventRecommendation> recommendations;
+    if (catalog) {
+        recommendations = engine.recommendEvents(user, event_store, schedule, 5);
+    } else if (!feed_path.empty()) {
+        // The feed is parsed on a background thread while the engine scores what has arrived
+        EventFeedReader feed(feed_path);
+        recommendations = engine.recommendEvents(user, [&feed]() { return feed.next(); }, schedule, 5);
+        if (feed.failed()) {
+            std::cerr << "Failed to read feed: " << feed.getError() << "\n";
+            return 1;
+        }
+    } else {
+        recommendations = engine.recommendEvents(user, available_events, schedule, 5,
+            [](const std::string& delta) { std::cout << delta << std::flush; });
+    }
     
     printRecommendations(recommendations);
+    std::cout << "AI prompt size: ~" << engine.getLastPromptTokenEstimate() << " tokens (budget "
+              << engine.getPromptTokenBudget() << ")\n";
+    printConnectionStats(connection_pool->getStats());
+    printCacheStats(response_cache->getStats());
+    for (const auto& provider : providers) {
+        printRequestStats(*provider);
+    }
+    if (router) {
+        printRoutingStats(*router);
+    }
+    if (!engine.getLastAIError().empty()) {
+        std::cerr << "AI reasoning unavailable: " << engine.getLastAIError() << "\n";
+    }
     
     std::cout << "\nWould you like to add any events to your schedule? (y/n): ";
     char add_choice;
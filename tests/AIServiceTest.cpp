@@ -0,0 +1,296 @@
+#include "AIService.h"
+#include "LocalHttpServer.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+    using std::chrono::milliseconds;
+    using Reply = LocalHttpServer::Reply;
+
+    // Sends requests to a local server through the shared retry path
+    class EndpointService : public AIService {
+    public:
+        explicit EndpointService(const std::string& base_url) : AIService("test-key", base_url) {
+            setTransport(std::make_shared<HttpTransport>());
+            RetryOptions options;
+            options.base_delay = milliseconds(1);
+            options.max_delay = milliseconds(4);
+            options.request_timeout = milliseconds(2000);
+            setRetryOptions(options);
+        }
+
+        AIResponse post(CancelFlag cancel = nullptr) {
+            return toFuture([&](ResponseCallback on_complete) { postAsync(std::move(on_complete), cancel); }).get();
+        }
+
+        void postAsync(ResponseCallback on_complete, CancelFlag cancel = nullptr) {
+            makeRequestAsync("/v1/test", {{"prompt", "hello"}, {"max_tokens", 16}}, std::move(on_complete), cancel);
+        }
+
+        // Returns the completion; the data of every event received is appended to events
+        AIResponse stream(std::vector<std::string>& events) {
+            return toFuture([&](ResponseCallback on_complete) {
+                makeStreamingRequestAsync("/v1/stream", {{"prompt", "hello"}},
+                                          [&events](const std::string&, const std::string& data) {
+                                              events.push_back(data);
+                                          },
+                                          std::move(on_complete));
+            }).get();
+        }
+
+        std::future<AIResponse> generateResponse(const std::string&) override { return {}; }
+        void generateResponse(const std::string&, ResponseCallback, CancelFlag) override {}
+        std::future<AIResponse> analyzePreferences(const std::string&) override { return {}; }
+        std::future<AIResponse> recommendEvents(const std::string&, const std::string&) override { return {}; }
+        void streamResponse(const std::string&, DeltaCallback, ResponseCallback) override {}
+        std::string getProviderName() const override { return "endpoint"; }
+        std::string getModelName() const override { return "endpoint"; }
+    };
+
+    HttpTransport::Response transferFailure(CURLcode result) {
+        return {false, 0, "", curl_easy_strerror(result), result};
+    }
+
+    HttpTransport::Response httpStatus(long status_code) {
+        return {true, status_code, "", ""};
+    }
+
+    Reply status(int code, std::vector<std::string> headers = {}) {
+        Reply reply;
+        reply.status = code;
+        reply.body = "{\"error\": " + std::to_string(code) + "}";
+        reply.headers = std::move(headers);
+        return reply;
+    }
+}
+
+TEST(AIServiceTest, RetryDecisionCoversOverloadAndTransientTransferErrors) {
+    for (long code : {429L, 500L, 502L, 503L, 504L, 529L}) {
+        EXPECT_TRUE(AIService::isRetryable(httpStatus(code))) << code;
+    }
+    for (long code : {200L, 204L, 301L, 400L, 401L, 403L, 404L, 413L, 501L, 505L}) {
+        EXPECT_FALSE(AIService::isRetryable(httpStatus(code))) << code;
+    }
+    for (CURLcode result : {CURLE_COULDNT_RESOLVE_HOST, CURLE_COULDNT_CONNECT, CURLE_OPERATION_TIMEDOUT,
+                            CURLE_SSL_CONNECT_ERROR, CURLE_SEND_ERROR, CURLE_RECV_ERROR, CURLE_GOT_NOTHING,
+                            CURLE_PARTIAL_FILE, CURLE_HTTP2, CURLE_HTTP2_STREAM}) {
+        EXPECT_TRUE(AIService::isRetryable(transferFailure(result))) << result;
+    }
+    for (CURLcode result : {CURLE_UNSUPPORTED_PROTOCOL, CURLE_URL_MALFORMAT, CURLE_ABORTED_BY_CALLBACK,
+                            CURLE_WRITE_ERROR, CURLE_PEER_FAILED_VERIFICATION, CURLE_FAILED_INIT}) {
+        EXPECT_FALSE(AIService::isRetryable(transferFailure(result))) << result;
+    }
+}
+
+TEST(AIServiceTest, BackoffDoublesWithinJitterRangeUpToCap) {
+    AIService::RetryOptions options;
+    options.base_delay = milliseconds(100);
+    options.max_delay = milliseconds(1000);
+
+    for (int retry = 0; retry < 40; ++retry) {
+        long cap = std::min(100L << std::min(retry, 20), 1000L);
+        long low = cap, high = 0;
+        for (int sample = 0; sample < 400; ++sample) {
+            long delay = static_cast<long>(AIService::backoffDelay(options, retry).count());
+            low = std::min(low, delay);
+            high = std::max(high, delay);
+        }
+        EXPECT_GE(low, cap / 2) << retry;
+        EXPECT_LE(high, cap) << retry;
+        // The jitter actually spreads over the range
+        EXPECT_LT(low, cap * 6 / 10) << retry;
+        EXPECT_GT(high, cap * 9 / 10) << retry;
+    }
+}
+
+TEST(AIServiceTest, RetriesOverloadStatusesThenSucceeds) {
+    for (int code : {429, 500, 502, 503, 504, 529}) {
+        LocalHttpServer server;
+        server.script({status(code), status(code)});
+        EndpointService service(server.url());
+
+        auto response = service.post();
+        EXPECT_TRUE(response.success) << code << ": " << response.error_message;
+        EXPECT_EQ(server.getRequests().size(), 3u) << code;
+
+        auto stats = service.getRequestStats();
+        EXPECT_EQ(stats.requests, 1u);
+        EXPECT_EQ(stats.retries, 2u);
+        EXPECT_EQ(stats.throttled, code == 429 ? 2u : 0u);
+        EXPECT_EQ(stats.server_errors, code == 429 ? 0u : 2u);
+        EXPECT_EQ(stats.failures, 0u);
+        // Only a 429 speaks for the whole account
+        EXPECT_EQ(service.getRateLimiter()->getStats().pauses, code == 429 ? 2u : 0u) << code;
+    }
+}
+
+TEST(AIServiceTest, StopsAfterMaxAttempts) {
+    LocalHttpServer server;
+    server.setDefaultReply(status(503));
+    EndpointService service(server.url());
+    auto options = service.getRetryOptions();
+    options.max_attempts = 3;
+    service.setRetryOptions(options);
+
+    auto response = service.post();
+    EXPECT_FALSE(response.success);
+    EXPECT_EQ(response.error_message.rfind("HTTP 503", 0), 0u) << response.error_message;
+    EXPECT_EQ(server.getRequests().size(), 3u);
+
+    auto stats = service.getRequestStats();
+    EXPECT_EQ(stats.retries, 2u);
+    EXPECT_EQ(stats.server_errors, 3u);
+    EXPECT_EQ(stats.failures, 1u);
+}
+
+TEST(AIServiceTest, ClientErrorsAreNotRetried) {
+    for (int code : {400, 401, 404, 501}) {
+        LocalHttpServer server;
+        server.script({status(code)});
+        EndpointService service(server.url());
+
+        auto response = service.post();
+        EXPECT_FALSE(response.success) << code;
+        EXPECT_EQ(server.getRequests().size(), 1u) << code;
+        EXPECT_EQ(service.getRequestStats().retries, 0u) << code;
+        EXPECT_EQ(service.getRequestStats().failures, 1u) << code;
+    }
+}
+
+TEST(AIServiceTest, RetriesTransientTransferErrorsOnly) {
+    // Connection closed with no answer (CURLE_GOT_NOTHING), then a timeout
+    LocalHttpServer server;
+    Reply dropped, held;
+    dropped.drop = true;
+    held.hold = true;
+    server.script({dropped, held});
+    EndpointService service(server.url());
+    auto options = service.getRetryOptions();
+    options.request_timeout = milliseconds(300);
+    service.setRetryOptions(options);
+
+    auto response = service.post();
+    EXPECT_TRUE(response.success) << response.error_message;
+    EXPECT_EQ(server.getRequests().size(), 3u);
+    auto stats = service.getRequestStats();
+    EXPECT_EQ(stats.retries, 2u);
+    EXPECT_EQ(stats.timeouts, 1u);
+    EXPECT_EQ(stats.failures, 0u);
+
+    // Nothing listening: retried until max_attempts
+    std::string closed_url = server.url();
+    server.stop();
+    EndpointService refused(closed_url);
+    response = refused.post();
+    EXPECT_FALSE(response.success);
+    EXPECT_EQ(refused.getRequestStats().retries, static_cast<size_t>(refused.getRetryOptions().max_attempts - 1));
+    EXPECT_EQ(refused.getRequestStats().failures, 1u);
+
+    // A URL curl cannot handle will not improve with retrying
+    EndpointService unsupported("bogus://example.com");
+    response = unsupported.post();
+    EXPECT_FALSE(response.success);
+    EXPECT_EQ(unsupported.getRequestStats().retries, 0u);
+    EXPECT_EQ(unsupported.getRequestStats().failures, 1u);
+}
+
+TEST(AIServiceTest, RetryAfterTakesPrecedenceAndHoldsSharedLimiter) {
+    LocalHttpServer server;
+    server.script({status(429, {"Retry-After: 1"})});
+    EndpointService first(server.url());
+    EndpointService second(server.url());
+    second.setRateLimiter(first.getRateLimiter());
+
+    auto first_response = AIService::toFuture([&](AIService::ResponseCallback on_complete) {
+        first.postAsync(std::move(on_complete));
+    });
+    ASSERT_TRUE(server.waitForRequests(1));
+    auto throttled_at = server.getRequests()[0].at;
+    for (int i = 0; i < 500 && first.getRateLimiter()->getStats().pauses == 0; ++i) {
+        std::this_thread::sleep_for(milliseconds(2));
+    }
+    ASSERT_EQ(first.getRateLimiter()->getStats().pauses, 1u);
+
+    // A different request on the same account waits out the pause too
+    auto second_response = second.post();
+    EXPECT_TRUE(second_response.success) << second_response.error_message;
+    EXPECT_TRUE(first_response.get().success);
+
+    auto requests = server.getRequests();
+    ASSERT_EQ(requests.size(), 3u);
+    // base_delay is 1 ms, so only the Retry-After explains a wait near a second
+    for (size_t i = 1; i < requests.size(); ++i) {
+        EXPECT_GE(requests[i].at - throttled_at, milliseconds(950)) << i;
+    }
+}
+
+TEST(AIServiceTest, StreamIsNotRetriedOnceDataHasArrived) {
+    LocalHttpServer server;
+    Reply partial;
+    partial.body = "data: first\n\n" + std::string(200, ' ');
+    partial.truncate_at = 13;
+    server.script({partial});
+    EndpointService service(server.url());
+
+    std::vector<std::string> events;
+    auto response = service.stream(events);
+    EXPECT_FALSE(response.success);
+    EXPECT_EQ(events, std::vector<std::string>{"first"});
+    EXPECT_EQ(server.getRequests().size(), 1u);
+    EXPECT_EQ(service.getRequestStats().retries, 0u);
+    EXPECT_EQ(service.getRequestStats().failures, 1u);
+
+    // An error status delivers nothing to the parser, so that is still retried
+    Reply complete;
+    complete.body = "data: second\n\n";
+    server.script({status(503), complete});
+    events.clear();
+    response = service.stream(events);
+    EXPECT_TRUE(response.success) << response.error_message;
+    EXPECT_EQ(events, std::vector<std::string>{"second"});
+    EXPECT_EQ(server.getRequests().size(), 3u);
+    EXPECT_EQ(service.getRequestStats().retries, 1u);
+}
+
+TEST(AIServiceTest, CancelledRequestIsNeitherRetriedNorCountedAsFailure) {
+    // Cancelled while the server holds the request
+    LocalHttpServer server;
+    Reply held;
+    held.hold = true;
+    server.script({held});
+    EndpointService service(server.url());
+
+    auto cancel = std::make_shared<std::atomic<bool>>(false);
+    auto response = AIService::toFuture([&](AIService::ResponseCallback on_complete) {
+        service.postAsync(std::move(on_complete), cancel);
+    });
+    ASSERT_TRUE(server.waitForRequests(1));
+    service.cancel(cancel);
+    EXPECT_FALSE(response.get().success);
+
+    // Cancelled while waiting out the backoff after a 503
+    auto options = service.getRetryOptions();
+    options.base_delay = options.max_delay = milliseconds(300);
+    service.setRetryOptions(options);
+    server.script({status(503)});
+    auto cancel_retry = std::make_shared<std::atomic<bool>>(false);
+    response = AIService::toFuture([&](AIService::ResponseCallback on_complete) {
+        service.postAsync(std::move(on_complete), cancel_retry);
+    });
+    ASSERT_TRUE(server.waitForRequests(2));
+    std::this_thread::sleep_for(milliseconds(50));
+    service.cancel(cancel_retry);
+    auto cancelled = response.get();
+    EXPECT_FALSE(cancelled.success);
+    EXPECT_EQ(cancelled.error_message, "Request cancelled");
+
+    std::this_thread::sleep_for(milliseconds(400));
+    EXPECT_EQ(server.getRequests().size(), 2u);
+    auto stats = service.getRequestStats();
+    EXPECT_EQ(stats.requests, 2u);
+    EXPECT_EQ(stats.retries, 1u);
+    EXPECT_EQ(stats.failures, 0u);
+}
\ No newline at end of file
@@ -0,0 +1,173 @@
+#include "BatchScorer.h"
+#include "RecommendationEngine.h"
+#include "NullAIService.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    std::chrono::system_clock::time_point fromIso(const std::string& text) {
+        std::int64_t seconds = 0;
+        std::chrono::system_clock::time_point time;
+        EXPECT_TRUE(TimeZone::parseIso8601(text, seconds));
+        EXPECT_TRUE(TimeZone::fromUnixSeconds(seconds, time));
+        return time;
+    }
+
+    bool sameBits(double a, double b) {
+        return std::memcmp(&a, &b, sizeof(double)) == 0;
+    }
+
+    const std::vector<std::string> ZONES = {
+        "UTC", "America/New_York", "America/Los_Angeles", "Europe/London", "Europe/Berlin",
+        "Australia/Lord_Howe", "Asia/Kolkata", "Pacific/Chatham"
+    };
+
+    // Daylight-saving changes in the zones above, in UTC
+    const std::vector<std::string> TRANSITIONS = {
+        "2026-03-08T07:00Z", "2026-11-01T06:00Z", "2026-03-08T10:00Z", "2026-11-01T09:00Z",
+        "2026-03-29T01:00Z", "2026-10-25T01:00Z", "2026-04-04T15:00Z", "2026-10-03T15:30Z",
+        "2026-04-04T14:00Z", "2026-09-26T14:00Z"
+    };
+
+    class BatchScorerTest : public ::testing::Test {
+    protected:
+        std::mt19937 rng{42};
+        EventStore store;
+        RecommendationEngine engine{std::make_shared<NullAIService>()};
+
+        std::string tag(int i) {
+            return "batch-scorer-test-tag-" + std::to_string(i);
+        }
+
+        void fillStore(size_t count) {
+            std::vector<std::chrono::system_clock::time_point> starts;
+            for (const auto& transition : TRANSITIONS) {
+                for (int delta : {-3601, -3600, -1, 0, 1, 1800, 3599, 3600}) {
+                    starts.push_back(fromIso(transition) + std::chrono::seconds(delta));
+                }
+            }
+            auto base = fromIso("2026-01-01T00:00Z");
+            std::uniform_int_distribution<int> minute(0, 365 * 24 * 60);
+            std::uniform_int_distribution<int> tag_count(0, 4);
+            std::uniform_int_distribution<int> tag_index(0, 40);
+            std::uniform_real_distribution<double> latitude(37.0, 39.0);
+            std::uniform_real_distribution<double> longitude(-123.5, -121.0);
+
+            for (size_t i = 0; i < count; ++i) {
+                auto start = i < starts.size() ? starts[i] : base + std::chrono::minutes(minute(rng));
+                std::vector<std::string> tags;
+                // Every fifth event has no tags at all
+                for (int t = i % 5 == 0 ? 0 : tag_count(rng); t > 0; --t) {
+                    tags.push_back(tag(tag_index(rng)));
+                }
+                Event event("event " + std::to_string(i), "", start, start + std::chrono::hours(2),
+                            rng() % 4 == 0 ? "" : "venue " + std::to_string(rng() % 30), tags);
+                if (rng() % 3 != 0) {
+                    event.setCoordinates({latitude(rng), longitude(rng)});
+                }
+                store.addEvent(event);
+            }
+        }
+
+        Preferences randomPreferences(const std::string& zone) {
+            Preferences preferences;
+            EXPECT_TRUE(preferences.setTimeZone(zone)) << zone;
+            std::uniform_int_distribution<int> weight(1, 10);
+            for (int i = 0; i < 40; i += 1 + static_cast<int>(rng() % 3)) {
+                preferences.addInterest(tag(i), weight(rng));
+            }
+            for (int slots = static_cast<int>(rng() % 3); slots > 0; --slots) {
+                preferences.addPreferredTimeSlot(static_cast<int>(rng() % 24), static_cast<int>(rng() % 24),
+                                                 static_cast<std::uint8_t>(1 + rng() % 127));
+            }
+            if (rng() % 2 == 0) {
+                preferences.setLocation("home");
+            }
+            if (rng() % 4 != 0) {
+                preferences.setCoordinates({37.77, -122.42});
+                // Short enough that many events fall outside it
+                preferences.setMaxTravelDistance(5.0 + static_cast<double>(rng() % 100));
+            }
+            return preferences;
+        }
+    };
+}
+
+TEST_F(BatchScorerTest, TileScoresMatchPerEventScoresBitForBit) {
+    fillStore(3000);
+    size_t out_of_range = 0;
+
+    for (const auto& zone : ZONES) {
+        for (int round = 0; round < 3; ++round) {
+            Preferences preferences = randomPreferences(zone);
+            auto profile = BatchScorer::compile(preferences);
+
+            BatchScorer::Tile tile;
+            double scores[BatchScorer::TILE_SIZE];
+            bool in_range[BatchScorer::TILE_SIZE];
+            BatchScorer::Components components[BatchScorer::TILE_SIZE];
+            for (size_t first = 0; first < store.size(); first += BatchScorer::TILE_SIZE) {
+                BatchScorer::loadTile(store, static_cast<EventStore::EventId>(first), store.size() - first, tile);
+                BatchScorer::scoreTile(tile, profile, scores, in_range);
+                BatchScorer::loadComponents(tile, profile, components);
+
+                for (size_t i = 0; i < tile.count; ++i) {
+                    EventStore::EventId id = tile.ids[i];
+                    double expected = engine.calculateEventScore(store, id, preferences);
+                    ASSERT_TRUE(sameBits(scores[i], expected))
+                        << zone << " event " << id << ": " << scores[i] << " != " << expected;
+                    ASSERT_TRUE(sameBits(BatchScorer::blend(components[i]), expected)) << zone << " event " << id;
+
+                    bool expected_in_range = !preferences.hasCoordinates() || !store.getHasCoordinates()[id] ||
+                        preferences.isWithinTravelDistance(
+                            preferences.getTravelDistanceKm(store.getCoordinates()[id]));
+                    EXPECT_EQ(in_range[i], expected_in_range);
+                    EXPECT_EQ(components[i].in_range, expected_in_range);
+                    out_of_range += !in_range[i];
+
+                    // Materialized events go through the string-keyed path
+                    ASSERT_TRUE(sameBits(engine.calculateEventScore(store.materialize(id), preferences), expected));
+                }
+            }
+        }
+    }
+    EXPECT_GT(out_of_range, 0u);
+}
+
+TEST_F(BatchScorerTest, BlockScoresMatchPerEventScores) {
+    fillStore(1000);
+    Preferences preferences = randomPreferences("America/New_York");
+    auto profile = BatchScorer::compile(preferences);
+
+    // Starting mid-store and spanning several tiles
+    std::vector<double> scores(700);
+    BatchScorer::scoreBlock(store, 123, scores.size(), profile, scores.data());
+    for (size_t i = 0; i < scores.size(); ++i) {
+        auto id = static_cast<EventStore::EventId>(123 + i);
+        ASSERT_TRUE(sameBits(scores[i], engine.calculateEventScore(store, id, preferences))) << id;
+    }
+}
+
+TEST_F(BatchScorerTest, EventsWithoutTagsScoreZeroInterest) {
+    fillStore(50);
+    Preferences preferences = randomPreferences("UTC");
+    auto profile = BatchScorer::compile(preferences);
+    for (EventStore::EventId id = 0; id < store.size(); id += 5) {
+        ASSERT_EQ(store.tagsBegin(id), store.tagsEnd(id));
+        EXPECT_EQ(BatchScorer::scoreInterest(store, id, profile), 0.0);
+    }
+}
+
+TEST_F(BatchScorerTest, UpperBoundIsNeverExceeded) {
+    fillStore(2000);
+    Preferences preferences = randomPreferences("Europe/London");
+    auto profile = BatchScorer::compile(preferences);
+    std::vector<double> scores(store.size());
+    BatchScorer::scoreBlock(store, 0, store.size(), profile, scores.data());
+    for (EventStore::EventId id = 0; id < store.size(); ++id) {
+        EXPECT_LE(scores[id], BatchScorer::getUpperBound(profile, BatchScorer::scoreInterest(store, id, profile)));
+    }
+}
\ No newline at end of file
@@ -0,0 +1,249 @@
+#include "ConfigManager.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    class ConfigManagerTest : public ::testing::Test {
+    protected:
+        std::filesystem::path file;
+
+        void SetUp() override {
+            file = std::filesystem::temp_directory_path() /
+                   ("masterbot_config_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) + "_" +
+                    ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".json");
+            std::filesystem::remove(file);
+        }
+
+        void TearDown() override {
+            std::filesystem::remove(file);
+        }
+
+        // Writes a valid default config with the given name
+        void writeConfig(const std::string& name) const {
+            UserConfig config = *ConfigManager(file.string()).getSnapshot();
+            config.name = name;
+            config.openai_config.api_key = "test-key";
+            std::ofstream(file) << ConfigManager::toJson(config).dump(2);
+        }
+
+        // The default config as JSON
+        nlohmann::json defaultJson() const {
+            return ConfigManager::toJson(*ConfigManager(file.string()).getSnapshot());
+        }
+
+        // The message fromJson fails with, or "" if it parses
+        static std::string parseError(const nlohmann::json& j) {
+            try {
+                ConfigManager::fromJson(j);
+            } catch (const std::exception& e) {
+                return e.what();
+            }
+            return "";
+        }
+    };
+}
+
+TEST_F(ConfigManagerTest, ReloadUpdatesWorkingCopyAndSnapshot) {
+    writeConfig("first");
+    ConfigManager manager(file.string());
+    ASSERT_TRUE(manager.loadConfig());
+    auto held = manager.getSnapshot();
+    EXPECT_EQ(held->name, "first");
+
+    writeConfig("second");
+    ASSERT_TRUE(manager.reloadConfig());
+    EXPECT_EQ(manager.getSnapshot()->name, "second");
+    EXPECT_EQ(manager.getConfig().name, "second");
+    // A snapshot taken earlier never changes
+    EXPECT_EQ(held->name, "first");
+
+    // Saving after a reload writes the reloaded values, not stale ones
+    manager.setUserProfile("third", "third@example.com", "");
+    ASSERT_TRUE(manager.saveConfig());
+    ASSERT_TRUE(manager.reloadConfig());
+    EXPECT_EQ(manager.getSnapshot()->name, "third");
+    EXPECT_EQ(manager.getSnapshot()->location.timezone, "UTC");
+}
+
+TEST_F(ConfigManagerTest, InvalidReloadKeepsCurrentConfig) {
+    writeConfig("valid");
+    ConfigManager manager(file.string());
+    ASSERT_TRUE(manager.loadConfig());
+
+    std::ofstream(file) << "{\"name\": ";
+    EXPECT_FALSE(manager.reloadConfig());
+    EXPECT_EQ(manager.getSnapshot()->name, "valid");
+    EXPECT_EQ(manager.getConfig().name, "valid");
+
+    auto stats = manager.getReloadStats();
+    EXPECT_EQ(stats.reloads, 1u);
+    EXPECT_EQ(stats.failures, 1u);
+    EXPECT_FALSE(stats.last_errors.empty());
+}
+
+TEST_F(ConfigManagerTest, ReadersSeeWholeSnapshotsDuringReloads) {
+    writeConfig("name 0");
+    ConfigManager manager(file.string());
+    ASSERT_TRUE(manager.loadConfig());
+
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&manager, &stop]() {
+            while (!stop) {
+                auto snapshot = manager.getSnapshot();
+                ASSERT_EQ(snapshot->name.compare(0, 5, "name "), 0);
+                // The working copy is copied out under the reload's lock
+                ASSERT_EQ(manager.getConfig().name.compare(0, 5, "name "), 0);
+            }
+        });
+    }
+    for (int i = 1; i <= 50; ++i) {
+        writeConfig("name " + std::to_string(i));
+        EXPECT_TRUE(manager.reloadConfig());
+    }
+    stop = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(manager.getSnapshot()->name, "name 50");
+    EXPECT_EQ(manager.getReloadStats().reloads, 50u);
+}
+
+TEST_F(ConfigManagerTest, JsonErrorsNameTheOffendingKey) {
+    auto j = defaultJson();
+    ASSERT_EQ(parseError(j), "");
+
+    auto missing = j;
+    missing["user_profile"].erase("email");
+    EXPECT_EQ(parseError(missing), "Missing config key: user_profile.email");
+
+    missing = j;
+    missing.erase("privacy_settings");
+    EXPECT_EQ(parseError(missing), "Missing config key: privacy_settings");
+
+    auto mistyped = j;
+    mistyped["app_settings"]["cache_size_mb"] = "large";
+    EXPECT_EQ(parseError(mistyped).rfind("app_settings.cache_size_mb: ", 0), 0u) << parseError(mistyped);
+
+    mistyped = j;
+    mistyped["notification_settings"]["quiet_hours"] = true;
+    EXPECT_EQ(parseError(mistyped), "notification_settings.quiet_hours: expected an object, got boolean");
+
+    // Errors inside array elements carry the element index
+    auto slots = j;
+    slots["preferences"]["preferred_time_slots"] = nlohmann::json::array({
+        {{"start_hour", 9}, {"end_hour", 12}, {"days", {"monday"}}},
+        {{"start_hour", 18}, {"end_hour", "late"}, {"days", {"friday"}}}
+    });
+    EXPECT_EQ(parseError(slots).rfind("preferences.preferred_time_slots[1].end_hour: ", 0), 0u)
+        << parseError(slots);
+
+    slots["preferences"]["preferred_time_slots"][1] = {{"start_hour", 18}, {"days", {"friday"}}};
+    EXPECT_EQ(parseError(slots), "Missing config key: preferences.preferred_time_slots[1].end_hour");
+
+    slots["preferences"]["preferred_time_slots"][1] = {{"start_hour", 18}, {"end_hour", 20}, {"days", {"someday"}}};
+    EXPECT_EQ(parseError(slots), "preferences.preferred_time_slots[1].days: no recognized day names");
+
+    slots["preferences"]["preferred_time_slots"] = "evenings";
+    EXPECT_EQ(parseError(slots), "preferences.preferred_time_slots: expected an array, got string");
+
+    // A failed read leaves no stale path behind for the next one
+    missing = j;
+    missing["advanced_settings"].erase("learning_rate");
+    EXPECT_EQ(parseError(missing), "Missing config key: advanced_settings.learning_rate");
+}
+
+TEST_F(ConfigManagerTest, AbsentOptionalKeysTakeDefaults) {
+    auto j = defaultJson();
+    j["ai_services"].erase("connection_pool");
+    j["app_settings"].erase("cache_ttl_hours");
+    j["app_settings"].erase("cache_directory");
+    j["advanced_settings"].erase("prompt_token_budget");
+    j["advanced_settings"].erase("scoring_threads");
+    for (const char* provider : {"openai", "claude"}) {
+        j["ai_services"][provider].erase("temperature");
+        j["ai_services"][provider].erase("requests_per_minute");
+        j["ai_services"][provider].erase("tokens_per_minute");
+    }
+
+    UserConfig config = ConfigManager::fromJson(j);
+    EXPECT_EQ(config.connection_pool.max_connections, 8);
+    EXPECT_EQ(config.connection_pool.idle_timeout_seconds, 60);
+    EXPECT_EQ(config.cache_ttl_hours, 24);
+    EXPECT_EQ(config.cache_directory, "cache/ai_responses");
+    EXPECT_EQ(config.prompt_token_budget, 2000);
+    EXPECT_EQ(config.scoring_threads, 1);
+    for (const auto* service : {&config.openai_config, &config.claude_config}) {
+        EXPECT_EQ(service->temperature, 0.7);
+        EXPECT_EQ(service->requests_per_minute, 0);
+        EXPECT_EQ(service->tokens_per_minute, 0);
+    }
+
+    // An empty pool section defaults each member
+    j["ai_services"]["connection_pool"] = nlohmann::json::object();
+    config = ConfigManager::fromJson(j);
+    EXPECT_EQ(config.connection_pool.max_connections, 8);
+    EXPECT_EQ(config.connection_pool.idle_timeout_seconds, 60);
+
+    // Optional keys are still type-checked when present
+    j["ai_services"]["connection_pool"]["max_connections"] = "many";
+    EXPECT_EQ(parseError(j).rfind("ai_services.connection_pool.max_connections: ", 0), 0u) << parseError(j);
+}
+
+TEST_F(ConfigManagerTest, JsonRoundTripKeepsEveryField) {
+    UserConfig config = *ConfigManager(file.string()).getSnapshot();
+    config.name = "Round Trip";
+    config.location.latitude = -33.87;
+    config.location.timezone = "Australia/Sydney";
+    config.openai_config.temperature = 0.25;
+    config.claude_config.requests_per_minute = 42;
+    config.connection_pool = {3, 5};
+    config.interests = {{"music", 4}, {"hiking", 2}};
+    config.preferred_time_slots = {{7, 9, {"saturday", "sunday"}}, {19, 23, {"friday"}}};
+    config.budget_limits.currency = "AUD";
+    config.notifications.quiet_hours_enabled = !config.notifications.quiet_hours_enabled;
+    config.marketing_sharing = !config.marketing_sharing;
+    config.cache_ttl_hours = 6;
+    config.cache_directory = "/var/cache/masterbot";
+    config.prompt_token_budget = 123;
+    config.scoring_threads = 0;
+    config.min_recommendation_score = 0.45;
+
+    nlohmann::json j = ConfigManager::toJson(config);
+    UserConfig parsed = ConfigManager::fromJson(nlohmann::json::parse(j.dump()));
+    EXPECT_EQ(ConfigManager::toJson(parsed), j);
+    EXPECT_EQ(parsed.name, "Round Trip");
+    EXPECT_EQ(parsed.location.latitude, -33.87);
+    EXPECT_EQ(parsed.connection_pool.max_connections, 3);
+    EXPECT_EQ(parsed.connection_pool.idle_timeout_seconds, 5);
+    ASSERT_EQ(parsed.preferred_time_slots.size(), 2u);
+    EXPECT_EQ(parsed.preferred_time_slots[1].start_hour, 19);
+    EXPECT_EQ(parsed.preferred_time_slots[0].days, (std::vector<std::string>{"saturday", "sunday"}));
+    EXPECT_EQ(parsed.interests, config.interests);
+    EXPECT_EQ(parsed.scoring_threads, 0);
+    EXPECT_EQ(parsed.prompt_token_budget, 123);
+    EXPECT_EQ(parsed.cache_directory, "/var/cache/masterbot");
+}
+
+TEST_F(ConfigManagerTest, PathsResolveAgainstTheConfigDirectory) {
+    EXPECT_EQ(ConfigManager("/etc/masterbot/user_config.json").resolvePath("cache/ai_responses"),
+              "/etc/masterbot/cache/ai_responses");
+    EXPECT_EQ(ConfigManager("/etc/masterbot/user_config.json").resolvePath("../shared/cache"),
+              "/etc/shared/cache");
+    EXPECT_EQ(ConfigManager("config/user_config.json").resolvePath("cache"), "config/cache");
+    // A bare file name is in the working directory, and so are paths relative to it
+    EXPECT_EQ(ConfigManager("user_config.json").resolvePath("cache"), "cache");
+    EXPECT_EQ(ConfigManager("config/user_config.json").resolvePath("/tmp/cache"), "/tmp/cache");
+
+    UserConfig config = ConfigManager::fromJson(defaultJson());
+    config.cache_directory = "";
+    auto errors = ConfigManager::getValidationErrors(config);
+    EXPECT_NE(std::find(errors.begin(), errors.end(), "Cache directory cannot be empty"), errors.end());
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include "ConfigWatcher.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+    using std::chrono::milliseconds;
+
+    class ConfigWatcherTest : public ::testing::Test {
+    protected:
+        std::filesystem::path directory;
+        std::filesystem::path file;
+        std::mutex mutex;
+        std::condition_variable reloaded;
+        std::vector<Clock::time_point> reloads;
+
+        void SetUp() override {
+            // The watcher sees the whole directory, so each test gets its own
+            directory = std::filesystem::temp_directory_path() /
+                        ("masterbot_watch_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) + "_" +
+                         ::testing::UnitTest::GetInstance()->current_test_info()->name());
+            std::filesystem::remove_all(directory);
+            std::filesystem::create_directories(directory);
+            file = directory / "user_config.json";
+        }
+
+        void TearDown() override {
+            std::filesystem::remove_all(directory);
+        }
+
+        // Writes a valid default config with the given name
+        void writeConfig(const std::filesystem::path& path, const std::string& name) const {
+            UserConfig config = *ConfigManager(file.string()).getSnapshot();
+            config.name = name;
+            config.openai_config.api_key = "test-key";
+            std::ofstream(path) << ConfigManager::toJson(config).dump(2);
+        }
+
+        ConfigWatcher::ReloadCallback onReload() {
+            return [this](bool success) {
+                EXPECT_TRUE(success);
+                std::lock_guard<std::mutex> lock(mutex);
+                reloads.push_back(Clock::now());
+                reloaded.notify_all();
+            };
+        }
+
+        // Waits for the count-th reload, then long enough for any extra one to arrive
+        size_t reloadsAfter(size_t count) {
+            std::unique_lock<std::mutex> lock(mutex);
+            reloaded.wait_for(lock, std::chrono::seconds(5), [&] { return reloads.size() >= count; });
+            reloaded.wait_for(lock, milliseconds(300), [&] { return reloads.size() > count; });
+            return reloads.size();
+        }
+    };
+}
+
+TEST_F(ConfigWatcherTest, RewriteReloadsOnceAfterSettling) {
+    writeConfig(file, "first");
+    ConfigManager manager(file.string());
+    ASSERT_TRUE(manager.loadConfig());
+    ConfigWatcher watcher(manager, onReload());
+    ASSERT_TRUE(watcher.start());
+    EXPECT_TRUE(watcher.isRunning());
+
+    auto written = Clock::now();
+    writeConfig(file, "second");
+    ASSERT_EQ(reloadsAfter(1), 1u);
+    EXPECT_GE(reloads[0] - written, milliseconds(50));
+    EXPECT_EQ(manager.getSnapshot()->name, "second");
+    EXPECT_EQ(manager.getConfig().name, "second");
+
+    // A burst of writes settles into one reload of the last one
+    for (const char* name : {"third", "fourth", "fifth"}) {
+        writeConfig(file, name);
+    }
+    ASSERT_EQ(reloadsAfter(2), 2u);
+    EXPECT_EQ(manager.getSnapshot()->name, "fifth");
+    EXPECT_EQ(manager.getReloadStats().reloads, 2u);
+
+    watcher.stop();
+    EXPECT_FALSE(watcher.isRunning());
+    writeConfig(file, "sixth");
+    EXPECT_EQ(reloadsAfter(2), 2u);
+}
+
+TEST_F(ConfigWatcherTest, RenameOverTheFileReloadsOnce) {
+    writeConfig(file, "first");
+    ConfigManager manager(file.string());
+    ASSERT_TRUE(manager.loadConfig());
+    ConfigWatcher watcher(manager, onReload());
+    ASSERT_TRUE(watcher.start());
+
+    // Other files in the directory, the temporary one included, are ignored
+    auto temporary = directory / "user_config.json.tmp";
+    writeConfig(temporary, "second");
+    writeConfig(directory / "unrelated.json", "unrelated");
+    EXPECT_EQ(reloadsAfter(0), 0u);
+
+    auto renamed = Clock::now();
+    std::filesystem::rename(temporary, file);
+    ASSERT_EQ(reloadsAfter(1), 1u);
+    EXPECT_GE(reloads[0] - renamed, milliseconds(50));
+    EXPECT_EQ(manager.getSnapshot()->name, "second");
+}
\ No newline at end of file
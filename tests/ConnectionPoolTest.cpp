@@ -0,0 +1,125 @@
+#include "ConnectionPool.h"
+#include "HttpTransport.h"
+#include "LocalHttpServer.h"
+#include <gtest/gtest.h>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace {
+    std::shared_ptr<ConnectionPool> makePool(size_t max_size, std::chrono::seconds idle_timeout) {
+        ConnectionPool::Options options;
+        options.max_size = max_size;
+        options.idle_timeout = idle_timeout;
+        return std::make_shared<ConnectionPool>(options);
+    }
+
+    std::future<HttpTransport::Response> post(HttpTransport& transport, const std::string& url) {
+        auto promise = std::make_shared<std::promise<HttpTransport::Response>>();
+        auto future = promise->get_future();
+        transport.submit({url, {}, "{}", nullptr}, [promise](HttpTransport::Response response) {
+            promise->set_value(std::move(response));
+        });
+        return future;
+    }
+}
+
+TEST(ConnectionPoolTest, ReleasedHandlesAreReused) {
+    auto pool = makePool(4, std::chrono::seconds(60));
+    CURL* first = pool->acquireHandle();
+    ASSERT_NE(first, nullptr);
+    pool->release(first);
+    {
+        auto lease = pool->acquire();
+        EXPECT_EQ(lease.get(), first);
+        EXPECT_EQ(pool->getStats().in_use, 1u);
+    }
+
+    auto stats = pool->getStats();
+    EXPECT_EQ(stats.created, 1u);
+    EXPECT_EQ(stats.reused, 1u);
+    EXPECT_EQ(stats.in_use, 0u);
+    EXPECT_EQ(stats.idle, 1u);
+}
+
+TEST(ConnectionPoolTest, IdleHandlesExpire) {
+    auto pool = makePool(4, std::chrono::seconds(1));
+    pool->release(pool->acquireHandle());
+    pool->release(pool->acquireHandle());
+    EXPECT_EQ(pool->getStats().reused, 1u);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    pool->release(pool->acquireHandle());
+    auto stats = pool->getStats();
+    EXPECT_EQ(stats.evicted, 1u);
+    EXPECT_EQ(stats.created, 2u);
+    EXPECT_EQ(stats.reused, 1u);
+    EXPECT_EQ(stats.idle, 1u);
+}
+
+TEST(ConnectionPoolTest, KeepsAtMostMaxSizeIdleHandles) {
+    auto pool = makePool(2, std::chrono::seconds(60));
+    std::vector<CURL*> handles;
+    for (int i = 0; i < 5; ++i) {
+        handles.push_back(pool->acquireHandle());
+    }
+    EXPECT_EQ(pool->getStats().in_use, 5u);
+    for (CURL* handle : handles) {
+        pool->release(handle);
+    }
+
+    auto stats = pool->getStats();
+    EXPECT_EQ(stats.max_size, 2u);
+    EXPECT_EQ(stats.idle, 2u);
+    EXPECT_EQ(stats.in_use, 0u);
+    EXPECT_EQ(stats.evicted, 3u);
+}
+
+TEST(ConnectionPoolTest, TransportReusesHandlesAndConnections) {
+    LocalHttpServer server;
+    auto pool = makePool(4, std::chrono::seconds(60));
+    HttpTransport transport(pool);
+    EXPECT_EQ(transport.getConnectionPool(), pool);
+
+    for (int i = 0; i < 5; ++i) {
+        auto response = post(transport, server.url()).get();
+        ASSERT_TRUE(response.success) << response.error_message;
+        EXPECT_EQ(response.status_code, 200);
+    }
+    EXPECT_EQ(server.getConnectionCount(), 1u);
+    auto stats = pool->getStats();
+    EXPECT_EQ(stats.created, 1u);
+    EXPECT_EQ(stats.reused, 4u);
+}
+
+TEST(ConnectionPoolTest, TransportOpensAtMostMaxSizeConnectionsPerHost) {
+    LocalHttpServer server;
+    auto pool = makePool(2, std::chrono::seconds(60));
+    HttpTransport transport(pool);
+
+    std::vector<std::future<HttpTransport::Response>> responses;
+    for (int i = 0; i < 12; ++i) {
+        responses.push_back(post(transport, server.url()));
+    }
+    for (auto& response : responses) {
+        EXPECT_TRUE(response.get().success);
+    }
+    EXPECT_EQ(server.getRequests().size(), 12u);
+    EXPECT_LE(server.getConnectionCount(), 2u);
+    EXPECT_LE(pool->getStats().idle, 2u);
+}
+
+TEST(ConnectionPoolTest, TransportDropsConnectionsIdleTooLong) {
+    LocalHttpServer server;
+    auto pool = makePool(4, std::chrono::seconds(1));
+    HttpTransport transport(pool);
+
+    ASSERT_TRUE(post(transport, server.url()).get().success);
+    ASSERT_TRUE(post(transport, server.url()).get().success);
+    EXPECT_EQ(server.getConnectionCount(), 1u);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(2100));
+    ASSERT_TRUE(post(transport, server.url()).get().success);
+    EXPECT_EQ(server.getConnectionCount(), 2u);
+    EXPECT_EQ(pool->getStats().evicted, 1u);
+}
\ No newline at end of file
@@ -0,0 +1,247 @@
+#include "EventCatalog.h"
+#include "EventStore.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace {
+    using TimePoint = std::chrono::system_clock::time_point;
+
+    TimePoint at(std::int64_t seconds) {
+        return TimePoint() + std::chrono::seconds(seconds);
+    }
+
+    class EventCatalogTest : public ::testing::Test {
+    protected:
+        std::filesystem::path directory;
+
+        void SetUp() override {
+            directory = std::filesystem::temp_directory_path() /
+                        ("masterbot_catalog_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) +
+                         "_" + ::testing::UnitTest::GetInstance()->current_test_info()->name());
+            std::filesystem::remove_all(directory);
+            std::filesystem::create_directories(directory);
+        }
+
+        void TearDown() override {
+            std::filesystem::remove_all(directory);
+        }
+
+        std::string path(const std::string& name) const {
+            return (directory / name).string();
+        }
+
+        std::vector<Event> sampleEvents() const {
+            std::vector<Event> events;
+            events.emplace_back("Jazz Night", "Live quartet", at(1780000000), at(1780007200), "Blue Note",
+                                std::vector<std::string>{"music", "jazz"});
+            events.back().setCoordinates({40.7308, -74.0006});
+            events.emplace_back("Open Studio", "", at(1780100000), at(1780103600), "",
+                                std::vector<std::string>{});
+            events.emplace_back("Caf\xc3\xa9 Jazz", "Second set", at(-3600), at(0), "Blue Note",
+                                std::vector<std::string>{"jazz", "food"});
+            events.back().setCoordinates({-33.86, 151.21});
+            for (size_t i = 0; i < events.size(); ++i) {
+                events[i].setId(100 + i);
+            }
+            return events;
+        }
+
+        std::string writeSample() const {
+            EventCatalog::Writer writer;
+            for (const auto& event : sampleEvents()) {
+                writer.add(event);
+            }
+            std::string error;
+            EXPECT_TRUE(writer.write(path("events.cat"), error)) << error;
+            return path("events.cat");
+        }
+
+        std::string readBytes(const std::string& file) const {
+            std::ifstream input(file, std::ios::binary);
+            return std::string(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+        }
+
+        void writeBytes(const std::string& file, const std::string& bytes) const {
+            std::ofstream(file, std::ios::binary | std::ios::trunc) << bytes;
+        }
+
+        template<typename T>
+        static T readAt(const std::string& bytes, size_t offset) {
+            T value;
+            std::memcpy(&value, bytes.data() + offset, sizeof(T));
+            return value;
+        }
+
+        template<typename T>
+        static void writeAt(std::string& bytes, size_t offset, T value) {
+            std::memcpy(&bytes[offset], &value, sizeof(T));
+        }
+
+        // Opens a patched copy of the sample and returns the error (empty if it opened)
+        template<typename Patch>
+        std::string openPatched(const Patch& patch) {
+            std::string bytes = readBytes(writeSample());
+            patch(bytes);
+            writeBytes(path("corrupt.cat"), bytes);
+            std::string error;
+            auto catalog = EventCatalog::open(path("corrupt.cat"), error);
+            return catalog ? std::string() : error;
+        }
+    };
+
+    void expectSameEvent(const Event& actual, const Event& expected) {
+        EXPECT_EQ(actual.getId(), expected.getId());
+        EXPECT_EQ(actual.getName(), expected.getName());
+        EXPECT_EQ(actual.getDescription(), expected.getDescription());
+        EXPECT_EQ(actual.getStartTime(), expected.getStartTime());
+        EXPECT_EQ(actual.getEndTime(), expected.getEndTime());
+        EXPECT_EQ(actual.getLocation(), expected.getLocation());
+        EXPECT_EQ(actual.getTags(), expected.getTags());
+        ASSERT_EQ(actual.hasCoordinates(), expected.hasCoordinates());
+        if (expected.hasCoordinates()) {
+            EXPECT_EQ(actual.getCoordinates().latitude, expected.getCoordinates().latitude);
+            EXPECT_EQ(actual.getCoordinates().longitude, expected.getCoordinates().longitude);
+        }
+    }
+}
+
+TEST_F(EventCatalogTest, WrittenEventsReadBackUnchanged) {
+    std::string error;
+    auto catalog = EventCatalog::open(writeSample(), error);
+    ASSERT_NE(catalog, nullptr) << error;
+
+    auto expected = sampleEvents();
+    ASSERT_EQ(catalog->size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        expectSameEvent(catalog->toEvent(i), expected[i]);
+    }
+    // Tags are stored once each
+    EXPECT_EQ(catalog->getTagCount(), 3u);
+    EXPECT_EQ(catalog->getTagReferenceCount(), 4u);
+    EXPECT_FALSE(std::filesystem::exists(path("events.cat.tmp")));
+
+    EventStore store;
+    store.addEvents(catalog);
+    ASSERT_EQ(store.size(), expected.size());
+    for (EventStore::EventId id = 0; id < store.size(); ++id) {
+        expectSameEvent(store.materialize(id), expected[id]);
+    }
+
+    // The store's name views keep the mapping alive after the caller lets go; rows
+    // added directly mix with them
+    catalog.reset();
+    store.addEvent(expected[0]);
+    for (EventStore::EventId id = 0; id < store.size(); ++id) {
+        EXPECT_EQ(store.getName(id), expected[id % expected.size()].getName());
+        expectSameEvent(store.materialize(id), expected[id % expected.size()]);
+    }
+}
+
+TEST_F(EventCatalogTest, EmptyCatalogOpens) {
+    std::string error;
+    ASSERT_TRUE(EventCatalog::Writer().write(path("empty.cat"), error)) << error;
+    auto catalog = EventCatalog::open(path("empty.cat"), error);
+    ASSERT_NE(catalog, nullptr) << error;
+    EXPECT_TRUE(catalog->empty());
+}
+
+TEST_F(EventCatalogTest, ConvertsJsonFeed) {
+    std::ofstream(path("feed.json")) << R"({"events": [
+        {"name": "Jazz Night", "start": "2026-05-28T20:00:00Z", "end": 1780009200,
+         "location": "Blue Note", "tags": ["music", "jazz"], "latitude": 40.73, "longitude": -74.0,
+         "extra": {"ignored": [1, 2]}},
+        {"id": 7, "name": "Open Studio", "start": 1780100000, "end": "2026-05-30T01:13:20+01:00"}
+    ]})";
+
+    std::string error;
+    ASSERT_TRUE(EventCatalog::convertJson(path("feed.json"), path("feed.cat"), error)) << error;
+    auto catalog = EventCatalog::open(path("feed.cat"), error);
+    ASSERT_NE(catalog, nullptr) << error;
+    ASSERT_EQ(catalog->size(), 2u);
+
+    Event first = catalog->toEvent(0);
+    EXPECT_EQ(first.getId(), 1u);
+    EXPECT_EQ(first.getName(), "Jazz Night");
+    EXPECT_EQ(first.getStartTime(), at(1779998400));
+    EXPECT_EQ(first.getEndTime(), at(1780009200));
+    EXPECT_EQ(first.getTags(), (std::vector<std::string>{"music", "jazz"}));
+    EXPECT_TRUE(first.hasCoordinates());
+
+    Event second = catalog->toEvent(1);
+    EXPECT_EQ(second.getId(), 7u);
+    EXPECT_EQ(second.getEndTime(), at(1780100000));
+    EXPECT_FALSE(second.hasCoordinates());
+    EXPECT_TRUE(second.getTags().empty());
+}
+
+TEST_F(EventCatalogTest, ConversionReportsBadFeeds) {
+    std::string error;
+    EXPECT_FALSE(EventCatalog::convertJson(path("missing.json"), path("out.cat"), error));
+    EXPECT_FALSE(error.empty());
+
+    std::ofstream(path("broken.json")) << R"({"events": [{"name": "a", "start": 0, "end": 1},)";
+    error.clear();
+    EXPECT_FALSE(EventCatalog::convertJson(path("broken.json"), path("out.cat"), error));
+    EXPECT_FALSE(error.empty());
+    EXPECT_FALSE(std::filesystem::exists(path("out.cat")));
+}
+
+TEST_F(EventCatalogTest, RejectsCorruptFiles) {
+    std::string error;
+    EXPECT_EQ(EventCatalog::open(path("missing.cat"), error), nullptr);
+    EXPECT_NE(error.find("Failed to open"), std::string::npos) << error;
+
+    auto expect_rejected = [this](const std::string& error, const std::string& reason) {
+        EXPECT_NE(error.find(path("corrupt.cat")), std::string::npos) << error;
+        EXPECT_NE(error.find(reason), std::string::npos) << error;
+    };
+
+    expect_rejected(openPatched([](std::string& bytes) { bytes.resize(40); }), "too small");
+    expect_rejected(openPatched([](std::string& bytes) { bytes[0] = 'X'; }), "not an event catalog");
+    expect_rejected(openPatched([](std::string& bytes) { writeAt<std::uint32_t>(bytes, 8, 99); }),
+                    "unsupported catalog version 99");
+    expect_rejected(openPatched([](std::string& bytes) { writeAt<std::uint32_t>(bytes, 12, 8); }),
+                    "unexpected record size");
+
+    // Counts and offsets that point past the end, including ones that would overflow
+    expect_rejected(openPatched([](std::string& bytes) { writeAt<std::uint64_t>(bytes, 16, 1u << 20); }),
+                    "section extends past the end");
+    expect_rejected(openPatched([](std::string& bytes) { writeAt<std::uint64_t>(bytes, 16, ~0ull); }),
+                    "section extends past the end");
+    expect_rejected(openPatched([](std::string& bytes) { writeAt<std::uint64_t>(bytes, 64, ~0ull - 4); }),
+                    "section extends past the end");
+    expect_rejected(openPatched([](std::string& bytes) {
+        bytes.resize(readAt<std::uint64_t>(bytes, 64));
+    }), "section extends past the end");
+
+    // Records whose fields index outside their sections
+    expect_rejected(openPatched([](std::string& bytes) {
+        size_t tags = readAt<std::uint64_t>(bytes, 48);
+        writeAt<std::uint32_t>(bytes, tags + 8 + 4, 1u << 30);
+    }), "tag 1 is out of bounds");
+    expect_rejected(openPatched([](std::string& bytes) {
+        size_t refs = readAt<std::uint64_t>(bytes, 56);
+        writeAt<std::uint32_t>(bytes, refs + 4 * 3, 3);
+    }), "tag reference 3 is out of bounds");
+    expect_rejected(openPatched([](std::string& bytes) {
+        size_t record = readAt<std::uint64_t>(bytes, 40) + 2 * 72;
+        writeAt<std::uint32_t>(bytes, record + 40, readAt<std::uint32_t>(bytes, 72));
+    }), "event 2 is out of bounds");
+    expect_rejected(openPatched([](std::string& bytes) {
+        size_t record = readAt<std::uint64_t>(bytes, 40) + 72;
+        writeAt<std::uint16_t>(bytes, record + 68, 5);
+    }), "event 1 is out of bounds");
+    expect_rejected(openPatched([](std::string& bytes) {
+        size_t record = readAt<std::uint64_t>(bytes, 40);
+        writeAt<std::int64_t>(bytes, record + 8, std::numeric_limits<std::int64_t>::max());
+    }), "event 0 is out of bounds");
+
+    // The unpatched sample still opens
+    EXPECT_EQ(openPatched([](std::string&) {}), "");
+}
\ No newline at end of file
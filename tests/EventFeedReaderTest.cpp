@@ -0,0 +1,171 @@
+#include "EventFeedReader.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+    std::vector<Event> readAll(const std::string& json, bool& ok, std::string& error) {
+        std::vector<Event> events;
+        std::istringstream input(json);
+        ok = EventFeedReader::read(input, [&events](const Event& event) {
+            events.push_back(event);
+            return true;
+        }, error);
+        return events;
+    }
+
+    // Reading is expected to fail with a message containing reason
+    void expectError(const std::string& json, const std::string& reason) {
+        bool ok = true;
+        std::string error;
+        readAll(json, ok, error);
+        EXPECT_FALSE(ok) << json;
+        EXPECT_NE(error.find(reason), std::string::npos) << json << " -> " << error;
+    }
+
+    std::string feed(size_t count, size_t broken_at = static_cast<size_t>(-1)) {
+        std::string json = "{\"events\": [";
+        for (size_t i = 0; i < count; ++i) {
+            json += i ? "," : "";
+            json += i == broken_at ? "{\"name\": \"broken\", \"start\": 0}"
+                                   : "{\"name\": \"event " + std::to_string(i) + "\", \"start\": " +
+                                         std::to_string(1700000000 + i * 3600) + ", \"end\": " +
+                                         std::to_string(1700003600 + i * 3600) + "}";
+        }
+        return json + "]}";
+    }
+
+    class EventFeedReaderTest : public ::testing::Test {
+    protected:
+        std::filesystem::path file;
+
+        void SetUp() override {
+            file = std::filesystem::temp_directory_path() /
+                   ("masterbot_feed_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) + "_" +
+                    ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".json");
+        }
+
+        void TearDown() override {
+            std::filesystem::remove(file);
+        }
+
+        void writeFeed(const std::string& json) const {
+            std::ofstream(file) << json;
+        }
+    };
+}
+
+TEST_F(EventFeedReaderTest, ReadsArraysAndEventsObjects) {
+    bool ok = false;
+    std::string error;
+    auto events = readAll(R"([
+        {"name": "a", "start": "2026-05-01T19:00:00+02:00", "end": 1777658400, "tags": ["x", "y"],
+         "latitude": 1.5, "longitude": 2.5, "unknown": {"nested": [1, {"deep": true}]}},
+        {"id": 42, "name": "b", "start": 0, "end": 60, "description": "d", "location": "l", "latitude": 3}
+    ])", ok, error);
+    ASSERT_TRUE(ok) << error;
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0].getId(), 1u);
+    EXPECT_EQ(events[0].getStartTime(), std::chrono::system_clock::time_point() + std::chrono::seconds(1777654800));
+    EXPECT_EQ(events[0].getTags(), (std::vector<std::string>{"x", "y"}));
+    EXPECT_TRUE(events[0].hasCoordinates());
+    EXPECT_EQ(events[1].getId(), 42u);
+    EXPECT_EQ(events[1].getLocation(), "l");
+    // A latitude alone is not a position
+    EXPECT_FALSE(events[1].hasCoordinates());
+
+    events = readAll(R"({"source": ["ignored"], "events": [{"name": "c", "start": 0, "end": 1}]})", ok, error);
+    ASSERT_TRUE(ok) << error;
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].getName(), "c");
+
+    events = readAll(R"({"events": []})", ok, error);
+    EXPECT_TRUE(ok) << error;
+    EXPECT_TRUE(events.empty());
+}
+
+TEST_F(EventFeedReaderTest, ReportsMalformedFeeds) {
+    expectError(R"([{"name": "a", "start": 0}])", "event 0 needs a name and valid start and end times");
+    expectError(R"([{"name": "a", "start": 0, "end": 1}, {"start": 0, "end": 1}])", "event 1 needs a name");
+    expectError(R"([{"name": "a", "start": "next tuesday", "end": 1}])", "event 0 needs a name");
+    expectError(R"([{"name": "a", "start": 18446744073709551615, "end": 1}])", "event 0 needs a name");
+    expectError(R"([{"name": "a", "start": 0, "end": 1, "tags": ["x", 2]}])", "event 0 has a tag that is not a string");
+    expectError(R"([{"name": "a", "start": 0, "end": 1}, 7])", "event 1 is not an object");
+    expectError(R"({"items": []})", "expected an array of events");
+    expectError(R"("events")", "expected an array of events");
+    expectError(R"([{"name": "a", "start": 0, "end": 1},)", "parse error");
+}
+
+TEST_F(EventFeedReaderTest, SinkCanStopEarly) {
+    // Everything after the stop, including the syntax error, goes unread
+    std::istringstream input(feed(5) + "garbage");
+    std::vector<std::string> names;
+    std::string error;
+    EXPECT_TRUE(EventFeedReader::read(input, [&names](const Event& event) {
+        names.push_back(event.getName());
+        return names.size() < 2;
+    }, error));
+    EXPECT_EQ(names, (std::vector<std::string>{"event 0", "event 1"}));
+    EXPECT_TRUE(error.empty()) << error;
+}
+
+TEST_F(EventFeedReaderTest, ReadFileNamesThePath) {
+    std::string error;
+    EXPECT_FALSE(EventFeedReader::readFile(file.string(), [](const Event&) { return true; }, error));
+    EXPECT_EQ(error, "Failed to open " + file.string());
+
+    writeFeed(feed(3, 1));
+    error.clear();
+    EXPECT_FALSE(EventFeedReader::readFile(file.string(), [](const Event&) { return true; }, error));
+    EXPECT_EQ(error.find(file.string() + ": event 1 needs a name"), 0u) << error;
+}
+
+TEST_F(EventFeedReaderTest, BackgroundReaderDeliversEveryEventInOrder) {
+    writeFeed(feed(1000));
+    // A small queue keeps the parser blocking on the consumer
+    EventFeedReader reader(file.string(), 64);
+    size_t count = 0;
+    while (const Event* event = reader.next()) {
+        EXPECT_EQ(event->getName(), "event " + std::to_string(count));
+        count++;
+    }
+    EXPECT_EQ(count, 1000u);
+    EXPECT_FALSE(reader.failed());
+    EXPECT_TRUE(reader.getError().empty());
+    EXPECT_EQ(reader.next(), nullptr);
+}
+
+TEST_F(EventFeedReaderTest, BackgroundReaderReportsErrors) {
+    EventFeedReader missing(file.string());
+    EXPECT_EQ(missing.next(), nullptr);
+    EXPECT_TRUE(missing.failed());
+    EXPECT_EQ(missing.getError(), "Failed to open " + file.string());
+
+    writeFeed(feed(300, 150));
+    EventFeedReader reader(file.string(), 64);
+    size_t count = 0;
+    while (reader.next()) {
+        count++;
+    }
+    // Whole batches parsed before the bad event may already have been handed out
+    EXPECT_LE(count, 150u);
+    EXPECT_TRUE(reader.failed());
+    EXPECT_NE(reader.getError().find("event 150 needs a name"), std::string::npos) << reader.getError();
+}
+
+TEST_F(EventFeedReaderTest, DestroyingReaderStopsParser) {
+    writeFeed(feed(20000));
+    {
+        // The parser fills the one-batch queue and blocks; destruction must release it
+        EventFeedReader reader(file.string(), 1);
+        ASSERT_NE(reader.next(), nullptr);
+        EXPECT_EQ(reader.next()->getName(), "event 1");
+    }
+    {
+        // Never consumed at all
+        EventFeedReader reader(file.string(), 1);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,151 @@
+#include "EventStore.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+    using TimePoint = std::chrono::system_clock::time_point;
+
+    void expectSameEvent(const Event& actual, const Event& expected) {
+        EXPECT_EQ(actual.getId(), expected.getId());
+        EXPECT_EQ(actual.getName(), expected.getName());
+        EXPECT_EQ(actual.getDescription(), expected.getDescription());
+        EXPECT_EQ(actual.getStartTime(), expected.getStartTime());
+        EXPECT_EQ(actual.getEndTime(), expected.getEndTime());
+        EXPECT_EQ(actual.getLocation(), expected.getLocation());
+        EXPECT_EQ(actual.getTags(), expected.getTags());
+        ASSERT_EQ(actual.hasCoordinates(), expected.hasCoordinates());
+        if (expected.hasCoordinates()) {
+            EXPECT_EQ(actual.getCoordinates().latitude, expected.getCoordinates().latitude);
+            EXPECT_EQ(actual.getCoordinates().longitude, expected.getCoordinates().longitude);
+        }
+    }
+
+    class EventStoreTest : public ::testing::Test {
+    protected:
+        TagInterner tags;
+        EventStore store{tags};
+        std::vector<Event> events;
+        std::mt19937 rng{5};
+
+        void addRandomEvents(size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                auto start = TimePoint() + std::chrono::minutes(rng() % 100000);
+                std::vector<std::string> event_tags;
+                for (int n = static_cast<int>(rng() % 4); n > 0; --n) {
+                    event_tags.push_back("tag" + std::to_string(rng() % 12));
+                }
+                Event event("event " + std::to_string(events.size()), "", start, start + std::chrono::hours(1),
+                            rng() % 2 ? "venue " + std::to_string(rng() % 5) : "", event_tags);
+                if (rng() % 3 != 0) {
+                    event.setCoordinates({-60.0 + (rng() % 12000) / 100.0, -180.0 + (rng() % 36000) / 100.0});
+                }
+                events.push_back(event);
+                ASSERT_EQ(store.addEvent(event), events.size() - 1);
+            }
+        }
+
+        // Every index agrees with a scan of the rows still active
+        void expectIndexesConsistent() {
+            size_t active = 0;
+            std::vector<std::set<EventStore::EventId>> expected_postings(tags.size());
+            std::vector<EventStore::EventId> located, unlocated;
+            for (EventStore::EventId id = 0; id < store.size(); ++id) {
+                if (!store.isActive(id)) {
+                    continue;
+                }
+                active++;
+                for (const auto& tag : events[id].getTags()) {
+                    expected_postings[tags.find(tag)].insert(id);
+                }
+                (events[id].hasCoordinates() ? located : unlocated).push_back(id);
+            }
+            EXPECT_EQ(store.getActiveCount(), active);
+
+            for (TagInterner::TagId tag = 0; tag < tags.size(); ++tag) {
+                std::vector<EventStore::EventId> expected(expected_postings[tag].begin(), expected_postings[tag].end());
+                EXPECT_EQ(store.getPostings(tag), expected) << tags.getName(tag);
+            }
+            EXPECT_EQ(store.getEventsWithoutCoordinates(), unlocated);
+
+            // Half the earth's circumference reaches every point
+            std::vector<GeoIndex::Id> everywhere;
+            store.getGeoIndex().queryRadius({0.0, 0.0}, 20100.0, everywhere);
+            EXPECT_EQ(everywhere, located);
+            EXPECT_EQ(store.getGeoIndex().size(), located.size());
+        }
+    };
+}
+
+TEST_F(EventStoreTest, AddedEventsMaterializeUnchanged) {
+    auto start = TimePoint() + std::chrono::hours(24 * 365 * 56);
+    events.emplace_back("Concert", "Live music", start, start + std::chrono::hours(3), "Hall",
+                        std::vector<std::string>{"music", "live"});
+    events.back().setCoordinates({40.7, -74.0});
+    events.emplace_back("Meetup", "", start, start + std::chrono::hours(1), "", std::vector<std::string>{});
+    events.emplace_back("Repeat", "Same tag twice", start, start, "Hall",
+                        std::vector<std::string>{"music", "music"});
+    events.back().setCoordinates({-33.9, 151.2});
+    events.back().setId(424242);
+
+    for (const auto& event : events) {
+        store.addEvent(event);
+    }
+    ASSERT_EQ(store.size(), events.size());
+    EXPECT_EQ(store.getActiveCount(), events.size());
+    for (EventStore::EventId id = 0; id < store.size(); ++id) {
+        expectSameEvent(store.materialize(id), events[id]);
+        EXPECT_EQ(store.getSourceId(id), events[id].getId());
+        EXPECT_EQ(store.getName(id), events[id].getName());
+        EXPECT_EQ(store.getLocation(id), events[id].getLocation());
+    }
+
+    // One location id per distinct location; none for an empty one
+    EXPECT_EQ(store.getLocationIds()[0], store.getLocationIds()[2]);
+    EXPECT_EQ(store.getLocationIds()[1], static_cast<EventStore::LocationId>(EventStore::NO_LOCATION));
+    // A tag repeated on one event is posted once
+    EXPECT_EQ(store.getPostings(tags.find("music")), (std::vector<EventStore::EventId>{0, 2}));
+    expectIndexesConsistent();
+
+    // A removed row keeps its id and still materializes
+    EXPECT_TRUE(store.removeEvent(1));
+    EXPECT_FALSE(store.isActive(1));
+    expectSameEvent(store.materialize(1), events[1]);
+    EXPECT_EQ(store.addEvent(events[1]), 3u);
+    expectSameEvent(store.materialize(3), events[1]);
+}
+
+TEST_F(EventStoreTest, IndexesStayConsistentThroughRemovals) {
+    addRandomEvents(600);
+    expectIndexesConsistent();
+
+    std::vector<EventStore::EventId> ids(store.size());
+    for (EventStore::EventId id = 0; id < ids.size(); ++id) {
+        ids[id] = id;
+    }
+    std::shuffle(ids.begin(), ids.end(), rng);
+    for (size_t i = 0; i < 250; ++i) {
+        ASSERT_TRUE(store.removeEvent(ids[i]));
+    }
+    expectIndexesConsistent();
+
+    // Removing twice, or an id never handed out, changes nothing
+    EXPECT_FALSE(store.removeEvent(ids[0]));
+    EXPECT_FALSE(store.removeEvent(static_cast<EventStore::EventId>(store.size())));
+    EXPECT_EQ(store.getActiveCount(), 350u);
+
+    // Rows appended after removals are indexed alongside the survivors
+    addRandomEvents(200);
+    for (size_t i = 250; i < 400; ++i) {
+        ASSERT_TRUE(store.removeEvent(ids[i]));
+    }
+    expectIndexesConsistent();
+    EXPECT_EQ(store.getActiveCount(), 400u);
+
+    for (EventStore::EventId id = 0; id < store.size(); ++id) {
+        expectSameEvent(store.materialize(id), events[id]);
+    }
+}
\ No newline at end of file
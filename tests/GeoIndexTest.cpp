@@ -0,0 +1,148 @@
+#include "GeoIndex.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+    class GeoIndexTest : public ::testing::Test {
+    protected:
+        std::mt19937 rng{11};
+        std::vector<GeoPoint> points;
+
+        double uniform(double low, double high) {
+            return std::uniform_real_distribution<double>(low, high)(rng);
+        }
+
+        // Spread over the globe, with extra points crowded near the poles and the antimeridian
+        void fillPoints(size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                switch (i % 4) {
+                case 0:
+                    points.push_back({uniform(-90.0, 90.0), uniform(-180.0, 180.0)});
+                    break;
+                case 1:
+                    points.push_back({uniform(-90.0, 90.0), i % 8 == 1 ? uniform(178.0, 180.0) : uniform(-180.0, -178.0)});
+                    break;
+                case 2:
+                    points.push_back({i % 8 == 2 ? uniform(88.0, 90.0) : uniform(-90.0, -88.0), uniform(-180.0, 180.0)});
+                    break;
+                default:
+                    points.push_back({uniform(-1.0, 1.0), uniform(-1.0, 1.0)});
+                    break;
+                }
+            }
+            points.push_back({90.0, 0.0});
+            points.push_back({-90.0, 45.0});
+            points.push_back({0.0, 180.0});
+            points.push_back({0.0, -180.0});
+        }
+
+        static std::vector<GeoIndex::Id> bruteForce(const std::vector<GeoPoint>& points, const GeoPoint& center,
+                                                    double radius_km) {
+            std::vector<GeoIndex::Id> result;
+            for (GeoIndex::Id id = 0; id < points.size(); ++id) {
+                if (GeoPoint::distanceKm(center, points[id]) <= radius_km) {
+                    result.push_back(id);
+                }
+            }
+            return result;
+        }
+    };
+}
+
+TEST_F(GeoIndexTest, QueryRadiusMatchesBruteForce) {
+    fillPoints(8000);
+    std::vector<GeoPoint> centers = {
+        {0.0, 0.0}, {0.0, 179.95}, {0.0, -179.95}, {0.0, 180.0}, {0.0, -180.0},
+        {45.0, 179.5}, {-60.0, -179.9}, {89.95, 10.0}, {-89.95, -170.0}, {90.0, 0.0}, {-90.0, 0.0},
+        {88.0, 179.0}, {37.77, -122.42}
+    };
+    for (int i = 0; i < 20; ++i) {
+        centers.push_back({uniform(-90.0, 90.0), uniform(-180.0, 180.0)});
+    }
+
+    // 7 degrees does not divide 360, so the last longitude column is narrower
+    for (double cell_degrees : {0.1, 1.0, 7.0}) {
+        GeoIndex index(cell_degrees);
+        for (GeoIndex::Id id = 0; id < points.size(); ++id) {
+            index.insert(id, points[id]);
+        }
+        ASSERT_EQ(index.size(), points.size());
+
+        for (const auto& center : centers) {
+            for (double radius_km : {0.0, 1.0, 25.0, 150.0, 900.0, 5000.0, 20100.0}) {
+                std::vector<GeoIndex::Id> found;
+                index.queryRadius(center, radius_km, found);
+                EXPECT_EQ(found, bruteForce(points, center, radius_km))
+                    << cell_degrees << " (" << center.latitude << ", " << center.longitude << ") " << radius_km;
+            }
+        }
+    }
+}
+
+TEST_F(GeoIndexTest, RadiusBoundaryIsInclusive) {
+    // Points just inside, exactly on and just outside the radius, in several directions
+    // including across the antimeridian and over the pole
+    std::vector<GeoPoint> centers = {{0.0, 179.99}, {89.99, -45.0}, {-35.0, 150.0}};
+    for (const auto& center : centers) {
+        // Unrelated points elsewhere keep enough cells occupied that the query walks its box
+        points.clear();
+        fillPoints(4000);
+        size_t first_ray = points.size();
+        for (int bearing = 0; bearing < 8; ++bearing) {
+            for (int step = 0; step < 400; ++step) {
+                points.push_back({center.latitude + (bearing % 2 ? 1 : -1) * step * 0.0005,
+                                  center.longitude + (bearing / 2 - 1.5) * step * 0.0007});
+            }
+        }
+        for (size_t i = first_ray; i < points.size(); ++i) {
+            auto& point = points[i];
+            if (point.latitude > 90.0) {
+                point = {180.0 - point.latitude, point.longitude + 180.0};
+            }
+            if (point.longitude > 180.0) {
+                point.longitude -= 360.0;
+            }
+        }
+
+        GeoIndex index(0.1);
+        for (GeoIndex::Id id = 0; id < points.size(); ++id) {
+            index.insert(id, points[id]);
+        }
+
+        // Radii equal to the exact distance of some point must include it
+        for (GeoIndex::Id probe = static_cast<GeoIndex::Id>(first_ray) + 1; probe < points.size(); probe += 97) {
+            double radius_km = GeoPoint::distanceKm(center, points[probe]);
+            std::vector<GeoIndex::Id> found;
+            index.queryRadius(center, radius_km, found);
+            auto expected = bruteForce(points, center, radius_km);
+            EXPECT_EQ(found, expected) << radius_km;
+            EXPECT_TRUE(std::binary_search(found.begin(), found.end(), probe)) << radius_km;
+        }
+    }
+}
+
+TEST_F(GeoIndexTest, RemovedPointsAreNotReturned) {
+    fillPoints(2000);
+    GeoIndex index(0.5);
+    for (GeoIndex::Id id = 0; id < points.size(); ++id) {
+        index.insert(id, points[id]);
+    }
+    for (GeoIndex::Id id = 0; id < points.size(); id += 3) {
+        ASSERT_TRUE(index.remove(id, points[id]));
+    }
+    EXPECT_FALSE(index.remove(0, points[0]));
+    EXPECT_FALSE(index.remove(1, {points[1].latitude + 10.0, points[1].longitude}));
+
+    GeoPoint center{0.0, 179.9};
+    std::vector<GeoIndex::Id> expected;
+    for (auto id : bruteForce(points, center, 2500.0)) {
+        if (id % 3 != 0) {
+            expected.push_back(id);
+        }
+    }
+    std::vector<GeoIndex::Id> found;
+    index.queryRadius(center, 2500.0, found);
+    EXPECT_EQ(found, expected);
+}
\ No newline at end of file
@@ -0,0 +1,176 @@
+#include "HttpTransport.h"
+#include "LocalHttpServer.h"
+#include <gtest/gtest.h>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+    using std::chrono::milliseconds;
+    using Reply = LocalHttpServer::Reply;
+
+    // Completes a future; fails the test if the transport completes a request twice
+    std::pair<HttpTransport::CompletionCallback, std::future<HttpTransport::Response>> completion() {
+        auto promise = std::make_shared<std::promise<HttpTransport::Response>>();
+        auto completed = std::make_shared<std::atomic<int>>(0);
+        auto future = promise->get_future();
+        return {[promise, completed](HttpTransport::Response response) {
+                    EXPECT_EQ(++*completed, 1) << "completed twice";
+                    if (*completed == 1) {
+                        promise->set_value(std::move(response));
+                    }
+                },
+                std::move(future)};
+    }
+
+    HttpTransport::Response send(HttpTransport& transport, HttpTransport::Request request) {
+        auto done = completion();
+        transport.submit(std::move(request), done.first);
+        EXPECT_EQ(done.second.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+        return done.second.get();
+    }
+
+    Reply held() {
+        Reply reply;
+        reply.hold = true;
+        return reply;
+    }
+}
+
+TEST(HttpTransportTest, DeliversStatusBodyAndRetryAfter) {
+    LocalHttpServer server;
+    Reply busy;
+    busy.status = 503;
+    busy.body = "try later";
+    busy.headers = {"Retry-After: 7"};
+    server.script({busy});
+    HttpTransport transport;
+
+    auto response = send(transport, {server.url("/busy"), {"X-Test: yes"}, "request body", nullptr});
+    EXPECT_TRUE(response.success);
+    EXPECT_EQ(response.result, CURLE_OK);
+    EXPECT_EQ(response.status_code, 503);
+    EXPECT_EQ(response.body, "try later");
+    EXPECT_EQ(response.retry_after, std::chrono::seconds(7));
+
+    auto requests = server.getRequests();
+    ASSERT_EQ(requests.size(), 1u);
+    EXPECT_EQ(requests[0].head.rfind("POST /busy ", 0), 0u);
+    EXPECT_NE(requests[0].head.find("X-Test: yes\r\n"), std::string::npos);
+    EXPECT_EQ(requests[0].body, "request body");
+
+    response = send(transport, {server.url(), {}, "", nullptr});
+    EXPECT_EQ(response.status_code, 200);
+    EXPECT_EQ(response.retry_after, std::chrono::seconds(0));
+    EXPECT_EQ(transport.getInFlightCount(), 0u);
+}
+
+TEST(HttpTransportTest, OnDataSeesSuccessfulBodiesOnly) {
+    LocalHttpServer server;
+    Reply streamed, failed;
+    streamed.body = std::string(100000, 's');
+    failed.status = 500;
+    failed.body = "server error";
+    server.script({streamed, failed});
+    HttpTransport transport;
+
+    std::string seen;
+    auto on_data = [&seen](const char* data, size_t size) {
+        seen.append(data, size);
+        return true;
+    };
+    auto response = send(transport, {server.url(), {}, "", on_data});
+    EXPECT_TRUE(response.success);
+    EXPECT_EQ(seen, streamed.body);
+    EXPECT_TRUE(response.body.empty());
+
+    // An error body is buffered for the caller instead of being streamed
+    seen.clear();
+    response = send(transport, {server.url(), {}, "", on_data});
+    EXPECT_TRUE(response.success);
+    EXPECT_EQ(response.status_code, 500);
+    EXPECT_TRUE(seen.empty());
+    EXPECT_EQ(response.body, "server error");
+
+    // Returning false aborts the transfer
+    response = send(transport, {server.url(), {}, "", [](const char*, size_t) { return false; }});
+    EXPECT_FALSE(response.success);
+    EXPECT_EQ(response.result, CURLE_WRITE_ERROR);
+}
+
+TEST(HttpTransportTest, CancelAbortsRequestsCarryingTheFlag) {
+    LocalHttpServer server;
+    server.setDefaultReply(held());
+    HttpTransport transport;
+
+    auto cancel = std::make_shared<std::atomic<bool>>(false);
+    auto other = std::make_shared<std::atomic<bool>>(false);
+    auto first = completion();
+    auto second = completion();
+    auto untouched = completion();
+    HttpTransport::Request request{server.url(), {}, "", nullptr};
+    request.cancel = cancel;
+    transport.submit(request, first.first);
+    transport.submit(request, second.first);
+    request.cancel = other;
+    transport.submit(request, untouched.first);
+    ASSERT_TRUE(server.waitForRequests(3));
+
+    transport.cancel(cancel);
+    for (auto* done : {&first.second, &second.second}) {
+        ASSERT_EQ(done->wait_for(std::chrono::seconds(5)), std::future_status::ready);
+        auto response = done->get();
+        EXPECT_FALSE(response.success);
+        EXPECT_EQ(response.result, CURLE_ABORTED_BY_CALLBACK);
+    }
+    EXPECT_EQ(untouched.second.wait_for(milliseconds(100)), std::future_status::timeout);
+    EXPECT_EQ(transport.getInFlightCount(), 1u);
+
+    // A request whose flag is already set never reaches the server
+    request.cancel = cancel;
+    auto response = send(transport, request);
+    EXPECT_EQ(response.result, CURLE_ABORTED_BY_CALLBACK);
+    EXPECT_EQ(server.getRequests().size(), 3u);
+
+    transport.cancel(other);
+    EXPECT_EQ(untouched.second.get().result, CURLE_ABORTED_BY_CALLBACK);
+}
+
+TEST(HttpTransportTest, TimeoutEndsTheTransfer) {
+    LocalHttpServer server;
+    server.setDefaultReply(held());
+    HttpTransport transport;
+
+    HttpTransport::Request request{server.url(), {}, "", nullptr};
+    request.timeout = milliseconds(200);
+    auto started = std::chrono::steady_clock::now();
+    auto response = send(transport, request);
+    auto elapsed = std::chrono::steady_clock::now() - started;
+    EXPECT_FALSE(response.success);
+    EXPECT_EQ(response.result, CURLE_OPERATION_TIMEDOUT);
+    EXPECT_FALSE(response.error_message.empty());
+    EXPECT_GE(elapsed, milliseconds(200));
+    EXPECT_LT(elapsed, milliseconds(2000));
+}
+
+TEST(HttpTransportTest, ShutdownCompletesRequestsStillInFlight) {
+    LocalHttpServer server;
+    server.setDefaultReply(held());
+    std::vector<std::future<HttpTransport::Response>> responses;
+    {
+        HttpTransport transport;
+        for (int i = 0; i < 4; ++i) {
+            auto done = completion();
+            transport.submit({server.url(), {}, "", nullptr}, done.first);
+            responses.push_back(std::move(done.second));
+        }
+        ASSERT_TRUE(server.waitForRequests(4));
+        EXPECT_EQ(transport.getInFlightCount(), 4u);
+    }
+    for (auto& response : responses) {
+        ASSERT_EQ(response.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+        EXPECT_EQ(response.get().result, CURLE_ABORTED_BY_CALLBACK);
+    }
+}
\ No newline at end of file
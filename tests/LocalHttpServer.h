@@ -0,0 +1,215 @@
+#pragma once
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Minimal HTTP/1.1 server on 127.0.0.1 for transport tests. Each request gets the
+// next scripted reply, or the default reply once the script has run out.
+// Connections are kept alive between requests unless a reply says otherwise.
+class LocalHttpServer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Reply {
+        int status = 200;
+        std::string body = "{}";
+        std::vector<std::string> headers;
+        // Closes the connection after this many body bytes; negative sends the whole body
+        long truncate_at = -1;
+        // Closes the connection without answering
+        bool drop = false;
+        // Keeps the connection open without answering until the server stops
+        bool hold = false;
+    };
+
+    struct Received {
+        std::string head;
+        std::string body;
+        Clock::time_point at;
+    };
+
+    LocalHttpServer() : stopping_(false), connections_(0) {
+        listener_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        if (listener_ < 0 || ::bind(listener_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            ::listen(listener_, 64) != 0 ||
+            ::getsockname(listener_, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+            throw std::runtime_error("LocalHttpServer: cannot listen on 127.0.0.1");
+        }
+        port_ = ntohs(address.sin_port);
+        accept_thread_ = std::thread(&LocalHttpServer::acceptLoop, this);
+    }
+
+    ~LocalHttpServer() {
+        stop();
+    }
+
+    LocalHttpServer(const LocalHttpServer&) = delete;
+    LocalHttpServer& operator=(const LocalHttpServer&) = delete;
+
+    // Closes every connection, held ones included, and joins the server's threads
+    void stop() {
+        if (stopping_.exchange(true)) {
+            return;
+        }
+        accept_thread_.join();
+        for (auto& thread : connection_threads_) {
+            thread.join();
+        }
+        ::close(listener_);
+    }
+
+    void script(const std::vector<Reply>& replies) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        script_.insert(script_.end(), replies.begin(), replies.end());
+    }
+
+    void setDefaultReply(const Reply& reply) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        default_reply_ = reply;
+    }
+
+    std::string url(const std::string& path = "/") const {
+        return "http://127.0.0.1:" + std::to_string(port_) + path;
+    }
+
+    std::vector<Received> getRequests() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return requests_;
+    }
+
+    size_t getConnectionCount() const { return connections_.load(); }
+
+    bool waitForRequests(size_t count, std::chrono::milliseconds timeout = std::chrono::seconds(10)) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return received_.wait_for(lock, timeout, [&] { return requests_.size() >= count; });
+    }
+
+private:
+    int listener_;
+    int port_;
+    std::atomic<bool> stopping_;
+    std::atomic<size_t> connections_;
+    std::thread accept_thread_;
+    // Only touched by the accept thread until stop() joins it
+    std::vector<std::thread> connection_threads_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable received_;
+    std::deque<Reply> script_;
+    Reply default_reply_;
+    std::vector<Received> requests_;
+
+    // Waits for the socket to become readable, giving up when the server stops
+    bool waitReadable(int fd) const {
+        pollfd entry{fd, POLLIN, 0};
+        while (!stopping_) {
+            int ready = ::poll(&entry, 1, 20);
+            if (ready > 0) {
+                return true;
+            }
+            if (ready < 0) {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    void acceptLoop() {
+        while (waitReadable(listener_)) {
+            int fd = ::accept(listener_, nullptr, nullptr);
+            if (fd < 0) {
+                continue;
+            }
+            connections_++;
+            connection_threads_.emplace_back(&LocalHttpServer::serve, this, fd);
+        }
+    }
+
+    void serve(int fd) {
+        std::string buffer;
+        char chunk[4096];
+        while (true) {
+            // Read one request: the head, then Content-Length bytes of body
+            size_t head_end;
+            while ((head_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+                ssize_t got = waitReadable(fd) ? ::recv(fd, chunk, sizeof(chunk), 0) : 0;
+                if (got <= 0) {
+                    ::close(fd);
+                    return;
+                }
+                buffer.append(chunk, static_cast<size_t>(got));
+            }
+            Received request{buffer.substr(0, head_end + 4), "", Clock::now()};
+            size_t body_length = 0;
+            auto length_at = request.head.find("Content-Length: ");
+            if (length_at != std::string::npos) {
+                body_length = std::strtoul(request.head.c_str() + length_at + 16, nullptr, 10);
+            }
+            buffer.erase(0, head_end + 4);
+            while (buffer.size() < body_length) {
+                ssize_t got = waitReadable(fd) ? ::recv(fd, chunk, sizeof(chunk), 0) : 0;
+                if (got <= 0) {
+                    ::close(fd);
+                    return;
+                }
+                buffer.append(chunk, static_cast<size_t>(got));
+            }
+            request.body = buffer.substr(0, body_length);
+            buffer.erase(0, body_length);
+
+            Reply reply;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                requests_.push_back(request);
+                if (script_.empty()) {
+                    reply = default_reply_;
+                } else {
+                    reply = script_.front();
+                    script_.pop_front();
+                }
+                received_.notify_all();
+            }
+
+            if (reply.hold) {
+                while (waitReadable(fd) && ::recv(fd, chunk, sizeof(chunk), 0) > 0) {
+                }
+                ::close(fd);
+                return;
+            }
+            if (reply.drop) {
+                ::close(fd);
+                return;
+            }
+
+            std::string response = "HTTP/1.1 " + std::to_string(reply.status) + " Scripted\r\n" +
+                                   "Content-Length: " + std::to_string(reply.body.size()) + "\r\n";
+            for (const auto& header : reply.headers) {
+                response += header + "\r\n";
+            }
+            response += "\r\n";
+            bool truncated = reply.truncate_at >= 0 && static_cast<size_t>(reply.truncate_at) < reply.body.size();
+            response += truncated ? reply.body.substr(0, static_cast<size_t>(reply.truncate_at)) : reply.body;
+            ::send(fd, response.data(), response.size(), MSG_NOSIGNAL);
+            if (truncated) {
+                ::close(fd);
+                return;
+            }
+        }
+    }
+};
\ No newline at end of file
@@ -0,0 +1,17 @@
+#pragma once
+#include "AIService.h"
+#include <future>
+#include <string>
+
+// The engine needs a provider; its empty replies leave the basic reasoning in place
+class NullAIService : public AIService {
+public:
+    NullAIService() : AIService("") {}
+    std::future<AIResponse> generateResponse(const std::string&) override { return {}; }
+    void generateResponse(const std::string&, ResponseCallback, CancelFlag) override {}
+    std::future<AIResponse> analyzePreferences(const std::string&) override { return {}; }
+    std::future<AIResponse> recommendEvents(const std::string&, const std::string&) override { return {}; }
+    void streamResponse(const std::string&, DeltaCallback, ResponseCallback) override {}
+    std::string getProviderName() const override { return "null"; }
+    std::string getModelName() const override { return "null"; }
+};
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "Preferences.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+
+namespace {
+    // The dense arrays say exactly what the interest map says, for every global tag id
+    void expectCompiledMatchesInterests(const Preferences& preferences) {
+        const auto& mask = preferences.getInterestMask();
+        const auto& weights = preferences.getInterestWeights();
+        ASSERT_EQ(mask.size(), weights.size());
+
+        const auto& interner = TagInterner::global();
+        for (TagInterner::TagId tag = 0; tag < interner.size(); ++tag) {
+            auto it = preferences.getInterests().find(interner.getName(tag));
+            bool expected = it != preferences.getInterests().end();
+            if (tag >= mask.size()) {
+                EXPECT_FALSE(expected) << interner.getName(tag) << " has no compiled entry";
+                continue;
+            }
+            EXPECT_EQ(mask[tag] != 0, expected) << interner.getName(tag);
+            EXPECT_EQ(weights[tag], expected ? it->second : 0) << interner.getName(tag);
+
+            int weight = -1;
+            EXPECT_EQ(preferences.findInterest(tag, weight), expected) << interner.getName(tag);
+            if (expected) {
+                EXPECT_EQ(weight, it->second);
+            }
+        }
+        for (const auto& interest : preferences.getInterests()) {
+            EXPECT_NE(interner.find(interest.first), TagInterner::INVALID_TAG) << interest.first;
+        }
+    }
+
+    std::string tag(unsigned i) {
+        return "preferences-test-tag-" + std::to_string(i);
+    }
+}
+
+TEST(PreferencesTest, CompiledInterestsFollowEveryChange) {
+    Preferences preferences;
+    expectCompiledMatchesInterests(preferences);
+
+    preferences.addInterest(tag(0), 3);
+    preferences.addInterest(tag(1));
+    expectCompiledMatchesInterests(preferences);
+
+    // Re-adding replaces the weight; weights of 0 and below are still interests
+    preferences.addInterest(tag(0), 0);
+    preferences.setInterestWeight(tag(1), -2);
+    expectCompiledMatchesInterests(preferences);
+    EXPECT_EQ(preferences.getInterestMask()[TagInterner::global().find(tag(0))], 1);
+
+    // Setting the weight of something that is not an interest does not make it one
+    preferences.setInterestWeight(tag(2), 5);
+    EXPECT_EQ(preferences.getInterests().count(tag(2)), 0u);
+    expectCompiledMatchesInterests(preferences);
+
+    // Removing clears both arrays, and removing twice is harmless
+    preferences.removeInterest(tag(0));
+    preferences.removeInterest(tag(0));
+    preferences.removeInterest(tag(3));
+    expectCompiledMatchesInterests(preferences);
+}
+
+TEST(PreferencesTest, CompiledInterestsSurviveRandomEditsAndGrowth) {
+    std::mt19937 rng(17);
+    Preferences preferences;
+    for (int step = 0; step < 2000; ++step) {
+        unsigned i = 10 + rng() % 60;
+        int weight = static_cast<int>(rng() % 11) - 2;
+        switch (rng() % 4) {
+        case 0:
+            preferences.addInterest(tag(i), weight);
+            break;
+        case 1:
+            preferences.removeInterest(tag(i));
+            break;
+        case 2:
+            preferences.setInterestWeight(tag(i), weight);
+            break;
+        default:
+            // Tags interned elsewhere grow the global id space past the arrays
+            TagInterner::global().intern(tag(1000 + step));
+            break;
+        }
+        if (step % 50 == 0) {
+            expectCompiledMatchesInterests(preferences);
+        }
+    }
+    expectCompiledMatchesInterests(preferences);
+
+    // A copy carries its own arrays
+    Preferences copy = preferences;
+    copy.addInterest(tag(5000), 9);
+    expectCompiledMatchesInterests(copy);
+    expectCompiledMatchesInterests(preferences);
+}
\ No newline at end of file
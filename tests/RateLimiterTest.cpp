@@ -0,0 +1,139 @@
+#include "RateLimiter.h"
+#include <gtest/gtest.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+    using Clock = RateLimiter::Clock;
+    using std::chrono::milliseconds;
+
+    // Collects release order and times from the limiter's thread
+    class Releases {
+    public:
+        RateLimiter::ReadyCallback record(int id) {
+            return [this, id]() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                order_.push_back(id);
+                times_.push_back(Clock::now());
+                done_.notify_all();
+            };
+        }
+
+        void waitFor(size_t count) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            ASSERT_TRUE(done_.wait_for(lock, std::chrono::seconds(10), [&] { return order_.size() >= count; }));
+        }
+
+        std::vector<int> order() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return order_;
+        }
+
+        std::vector<Clock::time_point> times() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return times_;
+        }
+
+    private:
+        std::mutex mutex_;
+        std::condition_variable done_;
+        std::vector<int> order_;
+        std::vector<Clock::time_point> times_;
+    };
+
+    RateLimiter::Options tokensPerMinute(double tokens) {
+        RateLimiter::Options options;
+        options.tokens_per_minute = tokens;
+        return options;
+    }
+}
+
+TEST(RateLimiterTest, UnlimitedRunsInline) {
+    RateLimiter limiter;
+    std::thread::id ran_on;
+    limiter.acquire(1000000, [&ran_on]() { ran_on = std::this_thread::get_id(); });
+    EXPECT_EQ(ran_on, std::this_thread::get_id());
+    auto stats = limiter.getStats();
+    EXPECT_EQ(stats.granted, 1u);
+    EXPECT_EQ(stats.delayed, 0u);
+}
+
+TEST(RateLimiterTest, QueuedWaitersReleaseInArrivalOrder) {
+    // 100 tokens a second; the bucket starts with a full minute's allowance
+    RateLimiter limiter(tokensPerMinute(6000));
+    limiter.acquire(6000);
+
+    Releases releases;
+    auto queued = Clock::now();
+    // A small request behind a large one still waits its turn
+    limiter.acquire(20, releases.record(0));
+    limiter.acquire(1, releases.record(1));
+    limiter.acquire(10, releases.record(2));
+    limiter.acquire(1, releases.record(3));
+    EXPECT_EQ(limiter.getStats().waiting, 4u);
+    releases.waitFor(4);
+
+    EXPECT_EQ(releases.order(), (std::vector<int>{0, 1, 2, 3}));
+    auto times = releases.times();
+    // 32 tokens at 100 a second
+    EXPECT_GE(times.back() - queued, milliseconds(300));
+    EXPECT_GE(times[0] - queued, milliseconds(190));
+
+    auto stats = limiter.getStats();
+    EXPECT_EQ(stats.granted, 5u);
+    EXPECT_EQ(stats.delayed, 4u);
+    EXPECT_EQ(stats.waiting, 0u);
+}
+
+TEST(RateLimiterTest, NotBeforeOrdersByReleaseTime) {
+    RateLimiter limiter;
+    Releases releases;
+    auto now = Clock::now();
+    limiter.acquire(1, releases.record(0), now + milliseconds(200));
+    limiter.acquire(1, releases.record(1), now + milliseconds(50));
+    // Nothing jumps the queue while others wait, but it is due first
+    limiter.acquire(1, releases.record(2));
+    releases.waitFor(3);
+
+    EXPECT_EQ(releases.order(), (std::vector<int>{2, 1, 0}));
+    auto times = releases.times();
+    EXPECT_GE(times[1], now + milliseconds(50));
+    EXPECT_GE(times[2], now + milliseconds(200));
+}
+
+TEST(RateLimiterTest, PauseHoldsEveryWaiter) {
+    RateLimiter limiter;
+    auto until = Clock::now() + milliseconds(150);
+    limiter.pauseUntil(until);
+    // An earlier pause does not shorten the current one
+    limiter.pauseUntil(until - milliseconds(100));
+
+    Releases releases;
+    limiter.acquire(1, releases.record(0));
+    limiter.acquire(1, releases.record(1));
+    limiter.acquire(1);
+    EXPECT_GE(Clock::now(), until);
+    releases.waitFor(2);
+    EXPECT_EQ(releases.order(), (std::vector<int>{0, 1}));
+    for (auto time : releases.times()) {
+        EXPECT_GE(time, until);
+    }
+
+    auto stats = limiter.getStats();
+    EXPECT_EQ(stats.pauses, 1u);
+    EXPECT_EQ(stats.delayed, 3u);
+    EXPECT_GE(stats.total_delay, milliseconds(3 * 140));
+}
+
+TEST(RateLimiterTest, DestructionReleasesWaiters) {
+    Releases releases;
+    {
+        RateLimiter limiter;
+        limiter.pauseUntil(Clock::now() + std::chrono::hours(1));
+        limiter.acquire(1, releases.record(0));
+        limiter.acquire(1, releases.record(1));
+    }
+    EXPECT_EQ(releases.order(), (std::vector<int>{0, 1}));
+}
\ No newline at end of file
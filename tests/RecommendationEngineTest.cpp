@@ -0,0 +1,384 @@
+#include "RecommendationEngine.h"
+#include "NullAIService.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <future>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+    using Ranking = std::vector<std::pair<std::string, double>>;
+
+    Ranking ranking(const std::vector<RecommendationEngine::EventRecommendation>& recommendations) {
+        Ranking result;
+        for (const auto& recommendation : recommendations) {
+            result.emplace_back(recommendation.event.getName(), recommendation.score);
+        }
+        return result;
+    }
+
+    size_t indexOf(const std::string& name) {
+        return std::stoul(name.substr(name.find(' ') + 1));
+    }
+
+    // Keeps the prompt sections the engine sends, and fails the request
+    class PromptRecordingService : public NullAIService {
+    public:
+        std::string preferences_text;
+        std::string events_text;
+
+        std::future<AIResponse> recommendEvents(const std::string& preferences,
+                                                const std::string& available_events) override {
+            preferences_text = preferences;
+            events_text = available_events;
+            std::promise<AIResponse> reply;
+            reply.set_value({false, "", "recorded"});
+            return reply.get_future();
+        }
+    };
+
+    // Splits text into lines, each keeping its newline
+    std::vector<std::string> lines(const std::string& text) {
+        std::vector<std::string> result;
+        for (size_t begin = 0; begin < text.size();) {
+            size_t end = text.find('\n', begin);
+            end = end == std::string::npos ? text.size() : end + 1;
+            result.push_back(text.substr(begin, end - begin));
+            begin = end;
+        }
+        return result;
+    }
+
+    class RecommendationEngineTest : public ::testing::Test {
+    protected:
+        std::mt19937 rng{23};
+        std::vector<Event> events;
+        EventStore store;
+        Schedule schedule;
+        User user{"Test User", "test@example.com"};
+        RecommendationEngine engine{std::make_shared<NullAIService>()};
+
+        std::string tag(int i) const {
+            return "engine-test-tag-" + std::to_string(i);
+        }
+
+        // Events are drawn from a few templates, so many share a score exactly
+        void fillCatalog(size_t count, size_t templates) {
+            std::vector<Event> shapes;
+            auto base = std::chrono::system_clock::time_point() + std::chrono::hours(24 * 365 * 56);
+            for (size_t t = 0; t < templates; ++t) {
+                auto start = base + std::chrono::hours(rng() % (24 * 60));
+                std::vector<std::string> tags;
+                for (int n = static_cast<int>(rng() % 4); n > 0; --n) {
+                    tags.push_back(tag(static_cast<int>(rng() % 16)));
+                }
+                shapes.emplace_back("", "", start, start + std::chrono::hours(2), rng() % 3 ? "venue" : "", tags);
+                if (rng() % 3 != 0) {
+                    shapes.back().setCoordinates({37.0 + (rng() % 2000) / 1000.0, -123.0 + (rng() % 2000) / 1000.0});
+                }
+            }
+            for (size_t i = 0; i < count; ++i) {
+                Event event = shapes[rng() % shapes.size()];
+                event.setName("event " + std::to_string(events.size()));
+                event.setId(events.size() + 1);
+                events.push_back(event);
+                store.addEvent(event);
+            }
+        }
+
+        void setPreferences() {
+            auto& preferences = user.getPreferences();
+            for (int i = 0; i < 16; i += 3) {
+                preferences.addInterest(tag(i), 1 + static_cast<int>(rng() % 5));
+            }
+            preferences.addPreferredTimeSlot(18, 23, 0x7f);
+            preferences.setLocation("home");
+            preferences.setCoordinates({37.77, -122.42});
+            preferences.setMaxTravelDistance(80.0);
+        }
+
+        // Scores every active store row directly, without postings or the spatial index
+        Ranking exhaustive(int k) {
+            const auto& preferences = user.getPreferences();
+            std::vector<std::pair<double, EventStore::EventId>> scored;
+            for (EventStore::EventId id = 0; id < store.size(); ++id) {
+                if (!store.isActive(id) ||
+                    schedule.hasConflict(store.getStartTimes()[id], store.getEndTimes()[id])) {
+                    continue;
+                }
+                if (preferences.hasCoordinates() && store.getHasCoordinates()[id] &&
+                    !preferences.isWithinTravelDistance(preferences.getTravelDistanceKm(store.getCoordinates()[id]))) {
+                    continue;
+                }
+                scored.emplace_back(engine.calculateEventScore(store, id, preferences), id);
+            }
+            std::sort(scored.begin(), scored.end(),
+                      [](const std::pair<double, EventStore::EventId>& a, const std::pair<double, EventStore::EventId>& b) {
+                          return a.first != b.first ? a.first > b.first : a.second < b.second;
+                      });
+            Ranking result;
+            for (size_t i = 0; i < scored.size() && i < static_cast<size_t>(k); ++i) {
+                result.emplace_back(store.getName(scored[i].second), scored[i].first);
+            }
+            return result;
+        }
+
+        // The pruned store path against exhaustive(), for k cut at several places
+        // including inside a run of tied scores
+        void expectMatchesExhaustive() {
+            Ranking all = exhaustive(static_cast<int>(store.size()));
+            ASSERT_GT(all.size(), 50u);
+            std::vector<int> ks = {1, 3, 10, 50, static_cast<int>(all.size()), static_cast<int>(all.size()) + 5};
+            for (size_t i = 1; i < all.size() && ks.size() < 9; ++i) {
+                if (all[i - 1].second == all[i].second && (i == 1 || all[i - 2].second == all[i].second)) {
+                    ks.push_back(static_cast<int>(i));
+                    i += 25;
+                }
+            }
+            ASSERT_EQ(ks.size(), 9u) << "no ties to cut through";
+            for (int k : ks) {
+                Ranking expected = exhaustive(k);
+                Ranking actual = ranking(engine.recommendEvents(user, store, schedule, k));
+                ASSERT_EQ(actual.size(), expected.size()) << k;
+                for (size_t i = 0; i < expected.size(); ++i) {
+                    EXPECT_EQ(actual[i].first, expected[i].first) << "k=" << k << " rank " << i;
+                    EXPECT_DOUBLE_EQ(actual[i].second, expected[i].second) << "k=" << k << " rank " << i;
+                }
+            }
+        }
+
+        // Scores descend, and equal scores come in catalog order
+        static void expectOrdered(const Ranking& result) {
+            for (size_t i = 1; i < result.size(); ++i) {
+                ASSERT_GE(result[i - 1].second, result[i].second);
+                if (result[i - 1].second == result[i].second) {
+                    ASSERT_LT(indexOf(result[i - 1].first), indexOf(result[i].first));
+                }
+            }
+        }
+    };
+}
+
+TEST_F(RecommendationEngineTest, RankingDoesNotDependOnThreadCount) {
+    // Several chunks of PARALLEL_GRAIN, and far more tied events than k
+    fillCatalog(30000, 40);
+    setPreferences();
+    const int k = 200;
+
+    engine.setThreadCount(1);
+    Ranking from_vector = ranking(engine.recommendEvents(user, events, schedule, k));
+    Ranking from_store = ranking(engine.recommendEvents(user, store, schedule, k));
+    ASSERT_EQ(from_vector.size(), static_cast<size_t>(k));
+    expectOrdered(from_vector);
+    EXPECT_EQ(from_store, from_vector);
+
+    size_t ties = 0;
+    for (size_t i = 1; i < from_vector.size(); ++i) {
+        ties += from_vector[i - 1].second == from_vector[i].second;
+    }
+    EXPECT_GT(ties, static_cast<size_t>(k) / 2);
+
+    for (size_t threads : {2u, 3u, 8u}) {
+        engine.setThreadCount(threads);
+        ASSERT_EQ(engine.getThreadCount(), threads);
+        EXPECT_EQ(ranking(engine.recommendEvents(user, events, schedule, k)), from_vector) << threads;
+        EXPECT_EQ(ranking(engine.recommendEvents(user, store, schedule, k)), from_vector) << threads;
+    }
+}
+
+TEST_F(RecommendationEngineTest, PrunedStoreRankingMatchesExhaustiveScoring) {
+    // Tags 0-15 are drawn; interests cover only some of them, so many events overlap
+    // with none, and tag 1 is weighted 0
+    fillCatalog(3000, 30);
+    auto& preferences = user.getPreferences();
+    preferences.addInterest(tag(0), 5);
+    preferences.addInterest(tag(1), 0);
+    preferences.addInterest(tag(4), 2);
+    preferences.addInterest(tag(9), 2);
+    preferences.addInterest(tag(13), 1);
+    preferences.addInterest(tag(99), 4);
+    preferences.addPreferredTimeSlot(18, 23, 0x7f);
+    preferences.setLocation("home");
+    preferences.setCoordinates({37.77, -122.42});
+    preferences.setMaxTravelDistance(60.0);
+    auto busy = events[7].getStartTime();
+    schedule.addEvent(Event("busy", "", busy, busy + std::chrono::hours(1), "", {}));
+    expectMatchesExhaustive();
+
+    // Rows removed and appended after the postings were first built, including
+    // current winners
+    for (const auto& entry : exhaustive(40)) {
+        if (indexOf(entry.first) % 2 == 0) {
+            ASSERT_TRUE(store.removeEvent(static_cast<EventStore::EventId>(indexOf(entry.first))));
+        }
+    }
+    for (EventStore::EventId id = 0; id < store.size(); id += 7) {
+        store.removeEvent(id);
+    }
+    fillCatalog(1500, 30);
+    expectMatchesExhaustive();
+
+    // Without user coordinates every active row is eligible
+    preferences = Preferences();
+    preferences.addInterest(tag(2), 3);
+    preferences.addInterest(tag(3), 0);
+    preferences.addInterest(tag(5), 3);
+    expectMatchesExhaustive();
+
+    // Every interest weighted 0 leaves no posting worth visiting first
+    for (const auto& interest : std::vector<std::string>{tag(2), tag(3), tag(5)}) {
+        preferences.setInterestWeight(interest, 0);
+    }
+    expectMatchesExhaustive();
+}
+
+TEST_F(RecommendationEngineTest, StreamedCatalogRanksLikeTheVector) {
+    fillCatalog(5000, 40);
+    setPreferences();
+    auto busy = events[11].getStartTime();
+    schedule.addEvent(Event("busy", "", busy, busy + std::chrono::hours(1), "", {}));
+    engine.setThreadCount(1);
+
+    for (int k : {1, 10, 200, 6000}) {
+        Ranking expected = ranking(engine.recommendEvents(user, events, schedule, k));
+        ASSERT_FALSE(expected.empty());
+        EXPECT_EQ(ranking(engine.recommendEvents(user, events.begin(), events.end(), schedule, k)), expected) << k;
+
+        // Each event is handed out from the same buffer, so winners must be copied out of it
+        size_t next = 0;
+        Event buffer = events[0];
+        RecommendationEngine::EventSource source = [&]() -> const Event* {
+            if (next == events.size()) {
+                return nullptr;
+            }
+            buffer = events[next++];
+            return &buffer;
+        };
+        auto streamed = engine.recommendEvents(user, source, schedule, k);
+        EXPECT_EQ(ranking(streamed), expected) << k;
+        for (const auto& recommendation : streamed) {
+            EXPECT_EQ(recommendation.event.getId(), indexOf(recommendation.event.getName()) + 1);
+        }
+    }
+}
+
+TEST_F(RecommendationEngineTest, BatchRankingMatchesPerUserRanking) {
+    fillCatalog(6000, 40);
+    for (EventStore::EventId id = 3; id < store.size(); id += 11) {
+        store.removeEvent(id);
+    }
+
+    // Not a multiple of USER_GROUP_SIZE, so the last group is partial
+    const size_t user_count = 37;
+    std::vector<User> users;
+    std::vector<Schedule> schedules(user_count);
+    std::vector<RecommendationEngine::BatchUser> batch;
+    users.reserve(user_count);
+    for (size_t u = 0; u < user_count; ++u) {
+        users.emplace_back("user " + std::to_string(u), "");
+        auto& preferences = users.back().getPreferences();
+        for (int n = 1 + static_cast<int>(rng() % 5); n > 0; --n) {
+            preferences.addInterest(tag(static_cast<int>(rng() % 16)), static_cast<int>(rng() % 6));
+        }
+        preferences.addPreferredTimeSlot(static_cast<int>(rng() % 12), 23, 0x7f);
+        if (u % 3 != 0) {
+            preferences.setCoordinates({37.0 + (rng() % 2000) / 1000.0, -123.0 + (rng() % 2000) / 1000.0});
+            preferences.setMaxTravelDistance(20.0 + rng() % 100);
+        }
+        for (int n = static_cast<int>(rng() % 3); n > 0; --n) {
+            auto busy = events[rng() % events.size()].getStartTime();
+            schedules[u].addEvent(Event("busy", "", busy, busy + std::chrono::hours(1), "", {}));
+        }
+        batch.push_back({&users.back().getPreferences(), &schedules[u]});
+    }
+
+    for (int k : {1, 25}) {
+        std::vector<Ranking> expected;
+        for (size_t u = 0; u < user_count; ++u) {
+            expected.push_back(ranking(engine.recommendEvents(users[u], store, schedules[u], k)));
+            ASSERT_FALSE(expected.back().empty()) << u;
+        }
+        for (size_t threads : {1u, 4u}) {
+            engine.setThreadCount(threads);
+            auto results = engine.recommendEventsForUsers(batch, store, k);
+            ASSERT_EQ(results.size(), user_count);
+            for (size_t u = 0; u < user_count; ++u) {
+                EXPECT_EQ(ranking(results[u]), expected[u]) << "k=" << k << " threads=" << threads << " user " << u;
+            }
+        }
+    }
+}
+
+TEST_F(RecommendationEngineTest, PromptKeepsTheBestCandidatesWithinTheBudget) {
+    fillCatalog(500, 40);
+    setPreferences();
+    // Descriptions of very different lengths, so a later candidate can be cheaper than an earlier one
+    for (auto& event : events) {
+        std::string description;
+        for (int words = static_cast<int>(rng() % 40); words > 0; --words) {
+            description += "lorem ";
+        }
+        event.setDescription(description);
+    }
+    auto service = std::make_shared<PromptRecordingService>();
+    RecommendationEngine recording(service);
+    const int k = 100;
+
+    // With room for everything, every candidate is listed in rank order
+    recording.setPromptTokenBudget(1000000);
+    auto recommendations = recording.recommendEvents(user, events, schedule, k);
+    ASSERT_EQ(recommendations.size(), static_cast<size_t>(k));
+    auto candidates = lines(service->events_text);
+    ASSERT_EQ(candidates.size(), static_cast<size_t>(k));
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        EXPECT_EQ(candidates[i].rfind(std::to_string(i + 1) + ". " + recommendations[i].event.getName() + " | ", 0), 0u);
+    }
+
+    size_t fixed = RecommendationEngine::estimateTokens(AIService::buildRecommendationPrompt(service->preferences_text, ""));
+    std::vector<size_t> prefix_tokens = {fixed};
+    for (const auto& line : candidates) {
+        prefix_tokens.push_back(prefix_tokens.back() + RecommendationEngine::estimateTokens(line));
+    }
+
+    // Zero, below the fixed sections, and on and just below every line boundary
+    std::vector<size_t> budgets = {0, 1, fixed - 1};
+    for (size_t tokens : prefix_tokens) {
+        budgets.push_back(tokens - 1);
+        budgets.push_back(tokens);
+    }
+    for (size_t budget : budgets) {
+        size_t listed = 0;
+        while (listed < candidates.size() && prefix_tokens[listed + 1] <= budget) {
+            listed++;
+        }
+        recording.setPromptTokenBudget(budget);
+        auto limited = recording.recommendEvents(user, events, schedule, k);
+        ASSERT_EQ(ranking(limited), ranking(recommendations)) << budget;
+        EXPECT_EQ(recording.getLastAIError(), "recorded");
+
+        // Truncation drops the tail of the ranking, never a better candidate
+        std::string expected;
+        for (size_t i = 0; i < listed; ++i) {
+            expected += candidates[i];
+        }
+        ASSERT_EQ(service->events_text, expected) << budget;
+        EXPECT_EQ(recording.getLastPromptTokenEstimate(), prefix_tokens[listed]) << budget;
+        if (budget >= fixed) {
+            EXPECT_LE(recording.getLastPromptTokenEstimate(), budget);
+        }
+    }
+}
+
+TEST(RecommendationEngineTokenTest, EstimateCountsWordsByLengthAndSymbolsSingly) {
+    EXPECT_EQ(RecommendationEngine::estimateTokens(""), 0u);
+    EXPECT_EQ(RecommendationEngine::estimateTokens(" \n\t "), 0u);
+    EXPECT_EQ(RecommendationEngine::estimateTokens("jazz"), 1u);
+    EXPECT_EQ(RecommendationEngine::estimateTokens("music"), 2u);
+    EXPECT_EQ(RecommendationEngine::estimateTokens("live music"), 3u);
+    EXPECT_EQ(RecommendationEngine::estimateTokens("2024-05-01"), 10u);
+    EXPECT_EQ(RecommendationEngine::estimateTokens("1. jazz | rock,folk"), 7u);
+    // Multibyte characters count toward the word they are in
+    EXPECT_EQ(RecommendationEngine::estimateTokens("caf\xc3\xa9"), 2u);
+}
\ No newline at end of file
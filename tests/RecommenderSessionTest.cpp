@@ -0,0 +1,135 @@
+#include "RecommenderSession.h"
+#include "User.h"
+#include "NullAIService.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    class RecommenderSessionTest : public ::testing::Test {
+    protected:
+        std::mt19937 rng{17};
+        EventStore store;
+        Schedule schedule;
+        User user{"Test User", "test@example.com"};
+        RecommendationEngine engine{std::make_shared<NullAIService>()};
+        size_t next_event = 0;
+
+        std::string tag(int i) {
+            return "session-test-tag-" + std::to_string(i);
+        }
+
+        Event randomEvent() {
+            auto start = std::chrono::system_clock::time_point() + std::chrono::hours(24 * 365 * 56) +
+                         std::chrono::minutes(rng() % (60 * 24 * 60));
+            std::vector<std::string> tags;
+            for (int t = static_cast<int>(rng() % 4); t > 0; --t) {
+                tags.push_back(tag(static_cast<int>(rng() % 12)));
+            }
+            Event event("event " + std::to_string(next_event++), "", start, start + std::chrono::hours(2),
+                        rng() % 3 == 0 ? "" : "venue", tags);
+            if (rng() % 3 != 0) {
+                event.setCoordinates({37.0 + (rng() % 2000) / 1000.0, -123.0 + (rng() % 2000) / 1000.0});
+            }
+            return event;
+        }
+
+        void SetUp() override {
+            for (int i = 0; i < 600; ++i) {
+                store.addEvent(randomEvent());
+            }
+            auto& preferences = user.getPreferences();
+            for (int i = 0; i < 12; i += 2) {
+                preferences.addInterest(tag(i), 1 + static_cast<int>(rng() % 5));
+            }
+            preferences.addPreferredTimeSlot(18, 23, 0x7f);
+            preferences.setLocation("home");
+            preferences.setCoordinates({37.77, -122.42});
+            preferences.setMaxTravelDistance(60.0);
+        }
+
+        void expectMatchesFreshRanking(const RecommenderSession& session, int k, const std::string& step) {
+            auto expected = engine.recommendEvents(user, store, schedule, k);
+            auto actual = session.getRecommendations();
+            ASSERT_EQ(actual.size(), expected.size()) << step;
+            for (size_t i = 0; i < actual.size(); ++i) {
+                EXPECT_EQ(actual[i].event.getName(), expected[i].event.getName()) << step << " rank " << i;
+                EXPECT_EQ(actual[i].score, expected[i].score) << step << " rank " << i;
+            }
+        }
+
+        EventStore::EventId randomActiveEvent() {
+            EventStore::EventId id;
+            do {
+                id = static_cast<EventStore::EventId>(rng() % store.size());
+            } while (!store.isActive(id));
+            return id;
+        }
+    };
+}
+
+TEST_F(RecommenderSessionTest, IncrementalChangesMatchFreshRanking) {
+    const int k = 5;
+    // A small reserve so removals and lowered weights keep draining it
+    RecommenderSession session(store, user.getPreferences(), schedule, k, 3);
+    expectMatchesFreshRanking(session, k, "initial");
+
+    for (int step = 0; step < 300; ++step) {
+        std::string name = "step " + std::to_string(step);
+        switch (rng() % 6) {
+        case 0:
+            session.addEvent(randomEvent());
+            break;
+        case 1:
+        case 2: {
+            // Mostly the current favourites, which is what forces rescans
+            auto top = session.getRecommendations();
+            EventStore::EventId id = randomActiveEvent();
+            if (!top.empty() && rng() % 2 == 0) {
+                for (EventStore::EventId candidate = 0; candidate < store.size(); ++candidate) {
+                    if (store.isActive(candidate) && store.getName(candidate) == top.front().event.getName()) {
+                        id = candidate;
+                    }
+                }
+            }
+            EXPECT_TRUE(session.removeEvent(id));
+            EXPECT_FALSE(session.removeEvent(id));
+            break;
+        }
+        case 3:
+            session.setInterestWeight(tag(static_cast<int>(rng() % 12)), static_cast<int>(rng() % 6));
+            break;
+        case 4:
+            if (rng() % 2 == 0) {
+                session.removeInterest(tag(static_cast<int>(rng() % 12)));
+            } else {
+                session.addInterest(tag(static_cast<int>(rng() % 12)), 1 + static_cast<int>(rng() % 5));
+            }
+            break;
+        default:
+            session.recordAttendance({store.materialize(randomActiveEvent())});
+            break;
+        }
+        expectMatchesFreshRanking(session, k, name);
+    }
+    EXPECT_GT(session.getStats().rescans, 1u);
+}
+
+TEST_F(RecommenderSessionTest, ScheduleConflictsBeyondTheReserveFallBackToAFullPass) {
+    const int k = 4;
+    RecommenderSession session(store, user.getPreferences(), schedule, k, 2);
+    auto before = session.getRecommendations();
+    ASSERT_EQ(before.size(), static_cast<size_t>(k));
+
+    // Block every held event and then some
+    for (const auto& recommendation : before) {
+        schedule.addEvent(recommendation.event);
+    }
+    for (int i = 0; i < 3; ++i) {
+        for (const auto& recommendation : engine.recommendEvents(user, store, schedule, k)) {
+            schedule.addEvent(recommendation.event);
+        }
+    }
+    expectMatchesFreshRanking(session, k, "after scheduling");
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include "ResponseCache.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace {
+    class ResponseCacheTest : public ::testing::Test {
+    protected:
+        std::filesystem::path directory;
+
+        void SetUp() override {
+            directory = std::filesystem::temp_directory_path() /
+                        ("masterbot_cache_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) +
+                         "_" + ::testing::UnitTest::GetInstance()->current_test_info()->name());
+            std::filesystem::remove_all(directory);
+        }
+
+        void TearDown() override {
+            std::filesystem::remove_all(directory);
+        }
+
+        ResponseCache::Options options(size_t max_bytes) const {
+            ResponseCache::Options result;
+            result.directory = directory.string();
+            result.max_bytes = max_bytes;
+            return result;
+        }
+
+        std::set<std::string> filesOnDisk(const std::string& extension) const {
+            std::set<std::string> keys;
+            for (const auto& file : std::filesystem::directory_iterator(directory)) {
+                if (file.path().extension() == extension) {
+                    keys.insert(file.path().stem().string());
+                }
+            }
+            return keys;
+        }
+    };
+}
+
+TEST_F(ResponseCacheTest, ReloadsEntriesFromDisk) {
+    {
+        ResponseCache cache(options(1024 * 1024));
+        cache.store("claude", "model", "hello   world", "answer");
+    }
+
+    ResponseCache cache(options(1024 * 1024));
+    std::string content;
+    ASSERT_TRUE(cache.lookup("claude", "model", "hello world", content));
+    EXPECT_EQ(content, "answer");
+    EXPECT_EQ(cache.getStats().disk_hits, 1u);
+}
+
+TEST_F(ResponseCacheTest, RemovesInterruptedWritesOnStartup) {
+    std::filesystem::create_directories(directory);
+    std::ofstream(directory / "0123456789abcdef0123456789abcdef.7.tmp") << "{\"key\":";
+
+    ResponseCache cache(options(1024 * 1024));
+    EXPECT_TRUE(filesOnDisk(".tmp").empty());
+    EXPECT_EQ(cache.getStats().disk_entries, 0u);
+}
+
+TEST_F(ResponseCacheTest, ConcurrentStoresKeepIndexAndFilesInSync) {
+    // Small enough that stores keep evicting each other while they write
+    ResponseCache cache(options(2000));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&cache, t]() {
+            for (int i = 0; i < 500; ++i) {
+                std::string prompt = "prompt " + std::to_string(i % 12);
+                cache.store("claude", "model", prompt, std::string(100 + t * 10, 'a' + t));
+                std::string content;
+                cache.lookup("claude", "model", prompt, content);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto stats = cache.getStats();
+    auto files = filesOnDisk(".json");
+    EXPECT_TRUE(filesOnDisk(".tmp").empty());
+    EXPECT_EQ(files.size(), stats.disk_entries);
+    EXPECT_LE(stats.disk_bytes, 2000u);
+
+    size_t bytes = 0;
+    for (const auto& key : files) {
+        bytes += std::filesystem::file_size(directory / (key + ".json"));
+    }
+    EXPECT_EQ(bytes, stats.disk_bytes);
+
+    // A fresh index over the same directory sees the same entries
+    ResponseCache reloaded(options(2000));
+    EXPECT_EQ(reloaded.getStats().disk_entries, stats.disk_entries);
+    EXPECT_EQ(reloaded.getStats().disk_bytes, stats.disk_bytes);
+}
\ No newline at end of file
@@ -0,0 +1,136 @@
+#include "RoutingService.h"
+#include <gtest/gtest.h>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+namespace {
+    // Answers inline with a fixed response, or holds requests until the test completes them
+    class ScriptedService : public AIService {
+    public:
+        enum class Mode { SUCCEED, FAIL, HOLD };
+
+        ScriptedService(std::string name, Mode mode) : AIService(""), name_(std::move(name)), mode_(mode) {}
+
+        std::future<AIResponse> generateResponse(const std::string& prompt) override {
+            return toFuture([this, prompt](ResponseCallback on_complete) {
+                generateResponse(prompt, std::move(on_complete), nullptr);
+            });
+        }
+
+        void generateResponse(const std::string&, ResponseCallback on_complete, CancelFlag) override {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                calls_++;
+                if (mode_ == Mode::HOLD) {
+                    held_.push_back(std::move(on_complete));
+                }
+            }
+            called_.notify_all();
+            if (mode_ != Mode::HOLD) {
+                on_complete({mode_ == Mode::SUCCEED, name_, mode_ == Mode::SUCCEED ? "" : name_ + " failed"});
+            }
+        }
+
+        std::future<AIResponse> analyzePreferences(const std::string& data) override { return generateResponse(data); }
+        std::future<AIResponse> recommendEvents(const std::string& preferences, const std::string&) override {
+            return generateResponse(preferences);
+        }
+        void streamResponse(const std::string&, DeltaCallback, ResponseCallback) override {}
+        std::string getProviderName() const override { return name_; }
+        std::string getModelName() const override { return name_; }
+        void cancel(const CancelFlag& flag) override {
+            if (flag) {
+                *flag = true;
+            }
+        }
+
+        void waitForCalls(size_t count) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            ASSERT_TRUE(called_.wait_for(lock, std::chrono::seconds(10), [&] { return calls_ >= count; }));
+        }
+
+        // Completes the oldest held request
+        void complete(bool success) {
+            ResponseCallback on_complete;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ASSERT_FALSE(held_.empty());
+                on_complete = std::move(held_.front());
+                held_.erase(held_.begin());
+            }
+            on_complete({success, name_, success ? "" : name_ + " failed"});
+        }
+
+    private:
+        std::string name_;
+        Mode mode_;
+        std::mutex mutex_;
+        std::condition_variable called_;
+        size_t calls_ = 0;
+        std::vector<ResponseCallback> held_;
+    };
+
+    RoutingService::Options quickHedge() {
+        RoutingService::Options options;
+        options.initial_hedge_delay = std::chrono::milliseconds(20);
+        return options;
+    }
+}
+
+TEST(RoutingServiceTest, FailoverAfterAHedgeIsNotAHedgeWin) {
+    auto primary = std::make_shared<ScriptedService>("primary", ScriptedService::Mode::HOLD);
+    auto hedge = std::make_shared<ScriptedService>("hedge", ScriptedService::Mode::FAIL);
+    auto failover = std::make_shared<ScriptedService>("failover", ScriptedService::Mode::SUCCEED);
+    RoutingService router({primary, hedge, failover}, quickHedge());
+
+    auto response = router.generateResponse("prompt");
+    // The hedge fails while the primary is still out; the primary's failure then
+    // moves the request on to the third provider
+    hedge->waitForCalls(1);
+    primary->complete(false);
+
+    auto result = response.get();
+    EXPECT_TRUE(result.success);
+    EXPECT_EQ(result.content, "failover");
+    auto stats = router.getStats();
+    EXPECT_EQ(stats.hedged, 1u);
+    EXPECT_EQ(stats.failovers, 1u);
+    EXPECT_EQ(stats.hedge_wins, 0u);
+}
+
+TEST(RoutingServiceTest, HedgeThatAnswersFirstIsAHedgeWin) {
+    auto primary = std::make_shared<ScriptedService>("primary", ScriptedService::Mode::HOLD);
+    auto hedge = std::make_shared<ScriptedService>("hedge", ScriptedService::Mode::SUCCEED);
+    RoutingService router({primary, hedge}, quickHedge());
+
+    auto result = router.generateResponse("prompt").get();
+    EXPECT_EQ(result.content, "hedge");
+    // The primary's late answer changes nothing
+    primary->complete(true);
+
+    auto stats = router.getStats();
+    EXPECT_EQ(stats.hedged, 1u);
+    EXPECT_EQ(stats.hedge_wins, 1u);
+    EXPECT_EQ(stats.failovers, 0u);
+}
+
+TEST(RoutingServiceTest, RouterCanBeReleasedFromItsOwnTimerThread) {
+    auto primary = std::make_shared<ScriptedService>("primary", ScriptedService::Mode::HOLD);
+    auto hedge = std::make_shared<ScriptedService>("hedge", ScriptedService::Mode::SUCCEED);
+    auto router = std::make_shared<RoutingService>(std::vector<std::shared_ptr<AIService>>{primary, hedge},
+                                                   quickHedge());
+
+    // The hedge answers inline on the timer thread, and its callback drops the last
+    // reference to the router there
+    std::promise<std::string> released;
+    router->generateResponse("prompt", [&router, &released](AIService::AIResponse response) {
+        router.reset();
+        released.set_value(response.content);
+    });
+    auto content = released.get_future();
+    ASSERT_EQ(content.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+    EXPECT_EQ(content.get(), "hedge");
+    EXPECT_EQ(router, nullptr);
+    primary->complete(false);
+}
\ No newline at end of file
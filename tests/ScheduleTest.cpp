@@ -0,0 +1,214 @@
+#include "Schedule.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+    using TimePoint = std::chrono::system_clock::time_point;
+
+    TimePoint at(int minutes) {
+        return TimePoint() + std::chrono::minutes(minutes);
+    }
+
+    std::vector<Event> randomEvents(std::mt19937& rng, size_t count) {
+        std::uniform_int_distribution<int> start(0, 10000);
+        std::uniform_int_distribution<int> length(0, 300);
+        std::vector<Event> events;
+        for (size_t i = 0; i < count; ++i) {
+            int begin = start(rng);
+            events.emplace_back("event " + std::to_string(i), "", at(begin), at(begin + length(rng)));
+        }
+        return events;
+    }
+
+    // The predicate Schedule answered with a scan over every event before it was indexed
+    bool linearConflict(const std::vector<Event>& scheduled, const Event& event) {
+        for (const auto& existing : scheduled) {
+            if (event.getStartTime() < existing.getEndTime() &&
+                event.getEndTime() > existing.getStartTime()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Scheduled events lying entirely within [start, end], in schedule order
+    std::vector<const Event*> linearRange(const Schedule& schedule, TimePoint start, TimePoint end) {
+        std::vector<const Event*> result;
+        for (const auto& event : schedule.getEvents()) {
+            if (event.getStartTime() >= start && event.getEndTime() <= end) {
+                result.push_back(&event);
+            }
+        }
+        return result;
+    }
+
+    void expectRangeMatchesLinearScan(const Schedule& schedule, TimePoint start, TimePoint end) {
+        auto expected = linearRange(schedule, start, end);
+        auto view = schedule.viewEventsInRange(start, end);
+        std::vector<const Event*> viewed;
+        for (const Event& event : view) {
+            viewed.push_back(&event);
+        }
+        // The view refers to the scheduled events themselves
+        EXPECT_EQ(viewed, expected);
+        EXPECT_EQ(view.size(), expected.size());
+        EXPECT_EQ(view.empty(), expected.empty());
+
+        auto copied = schedule.getEventsInRange(start, end);
+        ASSERT_EQ(copied.size(), expected.size());
+        for (size_t i = 0; i < copied.size(); ++i) {
+            EXPECT_EQ(copied[i].getName(), expected[i]->getName());
+            EXPECT_EQ(copied[i].getStartTime(), expected[i]->getStartTime());
+        }
+    }
+}
+
+TEST(ScheduleTest, ConflictsMatchLinearScan) {
+    std::mt19937 rng(7);
+    for (size_t size : {0u, 1u, 2u, 10u, 200u}) {
+        std::vector<Event> scheduled = randomEvents(rng, size);
+        Schedule schedule;
+        for (const auto& event : scheduled) {
+            schedule.addEvent(event);
+        }
+
+        std::vector<Event> queries = randomEvents(rng, 500);
+        for (const auto& query : queries) {
+            EXPECT_EQ(schedule.hasConflict(query), linearConflict(scheduled, query));
+        }
+    }
+}
+
+TEST(ScheduleTest, BatchConflictsMatchSingleQueries) {
+    std::mt19937 rng(11);
+    std::vector<Event> scheduled = randomEvents(rng, 300);
+    Schedule schedule;
+    schedule.addEvents(scheduled);
+
+    std::vector<Event> queries = randomEvents(rng, 1000);
+    std::vector<bool> expected;
+    for (const auto& query : queries) {
+        expected.push_back(linearConflict(scheduled, query));
+    }
+    EXPECT_EQ(schedule.conflictsFor(queries), expected);
+
+    // Sorted by end time, the whole batch is one forward pass
+    std::sort(queries.begin(), queries.end(),
+              [](const Event& a, const Event& b) { return a.getEndTime() < b.getEndTime(); });
+    std::vector<bool> sorted_expected;
+    for (const auto& query : queries) {
+        sorted_expected.push_back(linearConflict(scheduled, query));
+    }
+    std::vector<bool> sorted_actual;
+    schedule.conflictsFor(queries.begin(), queries.end(), std::back_inserter(sorted_actual));
+    EXPECT_EQ(sorted_actual, sorted_expected);
+}
+
+TEST(ScheduleTest, TouchingEventsDoNotConflict) {
+    Schedule schedule;
+    schedule.addEvent(Event("a", "", at(60), at(120)));
+    EXPECT_FALSE(schedule.hasConflict(at(0), at(60)));
+    EXPECT_FALSE(schedule.hasConflict(at(120), at(180)));
+    EXPECT_TRUE(schedule.hasConflict(at(119), at(180)));
+    EXPECT_TRUE(schedule.hasConflict(at(0), at(61)));
+}
+
+TEST(ScheduleTest, InsertsAndRemovalsKeepEventsSortedAndIndexed) {
+    std::mt19937 rng(3);
+    std::vector<Event> reference = randomEvents(rng, 300);
+    for (size_t i = 0; i < reference.size(); i += 7) {
+        reference[i].setName("repeated");
+    }
+
+    Schedule schedule;
+    std::vector<Event> bulk(reference.begin() + 100, reference.end());
+    for (size_t i = 0; i < 100; ++i) {
+        schedule.addEvent(reference[i]);
+    }
+    schedule.addEvents(bulk);
+
+    auto expect_matches = [&schedule](const std::vector<Event>& expected) {
+        const auto& events = schedule.getEvents();
+        ASSERT_EQ(events.size(), expected.size());
+        EXPECT_TRUE(std::is_sorted(events.begin(), events.end(), [](const Event& a, const Event& b) {
+            return a.getStartTime() < b.getStartTime();
+        }));
+        std::vector<Event::Id> actual_ids, expected_ids;
+        for (const auto& event : events) {
+            actual_ids.push_back(event.getId());
+        }
+        for (const auto& event : expected) {
+            expected_ids.push_back(event.getId());
+        }
+        std::sort(actual_ids.begin(), actual_ids.end());
+        std::sort(expected_ids.begin(), expected_ids.end());
+        EXPECT_EQ(actual_ids, expected_ids);
+
+        std::mt19937 query_rng(5);
+        for (const auto& query : randomEvents(query_rng, 300)) {
+            EXPECT_EQ(schedule.hasConflict(query), linearConflict(expected, query));
+        }
+    };
+    expect_matches(reference);
+
+    schedule.removeEvent("repeated");
+    reference.erase(std::remove_if(reference.begin(), reference.end(),
+                                   [](const Event& e) { return e.getName() == "repeated"; }),
+                    reference.end());
+    expect_matches(reference);
+
+    for (size_t i = 0; i < reference.size(); i += 3) {
+        EXPECT_TRUE(schedule.removeEventById(reference[i].getId()));
+        EXPECT_FALSE(schedule.removeEventById(reference[i].getId()));
+    }
+    std::vector<Event> remaining;
+    for (size_t i = 0; i < reference.size(); ++i) {
+        if (i % 3 != 0) {
+            remaining.push_back(reference[i]);
+        }
+    }
+    expect_matches(remaining);
+
+    schedule.removeEvent(remaining.front().getName());
+    remaining.erase(remaining.begin());
+    expect_matches(remaining);
+}
+
+TEST(ScheduleTest, RangeViewMatchesLinearScan) {
+    Schedule empty;
+    expectRangeMatchesLinearScan(empty, at(0), at(100));
+
+    std::mt19937 rng(5);
+    std::vector<Event> scheduled = randomEvents(rng, 200);
+    // Zero-length events, and several sharing a start time
+    scheduled.emplace_back("instant", "", at(500), at(500));
+    scheduled.emplace_back("same start a", "", at(700), at(760));
+    scheduled.emplace_back("same start b", "", at(700), at(701));
+    Schedule schedule;
+    schedule.addEvents(scheduled);
+
+    // Empty and inverted ranges, all of time, and ranges before and after every event
+    expectRangeMatchesLinearScan(schedule, at(500), at(500));
+    expectRangeMatchesLinearScan(schedule, at(600), at(400));
+    expectRangeMatchesLinearScan(schedule, at(-1), at(20000));
+    expectRangeMatchesLinearScan(schedule, TimePoint::min(), TimePoint::max());
+    expectRangeMatchesLinearScan(schedule, at(-100), at(-1));
+    expectRangeMatchesLinearScan(schedule, at(10400), at(10500));
+    EXPECT_EQ(schedule.viewEventsInRange(at(-1), at(20000)).size(), scheduled.size());
+
+    // Bounds on, and one minute either side of, event starts and ends
+    for (size_t i = 0; i < scheduled.size(); i += 5) {
+        for (int nudge : {-1, 0, 1}) {
+            auto start = scheduled[i].getStartTime() + std::chrono::minutes(nudge);
+            auto end = scheduled[(i * 7) % scheduled.size()].getEndTime() + std::chrono::minutes(nudge);
+            expectRangeMatchesLinearScan(schedule, start, end);
+            expectRangeMatchesLinearScan(schedule, start, scheduled[i].getEndTime());
+        }
+    }
+    for (int i = 0; i < 300; ++i) {
+        auto start = at(static_cast<int>(rng() % 10400));
+        expectRangeMatchesLinearScan(schedule, start, start + std::chrono::minutes(rng() % 2000));
+    }
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#include "SseParser.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+    using Events = std::vector<std::pair<std::string, std::string>>;
+
+    // Feeds the stream in chunks of the given sizes, repeating the last one
+    Events parse(const std::string& stream, std::vector<size_t> chunk_sizes) {
+        Events events;
+        SseParser parser([&events](const std::string& event, const std::string& data) {
+            events.emplace_back(event, data);
+        });
+        size_t offset = 0;
+        for (size_t i = 0; offset < stream.size(); ++i) {
+            size_t size = std::min(chunk_sizes[std::min(i, chunk_sizes.size() - 1)], stream.size() - offset);
+            parser.feed(stream.data() + offset, size);
+            offset += size;
+        }
+        parser.finish();
+        return events;
+    }
+}
+
+TEST(SseParserTest, ParsesEventsAndMultiLineData) {
+    Events events = parse("event: delta\ndata: one\ndata: two\n\n: comment\ndata:three\n\n", {1024});
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0], std::make_pair(std::string("delta"), std::string("one\ntwo")));
+    EXPECT_EQ(events[1], std::make_pair(std::string("message"), std::string("three")));
+}
+
+TEST(SseParserTest, CrLfSplitAcrossChunksEndsOneLine) {
+    std::string stream = "event: a\r\ndata: x\r\n\r\nevent: b\r\ndata: y\r\n\r\n";
+    Events whole = parse(stream, {stream.size()});
+    ASSERT_EQ(whole.size(), 2u);
+
+    // Every split point, including between each CR and its LF
+    for (size_t split = 1; split < stream.size(); ++split) {
+        EXPECT_EQ(parse(stream, {split, stream.size()}), whole) << "split at " << split;
+    }
+    EXPECT_EQ(parse(stream, {1}), whole);
+}
+
+TEST(SseParserTest, AcceptsBareCrAndLfLineEndings) {
+    Events expected = {{"a", "x"}, {"b", "y"}};
+    EXPECT_EQ(parse("event: a\rdata: x\r\revent: b\rdata: y\r\r", {1}), expected);
+    EXPECT_EQ(parse("event: a\ndata: x\n\nevent: b\ndata: y\n\n", {3}), expected);
+    // A lone CR followed by an LF in the next chunk is still a single line break
+    EXPECT_EQ(parse("event: a\r\ndata: x\r\n\r\n", {9, 1}), (Events{{"a", "x"}}));
+}
+
+TEST(SseParserTest, FinishDiscardsUnterminatedEvent) {
+    EXPECT_TRUE(parse("data: tail", {4}).empty());
+    EXPECT_TRUE(parse("data: tail\n", {1024}).empty());
+    EXPECT_EQ(parse("data: one\n\ndata: cut off\r\n", {5}), (Events{{"message", "one"}}));
+    EXPECT_EQ(parse("data: tail\n\n", {4}), (Events{{"message", "tail"}}));
+    EXPECT_TRUE(parse("event: only\n\n", {1024}).empty());
+
+    // Nothing from the discarded event leaks into a stream fed afterwards
+    Events events;
+    SseParser parser([&events](const std::string& event, const std::string& data) {
+        events.emplace_back(event, data);
+    });
+    std::string cut = "event: lost\ndata: partial\r";
+    parser.feed(cut.data(), cut.size());
+    parser.finish();
+    std::string next = "\ndata: fresh\n\n";
+    parser.feed(next.data(), next.size());
+    EXPECT_EQ(events, (Events{{"message", "fresh"}}));
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#include "ThreadPool.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST(ThreadPoolTest, ParallelForCoversEveryIndexOnce) {
+    ThreadPool pool(4);
+    for (size_t grain : {1u, 7u, 1000u, 5000u}) {
+        std::vector<std::atomic<int>> seen(4321);
+        pool.parallelFor(seen.size(), grain, [&](size_t worker, size_t begin, size_t end) {
+            ASSERT_LT(worker, pool.getThreadCount());
+            ASSERT_LE(end - begin, grain);
+            for (size_t i = begin; i < end; ++i) {
+                seen[i]++;
+            }
+        });
+        for (const auto& count : seen) {
+            ASSERT_EQ(count, 1);
+        }
+    }
+}
+
+TEST(ThreadPoolTest, ParallelForRethrowsChunkErrors) {
+    ThreadPool pool(3);
+    EXPECT_THROW(pool.parallelFor(100, 10, [](size_t, size_t begin, size_t) {
+        if (begin == 50) {
+            throw std::runtime_error("chunk failed");
+        }
+    }), std::runtime_error);
+    // Still usable afterwards
+    std::atomic<size_t> total(0);
+    pool.parallelFor(100, 10, [&total](size_t, size_t begin, size_t end) { total += end - begin; });
+    EXPECT_EQ(total, 100u);
+}
+
+TEST(ThreadPoolTest, SubmitsFromManyThreadsAllRun) {
+    std::atomic<size_t> ran(0);
+    {
+        ThreadPool pool(4);
+        std::vector<std::thread> submitters;
+        for (int t = 0; t < 4; ++t) {
+            submitters.emplace_back([&pool, &ran]() {
+                for (int i = 0; i < 5000; ++i) {
+                    pool.submit([&ran](size_t) { ran++; });
+                }
+            });
+        }
+        for (auto& submitter : submitters) {
+            submitter.join();
+        }
+        // The destructor drains the queues
+    }
+    EXPECT_EQ(ran, 20000u);
+}
\ No newline at end of file
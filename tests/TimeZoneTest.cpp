@@ -0,0 +1,122 @@
+#include "TimeZone.h"
+#include "ConfigManager.h"
+#include "HourOfWeekMask.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+
+namespace {
+    std::int64_t utc(const std::string& text) {
+        std::int64_t seconds = 0;
+        EXPECT_TRUE(TimeZone::parseIso8601(text, seconds)) << text;
+        return seconds;
+    }
+
+    std::shared_ptr<const TimeZone> zone(const std::string& name) {
+        auto result = TimeZone::get(name);
+        EXPECT_NE(result, nullptr) << name;
+        return result;
+    }
+}
+
+TEST(TimeZoneTest, OffsetsAroundDaylightSavingChanges) {
+    auto new_york = zone("America/New_York");
+    ASSERT_NE(new_york, nullptr);
+    // Spring forward at 07:00 UTC, fall back at 06:00 UTC
+    EXPECT_EQ(new_york->getOffset(utc("2026-03-08T06:59:59Z")), -5 * 3600);
+    EXPECT_EQ(new_york->getOffset(utc("2026-03-08T07:00:00Z")), -4 * 3600);
+    EXPECT_EQ(new_york->getOffset(utc("2026-11-01T05:59:59Z")), -4 * 3600);
+    EXPECT_EQ(new_york->getOffset(utc("2026-11-01T06:00:00Z")), -5 * 3600);
+
+    auto london = zone("Europe/London");
+    ASSERT_NE(london, nullptr);
+    EXPECT_EQ(london->getOffset(utc("2026-03-29T00:59:59Z")), 0);
+    EXPECT_EQ(london->getOffset(utc("2026-03-29T01:00:00Z")), 3600);
+    EXPECT_EQ(london->getOffset(utc("2026-10-25T01:00:00Z")), 0);
+
+    // Half-hour shift
+    auto lord_howe = zone("Australia/Lord_Howe");
+    ASSERT_NE(lord_howe, nullptr);
+    EXPECT_EQ(lord_howe->getOffset(utc("2026-01-15T00:00:00Z")), 11 * 3600);
+    EXPECT_EQ(lord_howe->getOffset(utc("2026-07-15T00:00:00Z")), 10 * 3600 + 1800);
+
+    auto kolkata = zone("Asia/Kolkata");
+    ASSERT_NE(kolkata, nullptr);
+    EXPECT_EQ(kolkata->getOffset(utc("2026-06-01T12:00:00Z")), 5 * 3600 + 1800);
+}
+
+TEST(TimeZoneTest, PosixRuleCoversYearsPastTheTransitionTable) {
+    auto new_york = zone("America/New_York");
+    ASSERT_NE(new_york, nullptr);
+    EXPECT_EQ(new_york->getOffset(utc("2090-07-01T12:00:00Z")), -4 * 3600);
+    EXPECT_EQ(new_york->getOffset(utc("2090-12-01T12:00:00Z")), -5 * 3600);
+    // Second Sunday of March 2090 is the 12th
+    EXPECT_EQ(new_york->getOffset(utc("2090-03-12T06:59:59Z")), -5 * 3600);
+    EXPECT_EQ(new_york->getOffset(utc("2090-03-12T07:00:00Z")), -4 * 3600);
+}
+
+TEST(TimeZoneTest, CursorMatchesDirectLookup) {
+    std::mt19937_64 rng(9);
+    std::uniform_int_distribution<std::int64_t> instant(utc("1990-01-01T00:00Z"), utc("2095-01-01T00:00Z"));
+    for (const char* name : {"UTC", "America/Los_Angeles", "Europe/Berlin", "Australia/Lord_Howe"}) {
+        auto time_zone = zone(name);
+        ASSERT_NE(time_zone, nullptr);
+        TimeZone::Cursor cursor(*time_zone);
+
+        // Random jumps, then a sorted walk that stays within cached intervals
+        for (int i = 0; i < 2000; ++i) {
+            std::int64_t t = instant(rng);
+            ASSERT_EQ(cursor.getOffset(t), time_zone->getOffset(t)) << name << " " << t;
+        }
+        for (std::int64_t t = utc("2026-01-01T00:00Z"); t < utc("2027-01-01T00:00Z"); t += 1800) {
+            ASSERT_EQ(cursor.getOffset(t), time_zone->getOffset(t)) << name << " " << t;
+        }
+    }
+}
+
+TEST(TimeZoneTest, UtcAndUnknownZones) {
+    ASSERT_NE(TimeZone::utc(), nullptr);
+    EXPECT_EQ(TimeZone::utc()->getOffset(utc("2026-07-01T00:00Z")), 0);
+    EXPECT_EQ(TimeZone::get("Not/A_Zone"), nullptr);
+    EXPECT_EQ(TimeZone::get("../../etc/passwd"), nullptr);
+}
+
+TEST(TimeZoneTest, ParsesIso8601Offsets) {
+    EXPECT_EQ(utc("2026-07-01T12:00:00+02:00"), utc("2026-07-01T10:00:00Z"));
+    EXPECT_EQ(utc("2026-07-01T12:00-05:30"), utc("2026-07-01T17:30Z"));
+    EXPECT_EQ(utc("1970-01-01T00:00"), 0);
+    std::int64_t seconds = 0;
+    EXPECT_FALSE(TimeZone::parseIso8601("2026-13-01T00:00Z", seconds));
+    EXPECT_FALSE(TimeZone::parseIso8601("yesterday", seconds));
+}
+
+TEST(TimeZoneTest, HourOfWeekStartsOnMonday) {
+    // 2026-10-12 was a Monday
+    EXPECT_EQ(HourOfWeekMask::hourOfWeek(utc("2026-10-12T00:30Z")), 0u);
+    EXPECT_EQ(HourOfWeekMask::hourOfWeek(utc("2026-10-18T23:59Z")), 167u);
+    EXPECT_EQ(HourOfWeekMask::hourOfWeek(utc("1969-12-31T23:00Z")), 2u * 24 + 23);
+}
+
+TEST(TimeZoneTest, SlotWithNoRecognizedDaysIsAConfigError) {
+    EXPECT_EQ(HourOfWeekMask::parseDays({"Funday", "Someday"}), 0);
+    EXPECT_EQ(HourOfWeekMask::parseDays({"mon", "Sunday"}), 0x41);
+
+    // Defaults only; the file is never read
+    UserConfig config = *ConfigManager("unused.json").getSnapshot();
+    nlohmann::json j = ConfigManager::toJson(config);
+    j["preferences"]["preferred_time_slots"] = {{{"start_hour", 9}, {"end_hour", 17}, {"days", {"Mon"}}},
+                                                {{"start_hour", 18}, {"end_hour", 22}, {"days", {"Funday"}}}};
+    try {
+        ConfigManager::fromJson(j);
+        FAIL() << "expected a config error";
+    } catch (const std::runtime_error& e) {
+        EXPECT_NE(std::string(e.what()).find("preferences.preferred_time_slots[1].days"), std::string::npos)
+            << e.what();
+    }
+
+    config.preferred_time_slots = {{18, 22, {"Funday"}}};
+    auto errors = ConfigManager::getValidationErrors(config);
+    EXPECT_NE(std::find_if(errors.begin(), errors.end(), [](const std::string& error) {
+        return error.find("preferred_time_slots[0].days") != std::string::npos;
+    }), errors.end());
+}
\ No newline at end of file
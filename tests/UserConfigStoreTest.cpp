@@ -0,0 +1,247 @@
+#include "UserConfigStore.h"
+#include "TagInterner.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+    class UserConfigStoreTest : public ::testing::Test {
+    protected:
+        std::filesystem::path directory;
+        UserConfig defaults;
+
+        void SetUp() override {
+            directory = std::filesystem::temp_directory_path() /
+                        ("masterbot_users_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) +
+                         "_" + ::testing::UnitTest::GetInstance()->current_test_info()->name());
+            std::filesystem::remove_all(directory);
+            defaults = *ConfigManager("unused.json").getSnapshot();
+            defaults.openai_config.api_key = "test-key";
+        }
+
+        void TearDown() override {
+            std::filesystem::remove_all(directory);
+        }
+
+        UserConfigStore::Options options(size_t max_bytes, std::chrono::milliseconds flush_interval) const {
+            UserConfigStore::Options result;
+            result.directory = directory.string();
+            result.max_bytes = max_bytes;
+            result.shard_count = 4;
+            result.flush_interval = flush_interval;
+            return result;
+        }
+
+        UserConfig configFor(const std::string& name, int weight = 1) const {
+            UserConfig config = defaults;
+            config.name = name;
+            config.interests = {{"user-store-test-music", weight}, {"user-store-test-" + name, 2}};
+            return config;
+        }
+
+        void put(UserConfigStore& store, const std::string& user_id, const UserConfig& config) {
+            std::string error;
+            ASSERT_TRUE(store.put(user_id, config, error)) << error;
+        }
+
+        // Writes a config large enough that parsing it takes a while
+        void writeSlowConfig(const std::string& user_id, const std::string& name) {
+            UserConfig config = configFor(name);
+            for (int i = 0; i < 20000; ++i) {
+                config.interests["user-store-test-slow-" + std::to_string(i)] = 1 + i % 5;
+            }
+            UserConfigStore writer(options(1 << 30, std::chrono::milliseconds(0)));
+            put(writer, user_id, config);
+            ASSERT_EQ(writer.flush(), 1u);
+        }
+    };
+}
+
+TEST_F(UserConfigStoreTest, EvictsAtTheCapWithoutLosingDirtyConfigs) {
+    UserConfigStore::Options small = options(0, std::chrono::milliseconds(0));
+    {
+        UserConfigStore probe(options(1 << 20, std::chrono::milliseconds(0)));
+        put(probe, "probe", configFor("probe"));
+        // Room for about three entries per shard
+        small.max_bytes = probe.getStats().cached_bytes * 3 * small.shard_count;
+    }
+    std::filesystem::remove_all(directory);
+
+    UserConfigStore store(small);
+    for (int i = 0; i < 100; ++i) {
+        put(store, "user" + std::to_string(i), configFor("user" + std::to_string(i)));
+    }
+    auto stats = store.getStats();
+    EXPECT_GT(stats.evictions, 0u);
+    EXPECT_LT(stats.cached_entries, 100u);
+    EXPECT_LE(stats.cached_bytes, small.max_bytes);
+    EXPECT_EQ(stats.dirty_entries, 100u);
+
+    // Evicted before any flush, so it must come from the dirty map rather than disk
+    auto entry = store.get("user0");
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->config.name, "user0");
+    EXPECT_EQ(store.getStats().loads, 0u);
+
+    EXPECT_EQ(store.flush(), 100u);
+    EXPECT_EQ(store.getStats().dirty_entries, 0u);
+
+    // Now evicted entries are read back from their files
+    for (int i = 0; i < 100; ++i) {
+        entry = store.get("user" + std::to_string(i));
+        ASSERT_NE(entry, nullptr);
+        EXPECT_EQ(entry->config.name, "user" + std::to_string(i));
+        EXPECT_EQ(entry->preferences.getInterestWeight("user-store-test-music"), 1);
+    }
+    stats = store.getStats();
+    EXPECT_GT(stats.loads, 0u);
+    EXPECT_LE(stats.cached_bytes, small.max_bytes);
+}
+
+TEST_F(UserConfigStoreTest, DenseInterestWeightsCountTowardTheCap) {
+    UserConfigStore store(options(1 << 30, std::chrono::milliseconds(0)));
+    put(store, "before", configFor("before"));
+    size_t before = store.getStats().cached_bytes;
+
+    // Compiled weights are indexed by global tag id, so one interest in a late tag
+    // costs as much as every tag interned before it
+    for (int i = 0; i < 100000; ++i) {
+        TagInterner::global().intern("user-store-test-bulk-" + std::to_string(i));
+    }
+    put(store, "after", configFor("after"));
+    size_t after = store.getStats().cached_bytes - before;
+    EXPECT_GE(after, before + 100000 * (sizeof(int) + sizeof(std::uint8_t)));
+}
+
+TEST_F(UserConfigStoreTest, ConcurrentGetAndPut) {
+    const int threads = 8;
+    const int users = 40;
+    // Tight enough to keep evicting, and a background writer racing the threads
+    UserConfigStore::Options concurrent = options(16 * 1024, std::chrono::milliseconds(1));
+    std::vector<int> last_weight(users, 0);
+    {
+        UserConfigStore store(concurrent);
+        for (int u = 0; u < users; ++u) {
+            put(store, "user" + std::to_string(u), configFor("user" + std::to_string(u), 1));
+            last_weight[u] = 1;
+        }
+
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t]() {
+                std::mt19937 rng(static_cast<unsigned>(t));
+                for (int i = 0; i < 2000; ++i) {
+                    int u = static_cast<int>(rng() % users);
+                    std::string user_id = "user" + std::to_string(u);
+                    // Each user is only written by one thread, so its last weight is known
+                    if (u % threads == t && rng() % 4 == 0) {
+                        int weight = 1 + static_cast<int>(rng() % 10);
+                        std::string error;
+                        ASSERT_TRUE(store.put(user_id, configFor(user_id, weight), error)) << error;
+                        last_weight[u] = weight;
+                        continue;
+                    }
+                    auto entry = store.get(user_id);
+                    ASSERT_NE(entry, nullptr) << user_id;
+                    ASSERT_EQ(entry->config.name, user_id);
+                    // The compiled preferences always belong to the same config
+                    ASSERT_EQ(entry->preferences.getInterestWeight("user-store-test-music"),
+                              entry->config.interests.at("user-store-test-music"));
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        auto stats = store.getStats();
+        EXPECT_GT(stats.evictions, 0u);
+        EXPECT_EQ(stats.load_failures, 0u);
+        EXPECT_EQ(stats.write_failures, 0u);
+        for (int u = 0; u < users; ++u) {
+            auto entry = store.get("user" + std::to_string(u));
+            ASSERT_NE(entry, nullptr);
+            EXPECT_EQ(entry->config.interests.at("user-store-test-music"), last_weight[u]) << u;
+        }
+    }
+
+    // Destruction flushed everything; a fresh store reads the newest configs from disk
+    UserConfigStore reopened(options(1 << 20, std::chrono::milliseconds(0)));
+    for (int u = 0; u < users; ++u) {
+        auto entry = reopened.get("user" + std::to_string(u));
+        ASSERT_NE(entry, nullptr);
+        EXPECT_EQ(entry->config.interests.at("user-store-test-music"), last_weight[u]) << u;
+    }
+}
+
+TEST_F(UserConfigStoreTest, ConcurrentMissesShareOneParse) {
+    writeSlowConfig("crowd", "crowd");
+    UserConfigStore store(options(1 << 30, std::chrono::milliseconds(0)));
+
+    const int threads = 8;
+    std::atomic<int> ready(0);
+    std::vector<std::shared_ptr<const UserConfigStore::Entry>> entries(threads);
+    std::vector<std::string> errors(threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            ready++;
+            while (ready < threads) {
+            }
+            entries[t] = store.get("crowd");
+            store.get("nobody", errors[t]);
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    ASSERT_NE(entries[0], nullptr);
+    EXPECT_EQ(entries[0]->config.name, "crowd");
+    for (int t = 0; t < threads; ++t) {
+        EXPECT_EQ(entries[t], entries[0]);
+        EXPECT_EQ(errors[t], "No config for user: nobody");
+    }
+    auto stats = store.getStats();
+    EXPECT_EQ(stats.loads, 1u);
+    EXPECT_EQ(stats.hits, static_cast<size_t>(threads - 1));
+}
+
+TEST_F(UserConfigStoreTest, PutsDuringALoadOnlyAffectTheirOwnUser) {
+    writeSlowConfig("slow", "from file");
+    writeSlowConfig("replaced", "from file");
+    UserConfigStore::Options one_shard = options(1 << 30, std::chrono::milliseconds(0));
+    one_shard.shard_count = 1;
+    UserConfigStore store(one_shard);
+
+    // Puts for other users on the same shard do not make the load start over
+    std::atomic<bool> done(false);
+    std::shared_ptr<const UserConfigStore::Entry> slow;
+    std::thread loader([&]() {
+        slow = store.get("slow");
+        done = true;
+    });
+    // Bounded, so a load that keeps restarting fails the test instead of hanging it
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    for (int i = 0; !done && std::chrono::steady_clock::now() < deadline; ++i) {
+        put(store, "other" + std::to_string(i % 50), configFor("other"));
+    }
+    loader.join();
+    ASSERT_NE(slow, nullptr);
+    EXPECT_EQ(slow->config.name, "from file");
+    EXPECT_EQ(store.getStats().loads, 1u);
+
+    // A put for the user being loaded is not overwritten by the older file
+    std::thread stale_loader([&]() {
+        ASSERT_NE(store.get("replaced"), nullptr);
+    });
+    // Lands while the file is being parsed, unless the machine is very slow
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    put(store, "replaced", configFor("from put"));
+    stale_loader.join();
+    EXPECT_EQ(store.get("replaced")->config.name, "from put");
+}
\ No newline at end of file